@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and
+ * its documentation for any purpose is hereby granted without fee, provided
+ * that the above copyright notice appear in all copies and that both that
+ * copyright notice and this permission notice appear in supporting
+ * documentation, and that the name of the copyright holders not be used in
+ * advertising or publicity pertaining to distribution of the software
+ * without specific, written prior permission.  The copyright holders make
+ * no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS
+ * SOFTWARE, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS, IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER
+ * RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+ * CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+
+
+/*
+ * Test of the id cache of ivi-id-agent: assignments are found again after
+ * the file is reopened, and files of an other size, version or with broken
+ * entries are reset or cleaned up instead of being trusted.
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "ivi-id-cache.h"
+
+#define NUM_ENTRIES 8
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            fprintf(stderr, "%s:%d: %s failed\n", __FILE__, __LINE__, #cond); \
+            exit(EXIT_FAILURE); \
+        } \
+    } while (0)
+
+static char path[] = "/tmp/ivi-id-cache-test-XXXXXX";
+
+static void
+set_entry(struct id_cache *cache, const char *app_id, const char *title,
+          uint32_t surface_id)
+{
+    struct id_cache_entry *entry = id_cache_get_free(cache, app_id, title);
+
+    CHECK(entry != NULL);
+    id_cache_set(cache, entry, app_id, title, surface_id);
+}
+
+static void
+test_open(void)
+{
+    struct id_cache cache;
+
+    CHECK(id_cache_open(&cache, path, 0) < 0);
+    CHECK(id_cache_open(&cache, path, ID_CACHE_MAX_ENTRIES + 1) < 0);
+    CHECK(id_cache_open(&cache, "/nonexistent/id-cache", NUM_ENTRIES) < 0);
+
+    CHECK(id_cache_open(&cache, path, NUM_ENTRIES) == 0);
+    CHECK(cache.header->num_entries == NUM_ENTRIES);
+    CHECK(id_cache_find(&cache, "app", "title") == NULL);
+    id_cache_close(&cache);
+}
+
+static void
+test_find(void)
+{
+    struct id_cache cache;
+    struct id_cache_entry *entry;
+    char long_title[ID_CACHE_TITLE_SIZE + 1];
+    uint32_t i;
+
+    CHECK(id_cache_open(&cache, path, NUM_ENTRIES) == 0);
+
+    set_entry(&cache, "app", "title", 1000);
+    set_entry(&cache, "app", NULL, 1001);
+    set_entry(&cache, NULL, "title", 1002);
+
+    entry = id_cache_find(&cache, "app", "title");
+    CHECK(entry != NULL && entry->surface_id == 1000);
+    entry = id_cache_find(&cache, "app", "");
+    CHECK(entry != NULL && entry->surface_id == 1001);
+    entry = id_cache_find(&cache, NULL, "title");
+    CHECK(entry != NULL && entry->surface_id == 1002);
+    CHECK(id_cache_find(&cache, "app", "other") == NULL);
+    CHECK(id_cache_find_id(&cache, 1001) != NULL);
+
+    memset(long_title, 'x', sizeof long_title - 1);
+    long_title[sizeof long_title - 1] = '\0';
+    CHECK(id_cache_get_free(&cache, "app", long_title) == NULL);
+    CHECK(id_cache_find(&cache, "app", long_title) == NULL);
+
+    /* the least recently used entry is replaced, once the cache is full */
+    for (i = 3; i < NUM_ENTRIES; i++)
+        set_entry(&cache, "filler", "", 2000 + i);
+
+    id_cache_touch(&cache, id_cache_find(&cache, "app", "title"));
+    set_entry(&cache, "new", "", 3000);
+    CHECK(id_cache_find(&cache, "app", "") == NULL);
+    CHECK(id_cache_find(&cache, "app", "title") != NULL);
+    CHECK(id_cache_find(&cache, "new", "") != NULL);
+
+    id_cache_remove(&cache, id_cache_find(&cache, "new", ""));
+    CHECK(id_cache_find(&cache, "new", "") == NULL);
+
+    id_cache_close(&cache);
+}
+
+static void
+test_persist(void)
+{
+    struct id_cache cache;
+    struct id_cache_entry *entry;
+
+    CHECK(id_cache_open(&cache, path, NUM_ENTRIES) == 0);
+    entry = id_cache_find(&cache, "app", "title");
+    CHECK(entry != NULL && entry->surface_id == 1000);
+    CHECK(cache.header->clock >= entry->last_used);
+    id_cache_close(&cache);
+
+    /* an other size resets the cache */
+    CHECK(id_cache_open(&cache, path, NUM_ENTRIES * 2) == 0);
+    CHECK(id_cache_find(&cache, "app", "title") == NULL);
+    id_cache_close(&cache);
+}
+
+static void
+test_corrupt(void)
+{
+    struct id_cache cache;
+    struct id_cache_entry *entry;
+    int fd;
+
+    CHECK(id_cache_open(&cache, path, NUM_ENTRIES) == 0);
+    set_entry(&cache, "app", "title", 1000);
+    set_entry(&cache, "app", "other", 1001);
+    set_entry(&cache, "app", "hash", 1002);
+
+    /* strings without a terminating NUL in their field */
+    entry = id_cache_find(&cache, "app", "title");
+    memset(entry->app_id, 'a', ID_CACHE_APP_ID_SIZE);
+    entry = id_cache_find(&cache, "app", "other");
+    memset(entry->title, 't', ID_CACHE_TITLE_SIZE);
+    /* a hash, which does not match the strings */
+    entry = id_cache_find(&cache, "app", "hash");
+    entry->hash ^= 1;
+    cache.header->clock = 0;
+    id_cache_close(&cache);
+
+    CHECK(id_cache_open(&cache, path, NUM_ENTRIES) == 0);
+    CHECK(id_cache_find_id(&cache, 1000) == NULL);
+    CHECK(id_cache_find_id(&cache, 1001) == NULL);
+    CHECK(id_cache_find_id(&cache, 1002) == NULL);
+    set_entry(&cache, "app", "title", 1000);
+    CHECK(id_cache_find(&cache, "app", "title")->last_used > 0);
+    id_cache_close(&cache);
+
+    /* a truncated file */
+    fd = open(path, O_RDWR);
+    CHECK(fd >= 0);
+    CHECK(ftruncate(fd, 10) == 0);
+    close(fd);
+
+    CHECK(id_cache_open(&cache, path, NUM_ENTRIES) == 0);
+    CHECK(id_cache_find(&cache, "app", "title") == NULL);
+    set_entry(&cache, "app", "title", 1000);
+    id_cache_close(&cache);
+
+    /* a file of an other version */
+    CHECK(id_cache_open(&cache, path, NUM_ENTRIES) == 0);
+    cache.header->version++;
+    id_cache_close(&cache);
+
+    CHECK(id_cache_open(&cache, path, NUM_ENTRIES) == 0);
+    CHECK(id_cache_find(&cache, "app", "title") == NULL);
+    id_cache_close(&cache);
+}
+
+int
+main(void)
+{
+    int fd = mkstemp(path);
+
+    CHECK(fd >= 0);
+    close(fd);
+
+    test_open();
+    test_find();
+    test_persist();
+    test_corrupt();
+
+    unlink(path);
+    printf("id cache test passed\n");
+
+    return EXIT_SUCCESS;
+}
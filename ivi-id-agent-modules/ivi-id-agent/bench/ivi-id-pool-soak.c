@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and
+ * its documentation for any purpose is hereby granted without fee, provided
+ * that the above copyright notice appear in all copies and that both that
+ * copyright notice and this permission notice appear in supporting
+ * documentation, and that the name of the copyright holders not be used in
+ * advertising or publicity pertaining to distribution of the software
+ * without specific, written prior permission.  The copyright holders make
+ * no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS
+ * SOFTWARE, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS, IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER
+ * RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+ * CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+
+/*
+ * Soak test of the default surface id pool of ivi-id-agent: 1M surfaces
+ * are created and destroyed in random order, like apps restarting over a
+ * long runtime. Every created surface must get the lowest free id of the
+ * interval, and the interval must never run out while surfaces are freed.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "ivi-id-pool.h"
+
+#define FIRST_ID 2000000
+#define NUM_IDS 5000
+#define NUM_SURFACES 1000000
+
+static double
+now_usec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000.0 + ts.tv_nsec / 1000.0;
+}
+
+int
+main(void)
+{
+    static bool used[NUM_IDS];
+    static uint32_t live[NUM_IDS];
+    struct id_pool pool;
+    uint32_t num_live = 0, lowest_free = 0;
+    uint32_t created = 0, i, id;
+    double start;
+
+    id_pool_init(&pool, FIRST_ID, NUM_IDS);
+    srand(1);
+    start = now_usec();
+
+    while (created < NUM_SURFACES) {
+        /* fill up the interval from time to time, else keep it half full */
+        bool create = (num_live < NUM_IDS) &&
+                      ((created / 50000) % 2 ? (rand() % 8 != 0) :
+                                               (rand() % 2 == 0));
+
+        if (create) {
+            if (id_pool_alloc(&pool, &id) < 0) {
+                fprintf(stderr, "pool exhausted with %u surfaces\n", num_live);
+                return EXIT_FAILURE;
+            }
+
+            while (used[lowest_free])
+                lowest_free++;
+
+            if (id != FIRST_ID + lowest_free) {
+                fprintf(stderr, "got id %u instead of %u\n",
+                        id, FIRST_ID + lowest_free);
+                return EXIT_FAILURE;
+            }
+
+            used[lowest_free] = true;
+            live[num_live++] = id;
+            created++;
+        } else if (num_live > 0) {
+            i = rand() % num_live;
+            id = live[i];
+            live[i] = live[--num_live];
+
+            id_pool_free(&pool, id);
+            used[id - FIRST_ID] = false;
+            if (id - FIRST_ID < lowest_free)
+                lowest_free = id - FIRST_ID;
+        }
+
+        if (num_live == NUM_IDS && id_pool_alloc(&pool, &id) == 0) {
+            fprintf(stderr, "got id %u of a full interval\n", id);
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("surfaces: %u, ids: %u, live at end: %u, %.3f usec/surface\n",
+           created, NUM_IDS, num_live, (now_usec() - start) / created);
+
+    id_pool_release(&pool);
+
+    return EXIT_SUCCESS;
+}
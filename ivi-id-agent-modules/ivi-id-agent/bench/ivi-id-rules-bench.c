@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and
+ * its documentation for any purpose is hereby granted without fee, provided
+ * that the above copyright notice appear in all copies and that both that
+ * copyright notice and this permission notice appear in supporting
+ * documentation, and that the name of the copyright holders not be used in
+ * advertising or publicity pertaining to distribution of the software
+ * without specific, written prior permission.  The copyright holders make
+ * no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS
+ * SOFTWARE, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS, IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER
+ * RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+ * CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/*
+ * Measures the rule lookup of ivi-id-agent with 1000 rules: bursts of
+ * surfaces are created at once, like at the start of a HMI, and every
+ * surface looks up its surface id.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "ivi-id-rules.h"
+
+#define NUM_RULES 1000
+#define NUM_BURSTS 200
+#define BURST_SIZE 64
+
+static double
+now_usec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000.0 + ts.tv_nsec / 1000.0;
+}
+
+static int
+init_rules(struct id_rule *rule_array, struct id_rule **rule_list)
+{
+    char app_id[32];
+    char title[32];
+    uint32_t i;
+    int ret;
+
+    for (i = 0; i < NUM_RULES; i++) {
+        snprintf(app_id, sizeof app_id, "app-%u", i / 2);
+
+        /* exact, glob, regex and app_id only rules, and some rules for
+         * every app_id */
+        switch (i % 5) {
+        case 0:
+            snprintf(title, sizeof title, "window-%u", i);
+            ret = id_rule_init(&rule_array[i], 1000 + i, app_id,
+                               ID_RULE_TITLE_EXACT, title);
+            break;
+        case 1:
+            snprintf(title, sizeof title, "dialog-%u-*", i);
+            ret = id_rule_init(&rule_array[i], 1000 + i, app_id,
+                               ID_RULE_TITLE_GLOB, title);
+            break;
+        case 2:
+            snprintf(title, sizeof title, "^popup-%u-[0-9]+$", i);
+            ret = id_rule_init(&rule_array[i], 1000 + i, app_id,
+                               ID_RULE_TITLE_REGEX, title);
+            break;
+        case 3:
+            ret = id_rule_init(&rule_array[i], 1000 + i, app_id,
+                               ID_RULE_TITLE_ANY, NULL);
+            break;
+        default:
+            snprintf(title, sizeof title, "shared-%u-*", i);
+            ret = id_rule_init(&rule_array[i], 1000 + i, NULL,
+                               ID_RULE_TITLE_GLOB, title);
+            break;
+        }
+
+        if (ret < 0)
+            return -1;
+
+        rule_array[i].order = i;
+        rule_list[i] = &rule_array[i];
+    }
+
+    return 0;
+}
+
+int
+main(void)
+{
+    static struct id_rule rule_array[NUM_RULES];
+    static struct id_rule *rule_list[NUM_RULES];
+    static char app_ids[BURST_SIZE][32];
+    static char titles[BURST_SIZE][32];
+    struct id_rules rules;
+    struct id_rules_iter iter;
+    struct id_rule *rule;
+    double start, burst, total = 0.0, worst = 0.0;
+    uint32_t found = 0;
+    uint32_t i, j, n;
+
+    if (init_rules(rule_array, rule_list) < 0 ||
+        id_rules_build(&rules, rule_list, NUM_RULES) < 0) {
+        fprintf(stderr, "failed to build the rules\n");
+        return EXIT_FAILURE;
+    }
+
+    srand(1);
+
+    for (i = 0; i < NUM_BURSTS; i++) {
+        /* surfaces of the burst, some of them without a matching rule */
+        for (j = 0; j < BURST_SIZE; j++) {
+            n = rand() % (NUM_RULES + NUM_RULES / 4);
+            snprintf(app_ids[j], sizeof app_ids[j], "app-%u", n / 2);
+
+            switch (n % 5) {
+            case 0:
+                snprintf(titles[j], sizeof titles[j], "window-%u", n);
+                break;
+            case 1:
+                snprintf(titles[j], sizeof titles[j], "dialog-%u-%u", n, j);
+                break;
+            case 2:
+                snprintf(titles[j], sizeof titles[j], "popup-%u-%u", n, j);
+                break;
+            case 3:
+                snprintf(titles[j], sizeof titles[j], "main");
+                break;
+            default:
+                snprintf(titles[j], sizeof titles[j], "shared-%u-%u", n, j);
+                break;
+            }
+        }
+
+        start = now_usec();
+        for (j = 0; j < BURST_SIZE; j++) {
+            id_rules_iter_init(&iter, &rules, app_ids[j], titles[j]);
+            rule = id_rules_iter_next(&iter);
+            if (rule != NULL)
+                found++;
+        }
+        burst = now_usec() - start;
+
+        total += burst;
+        if (burst > worst)
+            worst = burst;
+    }
+
+    printf("rules: %u, bursts: %u x %u surfaces, matched: %u\n",
+           NUM_RULES, NUM_BURSTS, BURST_SIZE, found);
+    printf("lookup: %.3f usec/surface, burst: %.3f usec avg, %.3f usec max\n",
+           total / (NUM_BURSTS * BURST_SIZE), total / NUM_BURSTS, worst);
+
+    id_rules_release(&rules);
+    for (i = 0; i < NUM_RULES; i++)
+        id_rule_release(&rule_array[i]);
+
+    return EXIT_SUCCESS;
+}
@@ -24,12 +24,17 @@
 #include <stdio.h>
 #include <string.h>
 #include <limits.h>
+#include <stdbool.h>
+#include <time.h>
 
 #include <weston.h>
 #include <libweston/desktop.h>
 #include <libweston/config-parser.h>
 #include <ivi-layout-export.h>
 #include "ivi-controller.h"
+#include "ivi-id-cache.h"
+#include "ivi-id-pool.h"
+#include "ivi-id-rules.h"
 
 #ifndef INVALID_ID
 #define INVALID_ID 0xFFFFFFFF
@@ -38,9 +43,7 @@
 struct db_elem
 {
     struct wl_list link;
-    uint32_t surface_id;
-    char *cfg_app_id;
-    char *cfg_title;
+    struct id_rule rule;
     struct ivi_layout_surface *layout_surface;
 };
 
@@ -49,73 +52,111 @@ struct ivi_id_agent
     uint32_t default_behavior_set;
     uint32_t default_surface_id;
     uint32_t default_surface_id_max;
+    struct id_pool default_ids;
+    struct id_cache id_cache;
     struct wl_list app_list;
+    struct id_rules rules;
     struct weston_compositor *compositor;
     const struct ivi_layout_interface *interface;
 
+    /* the config is read at the first id allocation, see config_get() */
+    bool config_read;
+    int32_t config_result;
+
     struct wl_listener id_allocation_listener;
     struct wl_listener destroy_listener;
     struct wl_listener surface_removed;
 };
 
 static int32_t
-check_config_parameter(char *cfg_val, char *val)
-{
-    if (cfg_val == NULL)
+get_id_from_config(struct ivi_id_agent *ida, struct ivi_layout_surface
+        *layout_surface, struct weston_desktop_surface *wds) {
+    struct db_elem *db_elem;
+    struct id_rules_iter iter;
+    struct id_rule *rule;
+
+    /*
+     * The rules matching app id and title, best first. This part must be
+     * extended, if additional attributes are desired to be checked.
+     */
+    id_rules_iter_init(&iter, &ida->rules,
+                       weston_desktop_surface_get_app_id(wds),
+                       weston_desktop_surface_get_title(wds));
+    while ((rule = id_rules_iter_next(&iter)) != NULL) {
+        /* Found configuration for application. */
+        int res = ida->interface->surface_set_id(layout_surface,
+                rule->surface_id);
+        if (res)
+            continue;
+
+        db_elem = wl_container_of(rule, db_elem, rule);
+        db_elem->layout_surface = layout_surface;
         return IVI_SUCCEEDED;
-    else if (val == NULL || strcmp(cfg_val, val) != 0)
-        return IVI_FAILED;
+    }
 
-    return IVI_SUCCEEDED;
+    return IVI_FAILED;
 }
 
+/*
+ * Allocates the lowest free default surface_id. If the interval is exhausted,
+ * the id kept for the least recently used application, which is not running,
+ * is given up.
+ */
 static int32_t
-get_id_from_config(struct ivi_id_agent *ida, struct ivi_layout_surface
-        *layout_surface) {
-    struct db_elem *db_elem;
-    char *temp_app_id = NULL;
-    char *temp_title = NULL;
-    int ret = IVI_FAILED;
+alloc_default_id(struct ivi_id_agent *ida, uint32_t *surface_id)
+{
+    struct id_cache_entry *entry, *lru = NULL;
+    uint32_t i;
 
-    struct weston_surface *weston_surface =
-            ida->interface->surface_get_weston_surface(layout_surface);
+    if (id_pool_alloc(&ida->default_ids, surface_id) == 0)
+        return IVI_SUCCEEDED;
 
-    /* Get app id and title */
-    struct weston_desktop_surface *wds = weston_surface_get_desktop_surface(
-            weston_surface);
+    if (ida->id_cache.header == NULL)
+        return IVI_FAILED;
 
-    if (weston_desktop_surface_get_app_id(wds) != NULL)
-        temp_app_id = strdup(weston_desktop_surface_get_app_id(wds));
+    for (i = 0; i < ida->id_cache.header->num_entries; i++) {
+        entry = &ida->id_cache.entries[i];
 
-    if (weston_desktop_surface_get_title(wds) != NULL)
-        temp_title = strdup(weston_desktop_surface_get_title(wds));
+        if (!id_cache_entry_is_used(entry) ||
+                (lru != NULL && lru->last_used < entry->last_used) ||
+                ida->interface->get_surface_from_id(entry->surface_id) != NULL)
+            continue;
 
-    /*
-     * Check for every config parameter to be fulfilled. This part must be
-     * extended, if additional attributes are desired to be checked.
-     */
-    wl_list_for_each(db_elem, &ida->app_list, link)
-    {
-        if (check_config_parameter(db_elem->cfg_app_id, temp_app_id) == 0) {
-            if (check_config_parameter(db_elem->cfg_title, temp_title) == 0) {
-                /* Found configuration for application. */
-                int res = ida->interface->surface_set_id(layout_surface,
-                        db_elem->surface_id);
-                if (res)
-                    continue;
-
-                db_elem->layout_surface = layout_surface;
-                ret = IVI_SUCCEEDED;
-
-                break;
-            }
-        }
+        lru = entry;
     }
 
-    free(temp_app_id);
-    free(temp_title);
+    if (lru == NULL)
+        return IVI_FAILED;
+
+    id_pool_free(&ida->default_ids, lru->surface_id);
+    id_cache_remove(&ida->id_cache, lru);
+
+    if (id_pool_alloc(&ida->default_ids, surface_id) != 0)
+        return IVI_FAILED;
 
-    return ret;
+    return IVI_SUCCEEDED;
+}
+
+/*
+ * Keeps the default surface_id for the application, so that it gets the same
+ * surface_id when it is started again.
+ */
+static void
+cache_default_id(struct ivi_id_agent *ida, const char *app_id,
+        const char *title, uint32_t surface_id)
+{
+    struct id_cache_entry *entry =
+            id_cache_get_free(&ida->id_cache, app_id, title);
+
+    if (entry == NULL)
+        return;
+
+    /* The id of a replaced application is freed, when it is not running */
+    if (id_cache_entry_is_used(entry) &&
+            ida->interface->get_surface_from_id(entry->surface_id) == NULL)
+        id_pool_free(&ida->default_ids, entry->surface_id);
+
+    id_cache_set(&ida->id_cache, entry, app_id, title, surface_id);
 }
 
 /*
@@ -128,48 +169,102 @@ get_id_from_config(struct ivi_id_agent *ida, struct ivi_layout_surface
 static int32_t
 get_id(struct ivi_id_agent *ida, struct ivi_layout_surface *layout_surface)
 {
-    if (get_id_from_config(ida, layout_surface) == IVI_SUCCEEDED)
+    struct weston_surface *weston_surface =
+            ida->interface->surface_get_weston_surface(layout_surface);
+    struct id_cache_entry *entry;
+    const char *app_id;
+    const char *title;
+    uint32_t surface_id;
+
+    /* Get app id and title */
+    struct weston_desktop_surface *wds = weston_surface_get_desktop_surface(
+            weston_surface);
+
+    if (get_id_from_config(ida, layout_surface, wds) == IVI_SUCCEEDED)
         return IVI_SUCCEEDED;
 
     /* No default layer available */
     if (ida->default_behavior_set == 0) {
         weston_log("ivi-id-agent: Could not find configuration for application\n");
         goto ivi_failed;
+    }
 
     /* Default behavior for unknown applications */
-    } else if (ida->default_surface_id < ida->default_surface_id_max) {
-        weston_log("ivi-id-agent: No configuration for application adding to "
-                "default layer\n");
-
-        /*
-         * Check if ivi-shell application already created an application with
-         * desired surface_id
-         */
-        struct ivi_layout_surface *temp_layout_surf =
-                ida->interface->get_surface_from_id(
-                        ida->default_surface_id);
-        if ((temp_layout_surf != NULL) && (temp_layout_surf != layout_surface)) {
-            weston_log("ivi-id-agent: surface_id already used by an ivi-shell "
-                                "application\n");
-            goto ivi_failed;
+    weston_log("ivi-id-agent: No configuration for application adding to "
+            "default layer\n");
+
+    app_id = weston_desktop_surface_get_app_id(wds);
+    title = weston_desktop_surface_get_title(wds);
+
+    /* The surface_id the application had before */
+    entry = id_cache_find(&ida->id_cache, app_id, title);
+    if (entry != NULL && ida->interface->surface_set_id(layout_surface,
+                entry->surface_id) == 0) {
+        id_cache_touch(&ida->id_cache, entry);
+        return IVI_SUCCEEDED;
+    }
+
+    /*
+     * The lowest free id of the interval. An id already used by an
+     * ivi-shell application stays allocated until its surface is removed.
+     */
+    while (alloc_default_id(ida, &surface_id) == IVI_SUCCEEDED) {
+        if (ida->interface->surface_set_id(layout_surface, surface_id) == 0) {
+            /* A second instance of a cached application is not cached */
+            if (entry == NULL)
+                cache_default_id(ida, app_id, title, surface_id);
+
+            return IVI_SUCCEEDED;
         }
 
-        ida->interface->surface_set_id(layout_surface,
-                                              ida->default_surface_id);
-        ida->default_surface_id++;
+        if (ida->interface->get_surface_from_id(surface_id) == NULL) {
+            id_pool_free(&ida->default_ids, surface_id);
+            goto ivi_failed;
+        }
 
-    } else {
-        weston_log("ivi-id-agent: Interval for default surface_id generation "
-                "exceeded\n");
-        goto ivi_failed;
+        weston_log("ivi-id-agent: surface_id already used by an ivi-shell "
+                "application\n");
     }
 
-    return IVI_SUCCEEDED;
+    weston_log("ivi-id-agent: Interval for default surface_id generation "
+            "exceeded\n");
 
 ivi_failed:
     return IVI_FAILED;
 }
 
+static int32_t read_config(struct ivi_id_agent *ida);
+
+/*
+ * Reads the config once, when the first surface asks for an id, so that
+ * parsing the rules and opening the id cache stay off the startup path
+ * to the first frame. A config error leaves the agent without rules, it
+ * does not assign ids then.
+ */
+static int32_t
+config_get(struct ivi_id_agent *ida)
+{
+    struct timespec start, end;
+
+    if (ida->config_read)
+        return ida->config_result;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    ida->config_result = read_config(ida);
+    ida->config_read = true;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    if (ida->config_result != IVI_SUCCEEDED)
+        weston_log("ivi-id-agent: Read config failed, no surface_id is "
+                "assigned\n");
+    else
+        weston_log("ivi-id-agent: Config read in %ld us\n",
+                (long)((end.tv_sec - start.tv_sec) * 1000000 +
+                       (end.tv_nsec - start.tv_nsec) / 1000));
+
+    return ida->config_result;
+}
+
 static void
 id_allocation_event_request(struct wl_listener *listener,
         void *data)
@@ -180,6 +275,9 @@ id_allocation_event_request(struct wl_listener *listener,
     struct ivi_layout_surface *layout_surface =
             (struct ivi_layout_surface *) data;
 
+    if (config_get(ida) == IVI_FAILED)
+        return;
+
     if (get_id(ida, layout_surface) == IVI_FAILED)
         weston_log("ivi-id-agent: Could not create surface_id for application\n");
 }
@@ -191,14 +289,27 @@ surface_event_remove(struct wl_listener *listener, void *data) {
     struct ivi_layout_surface *layout_surface =
                 (struct ivi_layout_surface *) data;
     struct db_elem *db_elem = NULL;
+    uint32_t surface_id;
+
+    /* no surface_id was assigned yet */
+    if (!ida->config_read)
+        return;
 
     wl_list_for_each(db_elem, &ida->app_list, link)
     {
         if(db_elem->layout_surface == layout_surface) {
             db_elem->layout_surface = NULL;
-            break;
+            return;
         }
     }
+
+    /*
+     * The default surface_ids are reused, unless they are kept for their
+     * application
+     */
+    surface_id = ida->interface->get_id_of_surface(layout_surface);
+    if (id_cache_find_id(&ida->id_cache, surface_id) == NULL)
+        id_pool_free(&ida->default_ids, surface_id);
 }
 
 static int32_t deinit(struct ivi_id_agent *ida);
@@ -216,10 +327,10 @@ check_config(struct db_elem *curr_db_elem, struct ivi_id_agent *ida)
 {
     struct db_elem *db_elem;
 
-    if (ida->default_surface_id <= curr_db_elem->surface_id
-            && curr_db_elem->surface_id <= ida->default_surface_id_max) {
+    if (ida->default_surface_id <= curr_db_elem->rule.surface_id
+            && curr_db_elem->rule.surface_id <= ida->default_surface_id_max) {
         weston_log("ivi-id-agent: surface_id: %d in default id interval "
-                "[%d, %d] (CONFIG ERROR)\n", curr_db_elem->surface_id,
+                "[%d, %d] (CONFIG ERROR)\n", curr_db_elem->rule.surface_id,
                 ida->default_surface_id, ida->default_surface_id_max);
         goto ivi_failed;
     }
@@ -229,9 +340,9 @@ check_config(struct db_elem *curr_db_elem, struct ivi_id_agent *ida)
         if(curr_db_elem == db_elem)
             continue;
 
-        if (db_elem->surface_id == curr_db_elem->surface_id) {
+        if (db_elem->rule.surface_id == curr_db_elem->rule.surface_id) {
             weston_log("ivi-id-agent: Duplicate surface_id: %d (CONFIG ERROR)\n",
-                    curr_db_elem->surface_id);
+                    curr_db_elem->rule.surface_id);
             goto ivi_failed;
         }
     }
@@ -242,12 +353,149 @@ ivi_failed:
     return IVI_FAILED;
 }
 
+/*
+ * Reads the rule of a [desktop-app] section:
+ *
+ *   surface-id       id given to the matching surfaces
+ *   app-id           app_id of the surfaces, any app_id if not set
+ *   app-title        title of the surfaces, or instead
+ *   app-title-glob   pattern of the title with '*' and '?' wildcards, or
+ *   app-title-regex  POSIX extended regular expression of the title
+ *   priority         the matching rule with the highest priority wins,
+ *                    default 0
+ *
+ * Of matching rules with the same priority, rules with app-id win over
+ * rules without, then exact titles over globs over regular expressions
+ * over no title, then later sections over earlier ones.
+ */
+static int32_t
+read_rule(struct weston_config_section *section, struct db_elem *db_elem,
+          uint32_t order)
+{
+    const char *keys[] = { "app-title", "app-title-glob", "app-title-regex" };
+    const enum id_rule_title kinds[] = {
+        ID_RULE_TITLE_EXACT, ID_RULE_TITLE_GLOB, ID_RULE_TITLE_REGEX
+    };
+    enum id_rule_title title_kind = ID_RULE_TITLE_ANY;
+    uint32_t surface_id;
+    char *app_id = NULL;
+    char *title = NULL;
+    char *value;
+    unsigned i;
+    int ret;
+
+    weston_config_section_get_uint(section, "surface-id",
+                     &surface_id, INVALID_ID);
+
+    if (surface_id == INVALID_ID) {
+        weston_log("ivi-id-agent: surface-id is not set in configuration\n");
+        return IVI_FAILED;
+    }
+
+    for (i = 0; i < sizeof keys / sizeof keys[0]; i++) {
+        weston_config_section_get_string(section, keys[i], &value, NULL);
+        if (value == NULL)
+            continue;
+
+        if (title != NULL) {
+            weston_log("ivi-id-agent: More than one title for surface-id "
+                    "%d in configuration\n", surface_id);
+            free(value);
+            free(title);
+            return IVI_FAILED;
+        }
+
+        title = value;
+        title_kind = kinds[i];
+    }
+
+    weston_config_section_get_string(section, "app-id", &app_id, NULL);
+
+    if (app_id == NULL && title == NULL) {
+        weston_log("ivi-id-agent: Every parameter is NULL in app "
+                "configuration\n");
+        return IVI_FAILED;
+    }
+
+    ret = id_rule_init(&db_elem->rule, surface_id, app_id, title_kind, title);
+    free(app_id);
+    free(title);
+
+    if (ret < 0) {
+        weston_log("ivi-id-agent: Invalid title pattern for surface-id %d\n",
+                surface_id);
+        return IVI_FAILED;
+    }
+
+    weston_config_section_get_int(section, "priority",
+                     &db_elem->rule.priority, 0);
+    db_elem->rule.order = order;
+
+    return IVI_SUCCEEDED;
+}
+
+static int32_t
+build_rules(struct ivi_id_agent *ida)
+{
+    struct db_elem *db_elem;
+    struct id_rule **rule_list;
+    uint32_t num_rules = 0;
+    int ret;
+
+    rule_list = calloc(wl_list_length(&ida->app_list) + 1, sizeof *rule_list);
+    if (rule_list == NULL) {
+        weston_log("ivi-id-agent: No memory to allocate\n");
+        return IVI_FAILED;
+    }
+
+    wl_list_for_each(db_elem, &ida->app_list, link)
+        rule_list[num_rules++] = &db_elem->rule;
+
+    ret = id_rules_build(&ida->rules, rule_list, num_rules);
+    free(rule_list);
+
+    if (ret < 0) {
+        weston_log("ivi-id-agent: No memory to allocate\n");
+        return IVI_FAILED;
+    }
+
+    return IVI_SUCCEEDED;
+}
+
+/*
+ * Opens the cache of default surface_ids and keeps the cached ids for their
+ * applications.
+ */
+static void
+open_id_cache(struct ivi_id_agent *ida, const char *path, uint32_t size)
+{
+    struct id_cache_entry *entry;
+    uint32_t i;
+
+    if (id_cache_open(&ida->id_cache, path, size) < 0) {
+        weston_log("ivi-id-agent: Could not open id cache %s\n", path);
+        return;
+    }
+
+    /* Entries of another default surface_id interval are dropped */
+    for (i = 0; i < size; i++) {
+        entry = &ida->id_cache.entries[i];
+
+        if (id_cache_entry_is_used(entry) &&
+                id_pool_take(&ida->default_ids, entry->surface_id) != 0)
+            id_cache_remove(&ida->id_cache, entry);
+    }
+}
+
 static int32_t
 read_config(struct ivi_id_agent *ida)
 {
     struct weston_config *config = NULL;
     struct weston_config_section *section = NULL;
     const char *name = NULL;
+    char *id_cache_path = NULL;
+    uint32_t id_cache_size = 0;
+    uint32_t order = 0;
 
     config = wet_get_config(ida->compositor);
     if (!config)
@@ -265,6 +513,18 @@ read_config(struct ivi_id_agent *ida)
                 &ida->default_surface_id, INVALID_ID);
         weston_config_section_get_uint(section, "default-surface-id-max",
                 &ida->default_surface_id_max, INVALID_ID);
+        weston_config_section_get_string(section, "id-cache",
+                &id_cache_path, NULL);
+        weston_config_section_get_uint(section, "id-cache-size",
+                &id_cache_size, 64);
+
+        if (id_cache_size == 0 || id_cache_size > ID_CACHE_MAX_ENTRIES) {
+            weston_log("ivi-id-agent: id-cache-size %u is not in 1..%u, "
+                    "the id cache is disabled\n", id_cache_size,
+                    ID_CACHE_MAX_ENTRIES);
+            free(id_cache_path);
+            id_cache_path = NULL;
+        }
 
         if (ida->default_surface_id == INVALID_ID ||
                 ida->default_surface_id_max == INVALID_ID) {
@@ -291,24 +551,8 @@ read_config(struct ivi_id_agent *ida)
 
         wl_list_insert(&ida->app_list, &db_elem->link);
 
-        weston_config_section_get_uint(section, "surface-id",
-                         &db_elem->surface_id, INVALID_ID);
-
-        if (db_elem->surface_id == INVALID_ID) {
-            weston_log("ivi-id-agent: surface-id is not set in configuration\n");
+        if (read_rule(section, db_elem, order++) == IVI_FAILED)
             goto ivi_failed;
-        }
-
-        weston_config_section_get_string(section, "app-id",
-                         &db_elem->cfg_app_id, NULL);
-        weston_config_section_get_string(section, "app-title",
-                         &db_elem->cfg_title, NULL);
-
-        if (db_elem->cfg_app_id == NULL && db_elem->cfg_title == NULL) {
-            weston_log("ivi-id-agent: Every parameter is NULL in app "
-                    "configuration\n");
-            goto ivi_failed;
-        }
 
         if (check_config(db_elem, ida) == IVI_FAILED) {
             weston_log("ivi-id-agent: No valid config found, deinit...\n");
@@ -321,9 +565,22 @@ read_config(struct ivi_id_agent *ida)
         goto ivi_failed;
     }
 
+    if (build_rules(ida) == IVI_FAILED)
+        goto ivi_failed;
+
+    if (ida->default_behavior_set &&
+            ida->default_surface_id < ida->default_surface_id_max)
+        id_pool_init(&ida->default_ids, ida->default_surface_id,
+                     ida->default_surface_id_max - ida->default_surface_id);
+
+    if (ida->default_behavior_set && id_cache_path != NULL)
+        open_id_cache(ida, id_cache_path, id_cache_size);
+
+    free(id_cache_path);
     return IVI_SUCCEEDED;
 
 ivi_failed:
+    free(id_cache_path);
     return IVI_FAILED;
 }
 
@@ -354,11 +611,6 @@ id_agent_module_init(struct ivishell *shell)
     ida->interface->add_listener_remove_surface(&ida->surface_removed);
 
     wl_list_init(&ida->app_list);
-    if(read_config(ida) != 0) {
-        weston_log("ivi-id-agent: Read config failed\n");
-        deinit(ida);
-        goto ivi_failed;
-    }
 
     return IVI_SUCCEEDED;
 
@@ -373,10 +625,12 @@ deinit(struct ivi_id_agent *ida)
     wl_list_for_each_safe(db_elem, dl_elem_next, &ida->app_list, link) {
         wl_list_remove(&db_elem->link);
 
-        free(db_elem->cfg_app_id);
-        free(db_elem->cfg_title);
+        id_rule_release(&db_elem->rule);
         free(db_elem);
     }
+    id_rules_release(&ida->rules);
+    id_pool_release(&ida->default_ids);
+    id_cache_close(&ida->id_cache);
 
     wl_list_remove(&ida->id_allocation_listener.link);
     wl_list_remove(&ida->destroy_listener.link);
@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and
+ * its documentation for any purpose is hereby granted without fee, provided
+ * that the above copyright notice appear in all copies and that both that
+ * copyright notice and this permission notice appear in supporting
+ * documentation, and that the name of the copyright holders not be used in
+ * advertising or publicity pertaining to distribution of the software
+ * without specific, written prior permission.  The copyright holders make
+ * no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS
+ * SOFTWARE, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS, IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER
+ * RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+ * CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ivi-id-cache.h"
+
+#define ID_CACHE_MAGIC 0x49564943 /* "IVIC" */
+#define ID_CACHE_VERSION 1
+
+static uint32_t
+hash_key(const char *app_id, const char *title)
+{
+    /* FNV-1a of app_id and title, separated by a NUL */
+    uint32_t hash = 2166136261u;
+    const char *str;
+
+    for (str = app_id; *str; str++) {
+        hash ^= (unsigned char)*str;
+        hash *= 16777619u;
+    }
+
+    hash *= 16777619u;
+
+    for (str = title; *str; str++) {
+        hash ^= (unsigned char)*str;
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+static bool
+entry_matches(const struct id_cache_entry *entry, uint32_t hash,
+              const char *app_id, const char *title)
+{
+    return (entry->hash == hash) &&
+           (0 == strncmp(entry->app_id, app_id, ID_CACHE_APP_ID_SIZE)) &&
+           (0 == strncmp(entry->title, title, ID_CACHE_TITLE_SIZE));
+}
+
+/*
+ * The file may be corrupted or written by someone else, an entry is only
+ * kept if its strings are terminated within their fields and match its
+ * hash. The clock is advanced past the newest entry.
+ */
+static void
+validate_entries(struct id_cache *cache)
+{
+    struct id_cache_entry *entry;
+    uint32_t i;
+
+    for (i = 0; i < cache->header->num_entries; i++) {
+        entry = &cache->entries[i];
+
+        if (!id_cache_entry_is_used(entry))
+            continue;
+
+        if ((NULL == memchr(entry->app_id, '\0', ID_CACHE_APP_ID_SIZE)) ||
+            (NULL == memchr(entry->title, '\0', ID_CACHE_TITLE_SIZE)) ||
+            (entry->hash != hash_key(entry->app_id, entry->title))) {
+            memset(entry, 0, sizeof *entry);
+            continue;
+        }
+
+        if (entry->last_used > cache->header->clock)
+            cache->header->clock = entry->last_used;
+    }
+}
+
+static bool
+key_fits(const char *app_id, const char *title)
+{
+    return (strlen(app_id) < ID_CACHE_APP_ID_SIZE) &&
+           (strlen(title) < ID_CACHE_TITLE_SIZE);
+}
+
+int
+id_cache_open(struct id_cache *cache, const char *path, uint32_t num_entries)
+{
+    struct stat st;
+    void *map;
+
+    memset(cache, 0, sizeof *cache);
+    cache->fd = -1;
+
+    if ((0 == num_entries) || (num_entries > ID_CACHE_MAX_ENTRIES))
+        return -1;
+
+    cache->size = sizeof *cache->header +
+                  num_entries * sizeof *cache->entries;
+
+    cache->fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (cache->fd < 0)
+        return -1;
+
+    if ((fstat(cache->fd, &st) < 0) ||
+        (((size_t)st.st_size != cache->size) &&
+         (ftruncate(cache->fd, cache->size) < 0)))
+        goto failed;
+
+    map = mmap(NULL, cache->size, PROT_READ | PROT_WRITE, MAP_SHARED,
+               cache->fd, 0);
+    if (MAP_FAILED == map)
+        goto failed;
+
+    cache->header = map;
+    cache->entries = (struct id_cache_entry *)(cache->header + 1);
+
+    /* a new file, a file of an other version or size */
+    if ((ID_CACHE_MAGIC != cache->header->magic) ||
+        (ID_CACHE_VERSION != cache->header->version) ||
+        (num_entries != cache->header->num_entries)) {
+        memset(map, 0, cache->size);
+        cache->header->magic = ID_CACHE_MAGIC;
+        cache->header->version = ID_CACHE_VERSION;
+        cache->header->num_entries = num_entries;
+    } else {
+        validate_entries(cache);
+    }
+
+    return 0;
+
+failed:
+    close(cache->fd);
+    cache->fd = -1;
+    return -1;
+}
+
+void
+id_cache_close(struct id_cache *cache)
+{
+    if (NULL == cache->header)
+        return;
+
+    munmap(cache->header, cache->size);
+    close(cache->fd);
+
+    memset(cache, 0, sizeof *cache);
+    cache->fd = -1;
+}
+
+struct id_cache_entry *
+id_cache_find(struct id_cache *cache, const char *app_id, const char *title)
+{
+    struct id_cache_entry *entry;
+    uint32_t i, hash;
+
+    if (NULL == cache->header)
+        return NULL;
+
+    app_id = app_id ? app_id : "";
+    title = title ? title : "";
+    hash = hash_key(app_id, title);
+
+    for (i = 0; i < cache->header->num_entries; i++) {
+        entry = &cache->entries[i];
+
+        if (id_cache_entry_is_used(entry) &&
+            entry_matches(entry, hash, app_id, title))
+            return entry;
+    }
+
+    return NULL;
+}
+
+struct id_cache_entry *
+id_cache_find_id(struct id_cache *cache, uint32_t surface_id)
+{
+    uint32_t i;
+
+    if (NULL == cache->header)
+        return NULL;
+
+    for (i = 0; i < cache->header->num_entries; i++) {
+        if (id_cache_entry_is_used(&cache->entries[i]) &&
+            (cache->entries[i].surface_id == surface_id))
+            return &cache->entries[i];
+    }
+
+    return NULL;
+}
+
+void
+id_cache_touch(struct id_cache *cache, struct id_cache_entry *entry)
+{
+    entry->last_used = ++cache->header->clock;
+}
+
+struct id_cache_entry *
+id_cache_get_free(struct id_cache *cache, const char *app_id,
+                  const char *title)
+{
+    struct id_cache_entry *lru = NULL;
+    uint32_t i;
+
+    if ((NULL == cache->header) ||
+        !key_fits(app_id ? app_id : "", title ? title : ""))
+        return NULL;
+
+    for (i = 0; i < cache->header->num_entries; i++) {
+        if (!id_cache_entry_is_used(&cache->entries[i]))
+            return &cache->entries[i];
+
+        if ((NULL == lru) || (cache->entries[i].last_used < lru->last_used))
+            lru = &cache->entries[i];
+    }
+
+    return lru;
+}
+
+void
+id_cache_set(struct id_cache *cache, struct id_cache_entry *entry,
+             const char *app_id, const char *title, uint32_t surface_id)
+{
+    app_id = app_id ? app_id : "";
+    title = title ? title : "";
+
+    memset(entry, 0, sizeof *entry);
+    strcpy(entry->app_id, app_id);
+    strcpy(entry->title, title);
+    entry->hash = hash_key(app_id, title);
+    entry->surface_id = surface_id;
+    id_cache_touch(cache, entry);
+
+    msync(cache->header, cache->size, MS_ASYNC);
+}
+
+void
+id_cache_remove(struct id_cache *cache, struct id_cache_entry *entry)
+{
+    memset(entry, 0, sizeof *entry);
+    msync(cache->header, cache->size, MS_ASYNC);
+}
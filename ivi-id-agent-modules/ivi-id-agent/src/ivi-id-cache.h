@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and
+ * its documentation for any purpose is hereby granted without fee, provided
+ * that the above copyright notice appear in all copies and that both that
+ * copyright notice and this permission notice appear in supporting
+ * documentation, and that the name of the copyright holders not be used in
+ * advertising or publicity pertaining to distribution of the software
+ * without specific, written prior permission.  The copyright holders make
+ * no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS
+ * SOFTWARE, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS, IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER
+ * RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+ * CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef IVI_ID_CACHE_H
+#define IVI_ID_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define ID_CACHE_APP_ID_SIZE 64
+#define ID_CACHE_TITLE_SIZE 128
+/* bounds the mapping to about 800 KiB */
+#define ID_CACHE_MAX_ENTRIES 4096
+
+/*
+ * An (app_id, title) -> surface_id assignment. An entry which has never been
+ * used has last_used 0. The strings are empty, if the surface had none.
+ */
+struct id_cache_entry {
+    uint64_t last_used;
+    uint32_t surface_id;
+    uint32_t hash;
+    char app_id[ID_CACHE_APP_ID_SIZE];
+    char title[ID_CACHE_TITLE_SIZE];
+};
+
+struct id_cache_header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t num_entries;
+    uint32_t reserved;
+    /* last_used of the most recently used entry */
+    uint64_t clock;
+};
+
+/*
+ * A fixed number of assignments in a memory mapped file, so that the
+ * assignments survive restarts of the compositor. When it is full, the
+ * least recently used assignment is replaced.
+ */
+struct id_cache {
+    int fd;
+    size_t size;
+    struct id_cache_header *header;
+    struct id_cache_entry *entries;
+};
+
+/* Maps the file at path, which is created or reset if it does not hold a
+ * cache of num_entries. Entries, which are not terminated or do not match
+ * their hash, are dropped. Returns -1 on failure or if num_entries is 0 or
+ * above ID_CACHE_MAX_ENTRIES. */
+int
+id_cache_open(struct id_cache *cache, const char *path, uint32_t num_entries);
+
+void
+id_cache_close(struct id_cache *cache);
+
+struct id_cache_entry *
+id_cache_find(struct id_cache *cache, const char *app_id, const char *title);
+
+struct id_cache_entry *
+id_cache_find_id(struct id_cache *cache, uint32_t surface_id);
+
+/* Marks the entry as the most recently used one */
+void
+id_cache_touch(struct id_cache *cache, struct id_cache_entry *entry);
+
+/*
+ * Returns the entry to store the assignment of app_id and title in, which
+ * is either unused or the least recently used one. Returns NULL, if app_id
+ * or title do not fit into an entry.
+ */
+struct id_cache_entry *
+id_cache_get_free(struct id_cache *cache, const char *app_id,
+                  const char *title);
+
+void
+id_cache_set(struct id_cache *cache, struct id_cache_entry *entry,
+             const char *app_id, const char *title, uint32_t surface_id);
+
+void
+id_cache_remove(struct id_cache *cache, struct id_cache_entry *entry);
+
+static inline bool
+id_cache_entry_is_used(const struct id_cache_entry *entry)
+{
+    return entry->last_used != 0;
+}
+
+#endif /* IVI_ID_CACHE_H */
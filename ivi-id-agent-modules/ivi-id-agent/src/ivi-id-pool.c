@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and
+ * its documentation for any purpose is hereby granted without fee, provided
+ * that the above copyright notice appear in all copies and that both that
+ * copyright notice and this permission notice appear in supporting
+ * documentation, and that the name of the copyright holders not be used in
+ * advertising or publicity pertaining to distribution of the software
+ * without specific, written prior permission.  The copyright holders make
+ * no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS
+ * SOFTWARE, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS, IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER
+ * RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+ * CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ivi-id-pool.h"
+
+#define WORD_BITS 64
+
+static uint32_t
+num_words(uint32_t num_bits)
+{
+    return (uint32_t)(((uint64_t)num_bits + WORD_BITS - 1) / WORD_BITS);
+}
+
+static bool
+test_bit(const uint64_t *bits, uint32_t index)
+{
+    return (bits[index / WORD_BITS] >> (index % WORD_BITS)) & 1;
+}
+
+/* Grows the bitmap of the ids and rebuilds the summary levels */
+static int
+id_pool_resize(struct id_pool *pool, uint32_t capacity)
+{
+    uint64_t *levels[ID_POOL_MAX_LEVELS] = { NULL };
+    uint64_t *bits;
+    uint32_t level, old_words, words, i;
+
+    old_words = num_words(pool->capacity);
+    words = num_words(capacity);
+
+    bits = realloc(pool->free_bits[0], words * sizeof *bits);
+    if (NULL == bits)
+        return -1;
+
+    pool->free_bits[0] = bits;
+
+    /* the new ids are free, the tail of the last word is not part of the
+     * pool */
+    memset(bits + old_words, 0xff, (words - old_words) * sizeof *bits);
+    if (capacity % WORD_BITS)
+        bits[words - 1] &= ((uint64_t)1 << (capacity % WORD_BITS)) - 1;
+
+    levels[0] = bits;
+    for (level = 1; words > 1; level++) {
+        levels[level] = calloc(num_words(words), sizeof *bits);
+        if (NULL == levels[level])
+            goto failed;
+
+        for (i = 0; i < words; i++) {
+            if (levels[level - 1][i] != 0)
+                levels[level][i / WORD_BITS] |= (uint64_t)1 << (i % WORD_BITS);
+        }
+
+        words = num_words(words);
+    }
+
+    for (i = 1; i < ID_POOL_MAX_LEVELS; i++) {
+        free(pool->free_bits[i]);
+        pool->free_bits[i] = levels[i];
+    }
+
+    pool->capacity = capacity;
+    pool->num_levels = level;
+    return 0;
+
+failed:
+    while (--level > 0)
+        free(levels[level]);
+
+    return -1;
+}
+
+void
+id_pool_init(struct id_pool *pool, uint32_t first_id, uint32_t num_ids)
+{
+    memset(pool, 0, sizeof *pool);
+    pool->first_id = first_id;
+    pool->num_ids = num_ids;
+}
+
+void
+id_pool_release(struct id_pool *pool)
+{
+    uint32_t level;
+
+    for (level = 0; level < ID_POOL_MAX_LEVELS; level++)
+        free(pool->free_bits[level]);
+
+    memset(pool, 0, sizeof *pool);
+}
+
+/* Marks the id at index as used, and the words, which have been filled
+ * up, at the levels above */
+static void
+id_pool_set_used(struct id_pool *pool, uint32_t index)
+{
+    uint32_t level, word;
+
+    pool->num_used++;
+
+    for (level = 0; level < pool->num_levels; level++) {
+        word = index / WORD_BITS;
+        pool->free_bits[level][word] &= ~((uint64_t)1 << (index % WORD_BITS));
+
+        if (pool->free_bits[level][word] != 0)
+            break;
+
+        index = word;
+    }
+}
+
+/* Doubles the bitmap until it covers num_ids */
+static int
+id_pool_grow(struct id_pool *pool, uint32_t num_ids)
+{
+    uint64_t capacity = (pool->capacity < WORD_BITS) ?
+                        WORD_BITS : pool->capacity;
+
+    while (capacity < num_ids)
+        capacity *= 2;
+
+    if (capacity > pool->num_ids)
+        capacity = pool->num_ids;
+
+    return id_pool_resize(pool, (uint32_t)capacity);
+}
+
+int
+id_pool_alloc(struct id_pool *pool, uint32_t *id)
+{
+    uint32_t level, index = 0;
+
+    if (pool->num_used == pool->num_ids)
+        return -1;
+
+    /* every covered id is used, double the bitmap */
+    if ((pool->num_used == pool->capacity) &&
+        (id_pool_grow(pool, pool->capacity + 1) < 0))
+        return -1;
+
+    /* from the top level down to the lowest free id */
+    for (level = pool->num_levels; level-- > 0;) {
+        index = index * WORD_BITS +
+                (uint32_t)__builtin_ctzll(pool->free_bits[level][index]);
+    }
+
+    id_pool_set_used(pool, index);
+    *id = pool->first_id + index;
+    return 0;
+}
+
+int
+id_pool_take(struct id_pool *pool, uint32_t id)
+{
+    uint32_t index;
+
+    if (id < pool->first_id || id - pool->first_id >= pool->num_ids)
+        return -1;
+
+    index = id - pool->first_id;
+    if ((index >= pool->capacity) && (id_pool_grow(pool, index + 1) < 0))
+        return -1;
+
+    if (!test_bit(pool->free_bits[0], index))
+        return -1;
+
+    id_pool_set_used(pool, index);
+    return 0;
+}
+
+void
+id_pool_free(struct id_pool *pool, uint32_t id)
+{
+    uint32_t level, index;
+
+    if (id < pool->first_id || id - pool->first_id >= pool->capacity)
+        return;
+
+    index = id - pool->first_id;
+    if (test_bit(pool->free_bits[0], index))
+        return;
+
+    for (level = 0; level < pool->num_levels; level++) {
+        uint64_t *word = &pool->free_bits[level][index / WORD_BITS];
+        bool was_full = (*word == 0);
+
+        *word |= (uint64_t)1 << (index % WORD_BITS);
+        if (!was_full)
+            break;
+
+        index /= WORD_BITS;
+    }
+
+    pool->num_used--;
+}
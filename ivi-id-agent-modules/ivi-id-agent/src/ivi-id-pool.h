@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and
+ * its documentation for any purpose is hereby granted without fee, provided
+ * that the above copyright notice appear in all copies and that both that
+ * copyright notice and this permission notice appear in supporting
+ * documentation, and that the name of the copyright holders not be used in
+ * advertising or publicity pertaining to distribution of the software
+ * without specific, written prior permission.  The copyright holders make
+ * no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS
+ * SOFTWARE, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS, IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER
+ * RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+ * CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef IVI_ID_POOL_H
+#define IVI_ID_POOL_H
+
+#include <stdint.h>
+
+/* 64^6 words cover every uint32_t id */
+#define ID_POOL_MAX_LEVELS 6
+
+/*
+ * Allocator of the ids in [first_id, first_id + num_ids), which hands out
+ * the lowest free id first.
+ *
+ * The free ids are kept in a bitmap with a summary bitmap on top of it per
+ * 64 words, so that the lowest free id is found by one word per level. The
+ * bitmap covers the ids handed out so far only and doubles on demand.
+ */
+struct id_pool {
+    uint32_t first_id;
+    uint32_t num_ids;
+    uint32_t num_used;
+
+    /* ids covered by the bitmap */
+    uint32_t capacity;
+    uint32_t num_levels;
+    /* set bit: the id, or at upper levels the word below, has a free id */
+    uint64_t *free_bits[ID_POOL_MAX_LEVELS];
+};
+
+void
+id_pool_init(struct id_pool *pool, uint32_t first_id, uint32_t num_ids);
+
+void
+id_pool_release(struct id_pool *pool);
+
+/* Returns -1, if the pool is exhausted or out of memory */
+int
+id_pool_alloc(struct id_pool *pool, uint32_t *id);
+
+/* Allocates the given id. Returns -1, if the id is outside of the pool,
+ * already used or out of memory */
+int
+id_pool_take(struct id_pool *pool, uint32_t id);
+
+/* Ids outside of the pool and free ids are ignored */
+void
+id_pool_free(struct id_pool *pool, uint32_t id);
+
+#endif /* IVI_ID_POOL_H */
@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and
+ * its documentation for any purpose is hereby granted without fee, provided
+ * that the above copyright notice appear in all copies and that both that
+ * copyright notice and this permission notice appear in supporting
+ * documentation, and that the name of the copyright holders not be used in
+ * advertising or publicity pertaining to distribution of the software
+ * without specific, written prior permission.  The copyright holders make
+ * no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS
+ * SOFTWARE, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS, IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER
+ * RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+ * CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ivi-id-rules.h"
+
+static uint32_t
+hash_string(const char *str)
+{
+    /* FNV-1a */
+    uint32_t hash = 2166136261u;
+
+    while (*str) {
+        hash ^= (unsigned char)*str++;
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+/* Matches '*', '?' and '\' escapes. A '*' backtracks to the position
+ * after the last '*' only, which is enough as a '*' matches anything the
+ * later ones could. */
+static bool
+glob_match(const char *pattern, const char *str)
+{
+    const char *star = NULL;
+    const char *star_str = NULL;
+
+    while (*str) {
+        if (*pattern == '*') {
+            star = ++pattern;
+            star_str = str;
+            continue;
+        }
+
+        if ((*pattern == '?') ||
+            ((*pattern == '\\') && (pattern[1] == *str)) ||
+            ((*pattern != '\\') && (*pattern == *str))) {
+            pattern += (*pattern == '\\') ? 2 : 1;
+            str++;
+            continue;
+        }
+
+        if (NULL == star)
+            return false;
+
+        pattern = star;
+        str = ++star_str;
+    }
+
+    while (*pattern == '*')
+        pattern++;
+
+    return *pattern == '\0';
+}
+
+static bool
+id_rule_title_matches(const struct id_rule *rule, const char *title)
+{
+    switch (rule->title_kind) {
+    case ID_RULE_TITLE_EXACT:
+        return (NULL != title) && (0 == strcmp(rule->title, title));
+    case ID_RULE_TITLE_GLOB:
+        return (NULL != title) && glob_match(rule->title, title);
+    case ID_RULE_TITLE_REGEX:
+        return (NULL != title) &&
+               (0 == regexec(&rule->title_regex, title, 0, NULL, 0));
+    case ID_RULE_TITLE_ANY:
+    default:
+        return true;
+    }
+}
+
+static bool
+id_rule_precedes(const struct id_rule *rule, const struct id_rule *other)
+{
+    if (rule->priority != other->priority)
+        return rule->priority > other->priority;
+
+    if ((NULL == rule->app_id) != (NULL == other->app_id))
+        return NULL != rule->app_id;
+
+    if (rule->title_kind != other->title_kind)
+        return rule->title_kind < other->title_kind;
+
+    return rule->order > other->order;
+}
+
+static void
+id_rules_insert(struct id_rule **chain, struct id_rule *rule)
+{
+    while ((NULL != *chain) && id_rule_precedes(*chain, rule))
+        chain = &(*chain)->next;
+
+    rule->next = *chain;
+    *chain = rule;
+}
+
+int
+id_rule_init(struct id_rule *rule, uint32_t surface_id, const char *app_id,
+             enum id_rule_title title_kind, const char *title)
+{
+    memset(rule, 0, sizeof *rule);
+    rule->surface_id = surface_id;
+    rule->title_kind = (NULL == title) ? ID_RULE_TITLE_ANY : title_kind;
+
+    if (NULL != app_id) {
+        rule->app_id = strdup(app_id);
+        if (NULL == rule->app_id)
+            return -1;
+    }
+
+    if (ID_RULE_TITLE_ANY == rule->title_kind)
+        return 0;
+
+    rule->title = strdup(title);
+    if (NULL == rule->title)
+        goto failed;
+
+    if ((ID_RULE_TITLE_REGEX == rule->title_kind) &&
+        (0 != regcomp(&rule->title_regex, title, REG_EXTENDED | REG_NOSUB)))
+        goto failed;
+
+    return 0;
+
+failed:
+    free(rule->app_id);
+    free(rule->title);
+    rule->app_id = NULL;
+    rule->title = NULL;
+    rule->title_kind = ID_RULE_TITLE_ANY;
+    return -1;
+}
+
+void
+id_rule_release(struct id_rule *rule)
+{
+    if (ID_RULE_TITLE_REGEX == rule->title_kind)
+        regfree(&rule->title_regex);
+
+    free(rule->app_id);
+    free(rule->title);
+}
+
+int
+id_rules_build(struct id_rules *rules, struct id_rule **rule_list,
+               uint32_t num_rules)
+{
+    uint32_t i;
+
+    memset(rules, 0, sizeof *rules);
+
+    /* at most one rule per bucket on average */
+    rules->num_buckets = 16;
+    while (rules->num_buckets < num_rules)
+        rules->num_buckets *= 2;
+
+    rules->buckets = calloc(rules->num_buckets, sizeof *rules->buckets);
+    if (NULL == rules->buckets)
+        return -1;
+
+    for (i = 0; i < num_rules; i++) {
+        if (NULL == rule_list[i]->app_id) {
+            id_rules_insert(&rules->any_app_id, rule_list[i]);
+            continue;
+        }
+
+        rule_list[i]->app_id_hash = hash_string(rule_list[i]->app_id);
+        id_rules_insert(&rules->buckets[rule_list[i]->app_id_hash &
+                                        (rules->num_buckets - 1)],
+                        rule_list[i]);
+    }
+
+    return 0;
+}
+
+void
+id_rules_release(struct id_rules *rules)
+{
+    free(rules->buckets);
+    memset(rules, 0, sizeof *rules);
+}
+
+void
+id_rules_iter_init(struct id_rules_iter *iter, const struct id_rules *rules,
+                   const char *app_id, const char *title)
+{
+    iter->app_id = app_id;
+    iter->title = title;
+    iter->by_app_id = NULL;
+    iter->any_app_id = rules->any_app_id;
+
+    if ((NULL != app_id) && (NULL != rules->buckets)) {
+        iter->app_id_hash = hash_string(app_id);
+        iter->by_app_id =
+                rules->buckets[iter->app_id_hash & (rules->num_buckets - 1)];
+    }
+}
+
+struct id_rule *
+id_rules_iter_next(struct id_rules_iter *iter)
+{
+    struct id_rule *rule;
+
+    for (;;) {
+        /* skip the rules of other app_ids in the same bucket */
+        while ((NULL != iter->by_app_id) &&
+               ((iter->by_app_id->app_id_hash != iter->app_id_hash) ||
+                (0 != strcmp(iter->by_app_id->app_id, iter->app_id))))
+            iter->by_app_id = iter->by_app_id->next;
+
+        if ((NULL == iter->by_app_id) && (NULL == iter->any_app_id))
+            return NULL;
+
+        if ((NULL == iter->any_app_id) ||
+            ((NULL != iter->by_app_id) &&
+             id_rule_precedes(iter->by_app_id, iter->any_app_id))) {
+            rule = iter->by_app_id;
+            iter->by_app_id = rule->next;
+        } else {
+            rule = iter->any_app_id;
+            iter->any_app_id = rule->next;
+        }
+
+        if (id_rule_title_matches(rule, iter->title))
+            return rule;
+    }
+}
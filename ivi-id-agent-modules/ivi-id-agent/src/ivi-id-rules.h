@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and
+ * its documentation for any purpose is hereby granted without fee, provided
+ * that the above copyright notice appear in all copies and that both that
+ * copyright notice and this permission notice appear in supporting
+ * documentation, and that the name of the copyright holders not be used in
+ * advertising or publicity pertaining to distribution of the software
+ * without specific, written prior permission.  The copyright holders make
+ * no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS
+ * SOFTWARE, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS, IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER
+ * RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+ * CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef IVI_ID_RULES_H
+#define IVI_ID_RULES_H
+
+#include <stdint.h>
+#include <regex.h>
+
+/* Kinds of title matching, in the order they take precedence */
+enum id_rule_title {
+    ID_RULE_TITLE_EXACT,
+    ID_RULE_TITLE_GLOB,
+    ID_RULE_TITLE_REGEX,
+    ID_RULE_TITLE_ANY
+};
+
+/*
+ * A rule which assigns surface_id to surfaces with the app_id, NULL for
+ * every app_id, and a title matching the title pattern.
+ *
+ * Of the rules matching a surface, the one with the highest priority
+ * takes precedence, then rules with an app_id, then rules by title kind
+ * and at last the rule with the highest order.
+ */
+struct id_rule {
+    uint32_t surface_id;
+    int32_t priority;
+    uint32_t order;
+    char *app_id;
+    char *title;
+    enum id_rule_title title_kind;
+    regex_t title_regex;
+
+    /* set by id_rules_build */
+    uint32_t app_id_hash;
+    struct id_rule *next;
+};
+
+/* Rules indexed by the hash of their app_id, the chains are sorted by
+ * precedence */
+struct id_rules {
+    struct id_rule **buckets;
+    uint32_t num_buckets;
+    struct id_rule *any_app_id;
+};
+
+/* Walks the rules matching an app_id and a title in precedence order,
+ * without allocating memory */
+struct id_rules_iter {
+    const char *app_id;
+    const char *title;
+    uint32_t app_id_hash;
+    struct id_rule *by_app_id;
+    struct id_rule *any_app_id;
+};
+
+int
+id_rule_init(struct id_rule *rule, uint32_t surface_id, const char *app_id,
+             enum id_rule_title title_kind, const char *title);
+
+void
+id_rule_release(struct id_rule *rule);
+
+int
+id_rules_build(struct id_rules *rules, struct id_rule **rule_list,
+               uint32_t num_rules);
+
+void
+id_rules_release(struct id_rules *rules);
+
+void
+id_rules_iter_init(struct id_rules_iter *iter, const struct id_rules *rules,
+                   const char *app_id, const char *title);
+
+struct id_rule *
+id_rules_iter_next(struct id_rules_iter *iter);
+
+#endif /* IVI_ID_RULES_H */
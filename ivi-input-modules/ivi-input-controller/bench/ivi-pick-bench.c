@@ -0,0 +1,239 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and
+ * its documentation for any purpose is hereby granted without fee, provided
+ * that the above copyright notice appear in all copies and that both that
+ * copyright notice and this permission notice appear in supporting
+ * documentation, and that the name of the copyright holders not be used in
+ * advertising or publicity pertaining to distribution of the software
+ * without specific, written prior permission.  The copyright holders make
+ * no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS
+ * SOFTWARE, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS, IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER
+ * RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+ * CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/*
+ * Compares the pick grid of ivi-input-controller with the linear walk of
+ * weston_compositor_pick_view over the stacked views, for a growing number
+ * of views on a 1920x1080 screen. The linear walk only tests the bounding
+ * boxes here, weston also tests the input region of every view it passes.
+ *
+ * Every layout commit moves a few views and raises one of them to the top,
+ * the grid is patched for those views and compared with a rebuild of all
+ * views, the old behaviour after every repaint.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "ivi-pick-grid.h"
+
+#define SCREEN_WIDTH 1920
+#define SCREEN_HEIGHT 1080
+#define NUM_PICKS 200000
+#define NUM_COMMITS 2000
+#define MOVES_PER_COMMIT 4
+
+/* keeps the picks from being optimized away */
+static struct pick_grid_entry *volatile picked;
+
+static double
+now_usec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000.0 + ts.tv_nsec / 1000.0;
+}
+
+static void
+random_box(struct pick_grid_entry *box)
+{
+    int32_t width = 64 + rand() % 576;
+    int32_t height = 64 + rand() % 576;
+
+    box->x1 = rand() % (SCREEN_WIDTH - width / 2);
+    box->y1 = rand() % (SCREEN_HEIGHT - height / 2);
+    box->x2 = box->x1 + width;
+    box->y2 = box->y1 + height;
+}
+
+static int
+contains(const struct pick_grid_entry *box, int32_t x, int32_t y)
+{
+    return (x >= box->x1) && (x < box->x2) && (y >= box->y1) && (y < box->y2);
+}
+
+/* The views by rank, like the view list of the compositor */
+static struct pick_grid_entry *
+pick_linear(struct pick_grid_entry **stack, uint32_t num_views,
+            int32_t x, int32_t y)
+{
+    uint32_t i;
+
+    for (i = 0; i < num_views; i++) {
+        if (contains(stack[i], x, y))
+            return stack[i];
+    }
+
+    return NULL;
+}
+
+static struct pick_grid_entry *
+pick_grid(struct pick_grid *grid, int32_t x, int32_t y)
+{
+    const struct pick_grid_cell *cell = pick_grid_lookup(grid, x, y);
+    uint32_t i;
+
+    for (i = 0; i < cell->num_entries; i++) {
+        if (contains(cell->entries[i], x, y))
+            return cell->entries[i];
+    }
+
+    return NULL;
+}
+
+/* Places all views in the grid like a rebuild of the index */
+static int
+rebuild(struct pick_grid *grid, struct pick_grid_entry **stack,
+        uint32_t num_views)
+{
+    uint32_t i;
+
+    pick_grid_reset(grid, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+    for (i = 0; i < num_views; i++) {
+        if (pick_grid_place(grid, stack[i], stack[i]->x1, stack[i]->y1,
+                            stack[i]->x2, stack[i]->y2) < 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+static int
+run(uint32_t num_views)
+{
+    struct pick_grid_entry *views, **stack, *top, moved;
+    struct pick_grid grid;
+    double start, linear_usec, grid_usec, patch_usec, rebuild_usec;
+    int32_t *points;
+    uint32_t i, j, n, hits = 0;
+    int ret = -1;
+
+    views = calloc(num_views, sizeof *views);
+    stack = calloc(num_views, sizeof *stack);
+    points = calloc(NUM_PICKS * 2, sizeof *points);
+    if (!views || !stack || !points)
+        goto out;
+
+    pick_grid_init(&grid);
+    pick_grid_reset(&grid, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+    for (i = 0; i < num_views; i++) {
+        pick_grid_entry_init(&views[i]);
+        random_box(&views[i]);
+        pick_grid_set_rank(&grid, &views[i], i);
+        stack[i] = &views[i];
+        if (pick_grid_place(&grid, &views[i], views[i].x1, views[i].y1,
+                            views[i].x2, views[i].y2) < 0)
+            goto release;
+    }
+
+    for (i = 0; i < NUM_PICKS; i++) {
+        points[i * 2] = rand() % SCREEN_WIDTH;
+        points[i * 2 + 1] = rand() % SCREEN_HEIGHT;
+    }
+
+    /* both return the same view */
+    for (i = 0; i < NUM_PICKS; i++) {
+        top = pick_linear(stack, num_views, points[i * 2], points[i * 2 + 1]);
+        if (top != pick_grid(&grid, points[i * 2], points[i * 2 + 1])) {
+            fprintf(stderr, "views: %u, the grid picked another view\n",
+                    num_views);
+            goto release;
+        }
+        hits += top != NULL;
+    }
+
+    start = now_usec();
+    for (i = 0; i < NUM_PICKS; i++)
+        picked = pick_linear(stack, num_views, points[i * 2], points[i * 2 + 1]);
+    linear_usec = now_usec() - start;
+
+    start = now_usec();
+    for (i = 0; i < NUM_PICKS; i++)
+        picked = pick_grid(&grid, points[i * 2], points[i * 2 + 1]);
+    grid_usec = now_usec() - start;
+
+    /* commits moving views and raising one, followed by one pick */
+    patch_usec = 0.0;
+    for (i = 0; i < NUM_COMMITS; i++) {
+        start = now_usec();
+        for (j = 0; j < MOVES_PER_COMMIT; j++) {
+            n = rand() % num_views;
+            random_box(&moved);
+            if (pick_grid_place(&grid, stack[n], moved.x1, moved.y1,
+                                moved.x2, moved.y2) < 0)
+                goto release;
+        }
+
+        n = rand() % num_views;
+        top = stack[n];
+        for (j = n; j > 0; j--) {
+            stack[j] = stack[j - 1];
+            pick_grid_set_rank(&grid, stack[j], j);
+        }
+        stack[0] = top;
+        pick_grid_set_rank(&grid, top, 0);
+        picked = pick_grid(&grid, top->x1, top->y1);
+        patch_usec += now_usec() - start;
+    }
+
+    rebuild_usec = 0.0;
+    for (i = 0; i < NUM_COMMITS; i++) {
+        start = now_usec();
+        if (rebuild(&grid, stack, num_views) < 0)
+            goto release;
+        picked = pick_grid(&grid, stack[0]->x1, stack[0]->y1);
+        rebuild_usec += now_usec() - start;
+    }
+
+    printf("%6u views  hits %3u%%  pick: linear %8.3f usec  grid %6.3f usec"
+           "  commit: patch %8.3f usec  rebuild %9.3f usec\n",
+           num_views, hits * 100 / NUM_PICKS,
+           linear_usec / NUM_PICKS, grid_usec / NUM_PICKS,
+           patch_usec / NUM_COMMITS, rebuild_usec / NUM_COMMITS);
+    ret = 0;
+
+release:
+    pick_grid_release(&grid);
+out:
+    free(points);
+    free(stack);
+    free(views);
+    return ret;
+}
+
+int
+main(void)
+{
+    static const uint32_t num_views[] = { 4, 16, 64, 256, 1024, 4096 };
+    uint32_t i;
+
+    srand(1);
+
+    for (i = 0; i < sizeof num_views / sizeof num_views[0]; i++) {
+        if (run(num_views[i]) < 0)
+            return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
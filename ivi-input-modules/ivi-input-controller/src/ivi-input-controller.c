@@ -32,10 +32,47 @@
 #include <unistd.h>
 
 #include <libweston/plugin-registry.h>
+#include <libweston/weston-log.h>
 #include "ilm_types.h"
 
 #include "ivi-input-server-protocol.h"
 #include "ivi-controller.h"
+#include "ivi-pick-grid.h"
+
+#define TOUCH_COALESCE_POINTS 16
+/* motion events are not held back longer than this for a surface which
+ * does not commit */
+#define TOUCH_COALESCE_MAX_HOLD_USEC 100000
+
+struct touch_motion {
+    int touch_id;
+    struct timespec time;
+    struct weston_coord_global pos;
+};
+
+/* Touch motion events of a seat held back for the focused surface, see
+ * ivi_input_touch_coalescing. There is at most one held back motion per
+ * touch point. */
+struct touch_coalesce {
+    struct ivisurface *surf;
+    struct weston_surface *west_surf;
+    struct wl_listener commit_listener;
+
+    struct touch_motion motion[TOUCH_COALESCE_POINTS];
+    int num_motion;
+
+    /* events were sent since the last frame */
+    bool frame_pending;
+    /* a frame was sent and the surface did not commit since */
+    bool busy;
+    struct timespec last_time;
+    struct timespec frame_time;
+
+    /* sends the held back motion events at TOUCH_COALESCE_MAX_HOLD_USEC
+     * when no frame or commit does it before */
+    struct wl_event_source *hold_timer;
+    bool hold_armed;
+};
 
 struct seat_ctx {
     struct input_context *input_ctx;
@@ -52,6 +89,21 @@ struct seat_ctx {
     struct ivisurface *forced_ptr_focus_surf;
     int32_t  forced_surf_enabled;
 
+    /* bit of the seat in ivisurface::accepted_seats, 0 if all bits
+     * are taken by other seats */
+    uint64_t seat_bit;
+
+    /* handle of the seat in the ivi_input protocol, 0 if none */
+    uint32_t handle;
+
+    /* wl_keyboard resources of this seat per client, see kbd_client_cache */
+    struct wl_list kbd_client_caches;
+
+    /* input_latency of the surfaces which got events, most recent first */
+    struct wl_list latency_list;
+
+    struct touch_coalesce touch_coalesce;
+
     struct wl_listener updated_caps_listener;
     struct wl_listener destroy_listener;
     struct wl_list seat_node;
@@ -63,9 +115,130 @@ struct seat_focus {
     struct wl_list link;
 };
 
+/* wl_keyboard resources of one client for the keyboard of a seat, in the
+ * order keyboard events are sent to them. The cache is rebuilt lazily
+ * after the client created a wl_keyboard or a cached resource was
+ * destroyed. */
+struct kbd_client_cache {
+    struct seat_ctx *seat_ctx;
+    struct wl_client *client;
+    struct weston_keyboard *keyboard;
+    bool valid;
+    struct wl_list resource_list;
+    struct wl_listener resource_created_listener;
+    struct wl_listener client_destroy_listener;
+    struct wl_list link;
+};
+
+struct kbd_resource {
+    struct kbd_client_cache *cache;
+    struct wl_resource *resource;
+    struct wl_listener destroy_listener;
+    struct wl_list link;
+};
+
+#define INPUT_LATENCY_STAGES 3
+#define INPUT_LATENCY_BUCKETS 16
+
+/* Latency of the input events of a seat sent to a surface. Events which
+ * arrive before the client commits are merged, the commit and present
+ * stages are measured from the oldest of them. */
+struct input_latency {
+    struct seat_ctx *seat_ctx;
+    struct ivisurface *surf;
+    struct weston_surface *west_surf;
+    uint32_t histogram[INPUT_LATENCY_STAGES][INPUT_LATENCY_BUCKETS];
+
+    bool input_pending;
+    struct timespec pending_input;
+    struct timespec pending_sent;
+
+    /* output the last commit is waiting to be presented on */
+    struct weston_output *frame_output;
+    struct timespec frame_input;
+
+    struct wl_listener commit_listener;
+    struct wl_listener frame_listener;
+    struct wl_listener output_destroy_listener;
+    struct wl_list link;
+};
+
+/* Open addressing hash map from a surface key to its ivisurface */
+struct surface_map_entry {
+    uintptr_t key;
+    struct ivisurface *surf;
+};
+
+struct surface_map {
+    struct surface_map_entry *entries;
+    uint32_t size;
+    uint32_t used;
+};
+
+struct pick_entry {
+    struct pick_grid_entry grid_entry;
+    struct pick_index *index;
+    struct weston_view *view;
+    uint32_t generation;
+    struct wl_listener view_destroy_listener;
+    struct wl_list link;
+};
+
+/* Grid over the outputs with the bounding boxes of the views, for picking
+ * the topmost view which takes input at a position. Layout commits of
+ * ivi-controller walk the layers of the compositor, they add and raise
+ * views, and place again the views which moved. Configured ivi surfaces
+ * place again their views and subsurface views, destroyed views leave the
+ * grid. Views moved outside of both, like subsurfaces of clients, are
+ * placed again at the next layout commit. */
+struct pick_index {
+    struct ivishell *shell;
+    struct pick_grid grid;
+    struct wl_list entry_list;
+    uint32_t generation;
+    uint32_t rank;
+
+    /* an entry is missing in the grid, picks fall back to the compositor
+     * until the next layout commit places all entries again */
+    bool failed;
+
+    struct wl_listener output_created_listener;
+    struct wl_listener output_destroyed_listener;
+    struct wl_listener output_moved_listener;
+    struct wl_listener output_resized_listener;
+    struct wl_listener layout_committed_listener;
+    struct wl_listener surface_configured_listener;
+};
+
+/* A seat handle is the index of its slot + 1 in the low bits and the
+ * generation of the slot in the high bits. The generation is incremented
+ * when the seat is destroyed, so a handle never names a later seat of the
+ * slot. A slot is not used again once its generations are exhausted. */
+#define SEAT_HANDLE_SLOT_BITS 12
+#define SEAT_HANDLE_SLOT_MASK ((1U << SEAT_HANDLE_SLOT_BITS) - 1)
+#define SEAT_HANDLE_GENERATIONS (1U << (32 - SEAT_HANDLE_SLOT_BITS))
+
+struct seat_slot {
+    struct seat_ctx *seat;
+    uint32_t generation;
+};
+
 struct input_context {
     struct wl_list resource_list;
     struct wl_list seat_list;
+    uint64_t seat_bits_used;
+
+    /* seat_slot by the low bits of the handle - 1 */
+    struct wl_array seats_by_handle;
+
+    /* ivisurfaces by main weston_surface and by ivi id */
+    struct surface_map surfaces_by_surf;
+    struct surface_map surfaces_by_id;
+
+    struct pick_index pick_index;
+
+    struct weston_log_scope *latency_scope;
+
     int successful_init_stage;
     struct ivishell *ivishell;
 
@@ -96,12 +269,158 @@ struct wl_keyboard_data {
     uint32_t serial;
 };
 
+#define SURFACE_MAP_MIN_SIZE 64
+
+/* marks an entry whose surface was removed, probing continues over it */
+static struct ivisurface surface_map_tombstone;
+
+static uint32_t
+surface_map_hash(uintptr_t key)
+{
+    uint64_t h = (uint64_t)key;
+
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return (uint32_t)h;
+}
+
+static struct surface_map_entry *
+surface_map_find(struct surface_map *map, uintptr_t key)
+{
+    struct surface_map_entry *entry;
+    uint32_t i;
+
+    if (map->size == 0)
+        return NULL;
+
+    for (i = surface_map_hash(key) & (map->size - 1);;
+         i = (i + 1) & (map->size - 1)) {
+        entry = &map->entries[i];
+        if (entry->surf == NULL)
+            return NULL;
+        if (entry->surf != &surface_map_tombstone && entry->key == key)
+            return entry;
+    }
+}
+
+static struct ivisurface *
+surface_map_lookup(struct surface_map *map, uintptr_t key)
+{
+    struct surface_map_entry *entry = surface_map_find(map, key);
+
+    return entry ? entry->surf : NULL;
+}
+
+static void
+surface_map_remove(struct surface_map *map, uintptr_t key)
+{
+    struct surface_map_entry *entry = surface_map_find(map, key);
+
+    if (entry)
+        entry->surf = &surface_map_tombstone;
+}
+
+static int
+surface_map_insert(struct surface_map *map, uintptr_t key,
+                   struct ivisurface *surf);
+
+static int
+surface_map_resize(struct surface_map *map, uint32_t size)
+{
+    struct surface_map old = *map;
+    uint32_t i;
+
+    map->entries = calloc(size, sizeof(*map->entries));
+    if (!map->entries) {
+        *map = old;
+        return -1;
+    }
+    map->size = size;
+    map->used = 0;
+
+    for (i = 0; i < old.size; i++) {
+        if (old.entries[i].surf && old.entries[i].surf != &surface_map_tombstone)
+            surface_map_insert(map, old.entries[i].key, old.entries[i].surf);
+    }
+    free(old.entries);
+
+    return 0;
+}
+
+/* Rehashes into a map with at most half of the entries used */
+static int
+surface_map_rehash(struct surface_map *map)
+{
+    uint32_t live = 0;
+    uint32_t size = SURFACE_MAP_MIN_SIZE;
+    uint32_t i;
+
+    for (i = 0; i < map->size; i++) {
+        if (map->entries[i].surf &&
+            map->entries[i].surf != &surface_map_tombstone)
+            live++;
+    }
+
+    while (size < (live + 1) * 2)
+        size *= 2;
+
+    return surface_map_resize(map, size);
+}
+
+static int
+surface_map_insert(struct surface_map *map, uintptr_t key,
+                   struct ivisurface *surf)
+{
+    struct surface_map_entry *entry;
+    uint32_t i;
+
+    entry = surface_map_find(map, key);
+    if (entry) {
+        entry->surf = surf;
+        return 0;
+    }
+
+    /* tombstones count as used, the map is rehashed before probing
+     * sequences get long */
+    if ((map->used + 1) * 4 > map->size * 3 && surface_map_rehash(map) < 0)
+        return -1;
+
+    for (i = surface_map_hash(key) & (map->size - 1);;
+         i = (i + 1) & (map->size - 1)) {
+        entry = &map->entries[i];
+        if (entry->surf == NULL) {
+            map->used++;
+            break;
+        }
+        if (entry->surf == &surface_map_tombstone)
+            break;
+    }
+
+    entry->key = key;
+    entry->surf = surf;
+    return 0;
+}
+
+static void
+surface_map_release(struct surface_map *map)
+{
+    free(map->entries);
+    map->entries = NULL;
+    map->size = 0;
+    map->used = 0;
+}
+
 static struct seat_focus *
 get_accepted_seat(struct ivisurface *surface, struct seat_ctx *seat_ctx)
 {
     struct seat_focus *st_focus;
     struct seat_focus *ret_focus = NULL;
 
+    /* the list only has to be searched if the seat is accepted */
+    if (seat_ctx->seat_bit && !(surface->accepted_seats & seat_ctx->seat_bit))
+        return NULL;
+
     wl_list_for_each(st_focus, &surface->accepted_seat_list, link) {
         if (st_focus->seat_ctx == seat_ctx) {
             ret_focus = st_focus;
@@ -126,6 +445,7 @@ add_accepted_seat(struct ivisurface *surface, struct seat_ctx *seat_ctx)
         if (NULL != st_focus) {
             st_focus->seat_ctx = seat_ctx;
             wl_list_insert(&surface->accepted_seat_list, &st_focus->link);
+            surface->accepted_seats |= seat_ctx->seat_bit;
             ret = 1;
        } else {
             weston_log("%s Failed to allocate memory for seat addition of surface %d",
@@ -152,6 +472,7 @@ remove_if_seat_accepted(struct ivisurface *surface, struct seat_ctx *seat_ctx)
         ret = 1;
         wl_list_remove(&st_focus->link);
         free(st_focus);
+        surface->accepted_seats &= ~seat_ctx->seat_bit;
 
     }
     return ret;
@@ -171,13 +492,42 @@ input_ctrl_get_seat_ctx(struct input_context *ctx, const char *nm_seat)
     return ret_ctx;
 }
 
+static struct seat_ctx *
+input_ctrl_get_seat_ctx_from_handle(struct input_context *ctx, uint32_t handle)
+{
+    struct seat_slot *slots = ctx->seats_by_handle.data;
+    uint32_t index = handle & SEAT_HANDLE_SLOT_MASK;
+
+    if ((0 == index) ||
+        (index > ctx->seats_by_handle.size / sizeof *slots) ||
+        (NULL == slots[index - 1].seat) ||
+        (slots[index - 1].seat->handle != handle))
+        return NULL;
+
+    return slots[index - 1].seat;
+}
+
+static void
+send_input_acceptance_to(struct wl_resource *resource, uint32_t surface_id,
+                         struct seat_ctx *ctx_seat, int32_t accepted)
+{
+    if (wl_resource_get_version(resource) >=
+            IVI_INPUT_INPUT_ACCEPTANCE_HANDLE_SINCE_VERSION)
+        ivi_input_send_input_acceptance_handle(resource, surface_id,
+                                               ctx_seat->handle, accepted);
+    else
+        ivi_input_send_input_acceptance(resource, surface_id,
+                                        ctx_seat->west_seat->seat_name,
+                                        accepted);
+}
+
 static void
-send_input_acceptance(struct input_context *ctx, uint32_t surface_id, const char *seat, int32_t accepted)
+send_input_acceptance(struct input_context *ctx, uint32_t surface_id,
+                      struct seat_ctx *ctx_seat, int32_t accepted)
 {
     struct wl_resource *resource;
     wl_resource_for_each(resource, &ctx->resource_list) {
-        ivi_input_send_input_acceptance(resource, surface_id, seat,
-                                        accepted);
+        send_input_acceptance_to(resource, surface_id, ctx_seat, accepted);
     }
 }
 
@@ -198,27 +548,63 @@ static struct ivisurface *
 input_ctrl_get_surf_ctx(struct input_context *ctx,
         struct ivi_layout_surface *lyt_surf)
 {
-    struct ivisurface *surf_ctx = NULL;
-    struct ivisurface *ret_ctx = NULL;
-    wl_list_for_each(surf_ctx, &ctx->ivishell->list_surface, link) {
-        if (lyt_surf == surf_ctx->layout_surface) {
-            ret_ctx = surf_ctx;
-            break;
-        }
-    }
-    return ret_ctx;
+    const struct ivi_layout_interface *lyt_if = ctx->ivishell->interface;
+    struct weston_surface *west_surf;
+
+    if (NULL == lyt_surf)
+        return NULL;
+
+    west_surf = lyt_if->surface_get_weston_surface(lyt_surf);
+    return surface_map_lookup(&ctx->surfaces_by_surf, (uintptr_t)west_surf);
 }
 
 
+static void
+input_ctrl_index_surf_id(struct input_context *ctx,
+        struct ivisurface *surf_ctx, uint32_t ivi_surf_id)
+{
+    struct ivisurface *prev_surf;
+
+    if (surf_ctx->input_key_id != IVI_INVALID_ID)
+        surface_map_remove(&ctx->surfaces_by_id, surf_ctx->input_key_id);
+    surf_ctx->input_key_id = IVI_INVALID_ID;
+
+    /* a surface which had this id before is not indexed anymore */
+    prev_surf = surface_map_lookup(&ctx->surfaces_by_id, ivi_surf_id);
+    if (NULL != prev_surf)
+        prev_surf->input_key_id = IVI_INVALID_ID;
+
+    if (surface_map_insert(&ctx->surfaces_by_id, ivi_surf_id, surf_ctx) == 0)
+        surf_ctx->input_key_id = ivi_surf_id;
+}
+
 static struct ivisurface *
 input_ctrl_get_surf_ctx_from_id(struct input_context *ctx,
         uint32_t ivi_surf_id)
 {
     const struct ivi_layout_interface *interface = ctx->ivishell->interface;
     struct ivi_layout_surface *lyt_surf;
+    struct ivisurface *surf_ctx;
+
+    /* the id of a surface can change, an entry is only used if it still
+     * matches. Otherwise the surface is looked up again and re-indexed */
+    surf_ctx = surface_map_lookup(&ctx->surfaces_by_id, ivi_surf_id);
+    if ((NULL != surf_ctx) && (surf_ctx->input_key_id == ivi_surf_id) &&
+        (interface->get_id_of_surface(surf_ctx->layout_surface) == ivi_surf_id))
+        return surf_ctx;
+
     lyt_surf = interface->get_surface_from_id(ivi_surf_id);
+    if (NULL != surf_ctx) {
+        surf_ctx->input_key_id = IVI_INVALID_ID;
+        surface_map_remove(&ctx->surfaces_by_id, ivi_surf_id);
+    }
+
+    surf_ctx = input_ctrl_get_surf_ctx(ctx, lyt_surf);
+    if (NULL == surf_ctx)
+        return NULL;
 
-    return input_ctrl_get_surf_ctx(ctx, lyt_surf);
+    input_ctrl_index_surf_id(ctx, surf_ctx, ivi_surf_id);
+    return surf_ctx;
 }
 
 
@@ -227,16 +613,381 @@ input_ctrl_get_surf_ctx_from_surf(struct input_context *ctx,
         struct weston_surface *west_surf)
 {
     struct weston_surface *main_surface;
-    struct ivi_layout_surface *layout_surf;
     struct ivisurface *surf_ctx = NULL;
-    const struct ivi_layout_interface *lyt_if = ctx->ivishell->interface;
     main_surface = weston_surface_get_main_surface(west_surf);
 
-    if (NULL != main_surface) {
-        layout_surf = lyt_if->get_surface(main_surface);
-        surf_ctx = input_ctrl_get_surf_ctx(ctx, layout_surf);
+    if (NULL != main_surface) {
+        surf_ctx = surface_map_lookup(&ctx->surfaces_by_surf,
+                                      (uintptr_t)main_surface);
+    }
+    return surf_ctx;
+}
+
+static void
+pick_index_handle_view_destroy(struct wl_listener *listener, void *data)
+{
+    struct pick_entry *entry =
+            wl_container_of(listener, entry, view_destroy_listener);
+
+    pick_grid_remove(&entry->index->grid, &entry->grid_entry);
+    wl_list_remove(&entry->view_destroy_listener.link);
+    wl_list_remove(&entry->link);
+    free(entry);
+}
+
+static struct pick_entry *
+pick_index_get_entry(struct weston_view *view)
+{
+    struct wl_listener *listener;
+    struct pick_entry *entry;
+
+    listener = wl_signal_get(&view->destroy_signal,
+                             pick_index_handle_view_destroy);
+    if (NULL == listener)
+        return NULL;
+
+    return wl_container_of(listener, entry, view_destroy_listener);
+}
+
+/* Returns the bounding box of a view which takes input, NULL otherwise */
+static pixman_box32_t *
+pick_index_view_box(struct weston_view *view)
+{
+    pixman_box32_t *box;
+
+    if (!weston_view_is_mapped(view))
+        return NULL;
+
+    weston_view_update_transform(view);
+    box = pixman_region32_extents(&view->transform.boundingbox);
+    if ((box->x1 >= box->x2) || (box->y1 >= box->y2))
+        return NULL;
+
+    return box;
+}
+
+static void
+pick_index_place(struct pick_index *index, struct pick_entry *entry,
+                 pixman_box32_t *box)
+{
+    if (pick_grid_place(&index->grid, &entry->grid_entry,
+                        box->x1, box->y1, box->x2, box->y2) < 0) {
+        weston_log("%s: Failed to allocate memory for pick index\n",
+                   __FUNCTION__);
+        index->failed = true;
+    }
+}
+
+/* Sets the grid to the area of the outputs and places all entries again */
+static void
+pick_index_update_area(struct pick_index *index)
+{
+    struct weston_output *output;
+    struct pick_entry *entry;
+    pixman_box32_t *extents;
+    pixman_box32_t area = { INT32_MAX, INT32_MAX, INT32_MIN, INT32_MIN };
+
+    wl_list_for_each(output, &index->shell->compositor->output_list, link) {
+        extents = pixman_region32_extents(&output->region);
+        if (extents->x1 < area.x1)
+            area.x1 = extents->x1;
+        if (extents->y1 < area.y1)
+            area.y1 = extents->y1;
+        if (extents->x2 > area.x2)
+            area.x2 = extents->x2;
+        if (extents->y2 > area.y2)
+            area.y2 = extents->y2;
+    }
+
+    if ((area.x1 >= area.x2) || (area.y1 >= area.y2)) {
+        area.x1 = 0;
+        area.y1 = 0;
+        area.x2 = 1;
+        area.y2 = 1;
+    }
+
+    pick_grid_reset(&index->grid, area.x1, area.y1,
+                    area.x2 - area.x1, area.y2 - area.y1);
+    index->failed = false;
+
+    wl_list_for_each(entry, &index->entry_list, link) {
+        pixman_box32_t box = {
+            entry->grid_entry.x1, entry->grid_entry.y1,
+            entry->grid_entry.x2, entry->grid_entry.y2
+        };
+
+        pick_index_place(index, entry, &box);
+    }
+}
+
+/* Adds or places again a view of the layers, the next one in stacking
+ * order */
+static void
+pick_index_sync_view(struct pick_index *index, struct weston_view *view)
+{
+    struct pick_entry *entry = pick_index_get_entry(view);
+    pixman_box32_t *box = pick_index_view_box(view);
+
+    /* left behind, the entry is removed after the walk */
+    if (NULL == box)
+        return;
+
+    if (NULL == entry) {
+        entry = calloc(1, sizeof *entry);
+        if (NULL == entry) {
+            weston_log("%s: Failed to allocate memory\n", __FUNCTION__);
+            index->failed = true;
+            return;
+        }
+
+        pick_grid_entry_init(&entry->grid_entry);
+        entry->index = index;
+        entry->view = view;
+        entry->view_destroy_listener.notify = pick_index_handle_view_destroy;
+        wl_signal_add(&view->destroy_signal, &entry->view_destroy_listener);
+        wl_list_insert(&index->entry_list, &entry->link);
+    }
+
+    entry->generation = index->generation;
+    pick_grid_set_rank(&index->grid, &entry->grid_entry, index->rank++);
+    pick_index_place(index, entry, box);
+}
+
+/* The view and the views of its subsurfaces in stacking order, like the
+ * view list of the compositor is built */
+static void
+pick_index_sync_view_tree(struct pick_index *index, struct weston_view *view)
+{
+    struct weston_subsurface *sub;
+    struct weston_view *child;
+
+    if (wl_list_empty(&view->surface->subsurface_list)) {
+        pick_index_sync_view(index, view);
+        return;
+    }
+
+    wl_list_for_each(sub, &view->surface->subsurface_list, parent_link) {
+        if (sub->surface == view->surface) {
+            pick_index_sync_view(index, view);
+            continue;
+        }
+
+        wl_list_for_each(child, &sub->surface->views, surface_link) {
+            if (child->geometry.parent == view)
+                pick_index_sync_view_tree(index, child);
+        }
+    }
+}
+
+static void
+pick_index_sync(struct pick_index *index)
+{
+    struct weston_layer *layer;
+    struct weston_view *view;
+    struct pick_entry *entry, *tmp;
+
+    if (index->failed)
+        pick_index_update_area(index);
+
+    index->generation++;
+    index->rank = 0;
+
+    wl_list_for_each(layer, &index->shell->compositor->layer_list, link) {
+        wl_list_for_each(view, &layer->view_list.link, layer_link.link)
+            pick_index_sync_view_tree(index, view);
+    }
+
+    wl_list_for_each_safe(entry, tmp, &index->entry_list, link) {
+        if (entry->generation != index->generation)
+            pick_index_handle_view_destroy(&entry->view_destroy_listener,
+                                           entry->view);
+    }
+}
+
+/* Places again the views of the surface and its subsurfaces in the grid,
+ * their stacking order is unchanged */
+static void
+pick_index_update_surface(struct pick_index *index,
+                          struct weston_surface *surface)
+{
+    struct weston_subsurface *sub;
+    struct weston_view *view;
+    struct pick_entry *entry;
+    pixman_box32_t *box;
+
+    wl_list_for_each(view, &surface->views, surface_link) {
+        entry = pick_index_get_entry(view);
+        if (NULL == entry)
+            continue;
+
+        box = pick_index_view_box(view);
+        if (NULL != box)
+            pick_index_place(index, entry, box);
+        else
+            pick_grid_remove(&index->grid, &entry->grid_entry);
+    }
+
+    wl_list_for_each(sub, &surface->subsurface_list, parent_link) {
+        if (sub->surface != surface)
+            pick_index_update_surface(index, sub->surface);
+    }
+}
+
+static void
+pick_index_handle_output_created(struct wl_listener *listener, void *data)
+{
+    struct pick_index *index =
+            wl_container_of(listener, index, output_created_listener);
+
+    pick_index_update_area(index);
+}
+
+static void
+pick_index_handle_output_destroyed(struct wl_listener *listener, void *data)
+{
+    struct pick_index *index =
+            wl_container_of(listener, index, output_destroyed_listener);
+
+    pick_index_update_area(index);
+}
+
+static void
+pick_index_handle_output_moved(struct wl_listener *listener, void *data)
+{
+    struct pick_index *index =
+            wl_container_of(listener, index, output_moved_listener);
+
+    pick_index_update_area(index);
+}
+
+static void
+pick_index_handle_output_resized(struct wl_listener *listener, void *data)
+{
+    struct pick_index *index =
+            wl_container_of(listener, index, output_resized_listener);
+
+    pick_index_update_area(index);
+}
+
+static void
+pick_index_handle_layout_committed(struct wl_listener *listener, void *data)
+{
+    struct pick_index *index =
+            wl_container_of(listener, index, layout_committed_listener);
+
+    pick_index_sync(index);
+}
+
+static void
+pick_index_handle_surface_configured(struct wl_listener *listener,
+                                     void *data)
+{
+    struct pick_index *index =
+            wl_container_of(listener, index, surface_configured_listener);
+    struct ivi_layout_surface *layout_surface = data;
+    struct weston_surface *surface;
+
+    surface = index->shell->interface->surface_get_weston_surface(
+            layout_surface);
+    if (NULL != surface)
+        pick_index_update_surface(index, surface);
+}
+
+static void
+pick_index_init(struct pick_index *index, struct ivishell *shell)
+{
+    struct weston_compositor *compositor = shell->compositor;
+
+    index->shell = shell;
+    pick_grid_init(&index->grid);
+    wl_list_init(&index->entry_list);
+
+    index->output_created_listener.notify = pick_index_handle_output_created;
+    wl_signal_add(&compositor->output_created_signal,
+                  &index->output_created_listener);
+    index->output_destroyed_listener.notify =
+            pick_index_handle_output_destroyed;
+    wl_signal_add(&compositor->output_destroyed_signal,
+                  &index->output_destroyed_listener);
+    index->output_moved_listener.notify = pick_index_handle_output_moved;
+    wl_signal_add(&compositor->output_moved_signal,
+                  &index->output_moved_listener);
+    index->output_resized_listener.notify = pick_index_handle_output_resized;
+    wl_signal_add(&compositor->output_resized_signal,
+                  &index->output_resized_listener);
+
+    index->layout_committed_listener.notify =
+            pick_index_handle_layout_committed;
+    wl_signal_add(&shell->layout_committed_signal,
+                  &index->layout_committed_listener);
+    index->surface_configured_listener.notify =
+            pick_index_handle_surface_configured;
+    shell->interface->add_listener_configure_surface(
+            &index->surface_configured_listener);
+
+    pick_index_update_area(index);
+    pick_index_sync(index);
+}
+
+static void
+pick_index_release(struct pick_index *index)
+{
+    struct pick_entry *entry, *tmp;
+
+    wl_list_for_each_safe(entry, tmp, &index->entry_list, link)
+        pick_index_handle_view_destroy(&entry->view_destroy_listener,
+                                       entry->view);
+
+    wl_list_remove(&index->output_created_listener.link);
+    wl_list_remove(&index->output_destroyed_listener.link);
+    wl_list_remove(&index->output_moved_listener.link);
+    wl_list_remove(&index->output_resized_listener.link);
+    wl_list_remove(&index->layout_committed_listener.link);
+    wl_list_remove(&index->surface_configured_listener.link);
+    pick_grid_release(&index->grid);
+}
+
+/* Returns the topmost view at the position which takes input from the
+ * seat. Views of ivi surfaces which do not accept the seat are skipped,
+ * views of other surfaces take input from all seats. */
+static struct weston_view *
+input_ctrl_pick_view(struct seat_ctx *ctx_seat, struct weston_coord_global pos)
+{
+    struct input_context *ctx = ctx_seat->input_ctx;
+    struct pick_index *index = &ctx->pick_index;
+    struct weston_view *view;
+    struct ivisurface *surf_ctx;
+    const struct pick_grid_cell *cell;
+    struct pick_entry *entry;
+    int32_t x = (int32_t)pos.c.x;
+    int32_t y = (int32_t)pos.c.y;
+    uint32_t i;
+
+    /* round towards negative infinity like pixman does */
+    if (pos.c.x < x)
+        x--;
+    if (pos.c.y < y)
+        y--;
+
+    if (index->failed)
+        return weston_compositor_pick_view(ctx->ivishell->compositor, pos);
+
+    /* positions outside of the outputs are in the border cells, which
+     * hold the views reaching outside too */
+    cell = pick_grid_lookup(&index->grid, x, y);
+    for (i = 0; i < cell->num_entries; i++) {
+        entry = wl_container_of(cell->entries[i], entry, grid_entry);
+        view = entry->view;
+        if (!weston_view_is_mapped(view) ||
+            !weston_view_takes_input_at_point(view, pos))
+            continue;
+
+        surf_ctx = input_ctrl_get_surf_ctx_from_surf(ctx, view->surface);
+        if ((NULL == surf_ctx) || (NULL != get_accepted_seat(surf_ctx, ctx_seat)))
+            return view;
     }
-    return surf_ctx;
+
+    return NULL;
 }
 
 static void
@@ -290,6 +1041,129 @@ input_ctrl_kbd_snd_event_resource(struct seat_ctx *ctx_seat,
 }
 
 
+static void
+kbd_cache_invalidate(struct kbd_client_cache *cache)
+{
+    struct kbd_resource *kbd_res, *tmp;
+
+    wl_list_for_each_safe(kbd_res, tmp, &cache->resource_list, link) {
+        wl_list_remove(&kbd_res->destroy_listener.link);
+        wl_list_remove(&kbd_res->link);
+        free(kbd_res);
+    }
+    cache->valid = false;
+}
+
+static void
+kbd_cache_destroy(struct kbd_client_cache *cache)
+{
+    kbd_cache_invalidate(cache);
+    wl_list_remove(&cache->resource_created_listener.link);
+    wl_list_remove(&cache->client_destroy_listener.link);
+    wl_list_remove(&cache->link);
+    free(cache);
+}
+
+static void
+kbd_cache_handle_resource_destroy(struct wl_listener *listener, void *data)
+{
+    struct kbd_resource *kbd_res =
+            wl_container_of(listener, kbd_res, destroy_listener);
+
+    kbd_cache_invalidate(kbd_res->cache);
+}
+
+static void
+kbd_cache_handle_resource_created(struct wl_listener *listener, void *data)
+{
+    struct kbd_client_cache *cache =
+            wl_container_of(listener, cache, resource_created_listener);
+    struct wl_resource *resource = data;
+
+    if (!strcmp(wl_resource_get_class(resource), wl_keyboard_interface.name))
+        kbd_cache_invalidate(cache);
+}
+
+static void
+kbd_cache_handle_client_destroy(struct wl_listener *listener, void *data)
+{
+    struct kbd_client_cache *cache =
+            wl_container_of(listener, cache, client_destroy_listener);
+
+    kbd_cache_destroy(cache);
+}
+
+static int
+kbd_cache_add_resources(struct kbd_client_cache *cache,
+        struct wl_list *resource_list)
+{
+    struct wl_resource *resource;
+    struct kbd_resource *kbd_res;
+
+    wl_resource_for_each(resource, resource_list) {
+        if (wl_resource_get_client(resource) != cache->client)
+            continue;
+
+        kbd_res = calloc(1, sizeof *kbd_res);
+        if (NULL == kbd_res)
+            return -1;
+
+        kbd_res->cache = cache;
+        kbd_res->resource = resource;
+        kbd_res->destroy_listener.notify = kbd_cache_handle_resource_destroy;
+        wl_resource_add_destroy_listener(resource, &kbd_res->destroy_listener);
+        wl_list_insert(cache->resource_list.prev, &kbd_res->link);
+    }
+    return 0;
+}
+
+static struct kbd_client_cache *
+kbd_cache_get(struct seat_ctx *ctx_seat, struct weston_keyboard *keyboard,
+        struct wl_client *client)
+{
+    struct kbd_client_cache *cache;
+    bool found = false;
+
+    wl_list_for_each(cache, &ctx_seat->kbd_client_caches, link) {
+        if (cache->client == client) {
+            found = true;
+            break;
+        }
+    }
+
+    if (!found) {
+        cache = calloc(1, sizeof *cache);
+        if (NULL == cache)
+            return NULL;
+
+        cache->seat_ctx = ctx_seat;
+        cache->client = client;
+        wl_list_init(&cache->resource_list);
+        cache->resource_created_listener.notify =
+                kbd_cache_handle_resource_created;
+        wl_client_add_resource_created_listener(client,
+                &cache->resource_created_listener);
+        cache->client_destroy_listener.notify = kbd_cache_handle_client_destroy;
+        wl_client_add_destroy_listener(client,
+                &cache->client_destroy_listener);
+        wl_list_insert(&ctx_seat->kbd_client_caches, &cache->link);
+    }
+
+    if (cache->valid && cache->keyboard == keyboard)
+        return cache;
+
+    kbd_cache_invalidate(cache);
+    cache->keyboard = keyboard;
+    if ((kbd_cache_add_resources(cache, &keyboard->focus_resource_list) < 0) ||
+        (kbd_cache_add_resources(cache, &keyboard->resource_list) < 0)) {
+        kbd_cache_invalidate(cache);
+        return NULL;
+    }
+    cache->valid = true;
+
+    return cache;
+}
+
 static void
 input_ctrl_kbd_wl_snd_event(struct seat_ctx *ctx_seat,
         struct weston_surface *send_surf, struct weston_keyboard *keyboard,
@@ -299,8 +1173,21 @@ input_ctrl_kbd_wl_snd_event(struct seat_ctx *ctx_seat,
     struct wl_client *surface_client;
     struct wl_client *client;
     struct wl_list *resource_list;
+    struct kbd_client_cache *cache;
+    struct kbd_resource *kbd_res;
 
     surface_client = wl_resource_get_client(send_surf->resource);
+
+    cache = kbd_cache_get(ctx_seat, keyboard, surface_client);
+    if (NULL != cache) {
+        wl_list_for_each(kbd_res, &cache->resource_list, link) {
+            input_ctrl_kbd_snd_event_resource(ctx_seat, keyboard,
+                    kbd_res->resource, send_surf->resource, kbd_data);
+        }
+        return;
+    }
+
+    /* without memory for the cache, search the resources of the client */
     resource_list = &keyboard->focus_resource_list;
     wl_resource_for_each(resource, resource_list) {
         client = wl_resource_get_client(resource);
@@ -396,6 +1283,222 @@ input_ctrl_kbd_set_focus_surf(struct seat_ctx *ctx_seat,
     }
 }
 
+static const char *
+input_latency_stage_name(uint32_t stage)
+{
+    switch (stage) {
+    case IVI_INPUT_LATENCY_STAGE_DISPATCH:
+        return "dispatch";
+    case IVI_INPUT_LATENCY_STAGE_COMMIT:
+        return "commit";
+    default:
+        return "present";
+    }
+}
+
+static int64_t
+input_latency_usec(const struct timespec *end, const struct timespec *start)
+{
+    return (int64_t)(end->tv_sec - start->tv_sec) * 1000000 +
+           (end->tv_nsec - start->tv_nsec) / 1000;
+}
+
+static void
+input_latency_add(struct input_latency *latency, uint32_t stage,
+        const struct timespec *end, const struct timespec *start)
+{
+    struct input_context *ctx = latency->seat_ctx->input_ctx;
+    const struct ivi_layout_interface *interface = ctx->ivishell->interface;
+    int64_t usec = input_latency_usec(end, start);
+    uint32_t bucket = 0;
+
+    /* bucket 0 is below 128us, bucket n from 64us << n */
+    while ((bucket < INPUT_LATENCY_BUCKETS - 1) && (usec >= (128 << bucket)))
+        bucket++;
+    latency->histogram[stage][bucket]++;
+
+    if (weston_log_scope_is_enabled(ctx->latency_scope)) {
+        weston_log_scope_printf(ctx->latency_scope,
+                "seat %s surface %u %s %lld us\n",
+                latency->seat_ctx->west_seat->seat_name,
+                interface->get_id_of_surface(latency->surf->layout_surface),
+                input_latency_stage_name(stage), (long long)usec);
+    }
+}
+
+static void
+input_latency_detach_frame(struct input_latency *latency)
+{
+    if (NULL == latency->frame_output)
+        return;
+
+    wl_list_remove(&latency->frame_listener.link);
+    wl_list_remove(&latency->output_destroy_listener.link);
+    latency->frame_output = NULL;
+}
+
+static void
+input_latency_destroy(struct input_latency *latency)
+{
+    input_latency_detach_frame(latency);
+    wl_list_remove(&latency->commit_listener.link);
+    wl_list_remove(&latency->link);
+    free(latency);
+}
+
+static void
+input_latency_handle_frame(struct wl_listener *listener, void *data)
+{
+    struct input_latency *latency =
+            wl_container_of(listener, latency, frame_listener);
+
+    input_latency_add(latency, IVI_INPUT_LATENCY_STAGE_PRESENT,
+                      &latency->frame_output->frame_time,
+                      &latency->frame_input);
+    input_latency_detach_frame(latency);
+}
+
+static void
+input_latency_handle_output_destroy(struct wl_listener *listener, void *data)
+{
+    struct input_latency *latency =
+            wl_container_of(listener, latency, output_destroy_listener);
+
+    input_latency_detach_frame(latency);
+}
+
+static void
+input_latency_handle_commit(struct wl_listener *listener, void *data)
+{
+    struct input_latency *latency =
+            wl_container_of(listener, latency, commit_listener);
+    struct weston_compositor *compositor =
+            latency->seat_ctx->input_ctx->ivishell->compositor;
+    struct weston_output *output = latency->west_surf->output;
+    struct timespec now;
+
+    if (!latency->input_pending)
+        return;
+
+    latency->input_pending = false;
+    weston_compositor_read_presentation_clock(compositor, &now);
+    input_latency_add(latency, IVI_INPUT_LATENCY_STAGE_COMMIT, &now,
+                      &latency->pending_sent);
+
+    /* a commit which is not presented yet is superseded by this one */
+    input_latency_detach_frame(latency);
+    if (NULL == output)
+        return;
+
+    latency->frame_output = output;
+    latency->frame_input = latency->pending_input;
+    latency->frame_listener.notify = input_latency_handle_frame;
+    wl_signal_add(&output->frame_signal, &latency->frame_listener);
+    latency->output_destroy_listener.notify =
+            input_latency_handle_output_destroy;
+    wl_signal_add(&output->destroy_signal, &latency->output_destroy_listener);
+}
+
+static struct input_latency *
+input_latency_get(struct seat_ctx *ctx_seat, struct ivisurface *surf_ctx)
+{
+    const struct ivi_layout_interface *interface =
+            ctx_seat->input_ctx->ivishell->interface;
+    struct input_latency *latency;
+
+    wl_list_for_each(latency, &ctx_seat->latency_list, link) {
+        if (latency->surf == surf_ctx) {
+            /* keep the surfaces which get events at the front */
+            wl_list_remove(&latency->link);
+            wl_list_insert(&ctx_seat->latency_list, &latency->link);
+            return latency;
+        }
+    }
+
+    latency = calloc(1, sizeof *latency);
+    if (NULL == latency)
+        return NULL;
+
+    latency->seat_ctx = ctx_seat;
+    latency->surf = surf_ctx;
+    latency->west_surf =
+            interface->surface_get_weston_surface(surf_ctx->layout_surface);
+    latency->commit_listener.notify = input_latency_handle_commit;
+    wl_signal_add(&latency->west_surf->commit_signal,
+                  &latency->commit_listener);
+    wl_list_insert(&ctx_seat->latency_list, &latency->link);
+
+    return latency;
+}
+
+/* Records an input event with the given timestamp which was sent to the
+ * surface */
+static void
+input_ctrl_record_latency(struct seat_ctx *ctx_seat,
+        struct ivisurface *surf_ctx, const struct timespec *time)
+{
+    struct weston_compositor *compositor =
+            ctx_seat->input_ctx->ivishell->compositor;
+    struct input_latency *latency;
+    struct timespec now;
+
+    if ((NULL == surf_ctx) || (NULL == time))
+        return;
+
+    latency = input_latency_get(ctx_seat, surf_ctx);
+    if (NULL == latency)
+        return;
+
+    weston_compositor_read_presentation_clock(compositor, &now);
+    input_latency_add(latency, IVI_INPUT_LATENCY_STAGE_DISPATCH, &now, time);
+
+    if (!latency->input_pending) {
+        latency->input_pending = true;
+        latency->pending_input = *time;
+        latency->pending_sent = now;
+    }
+}
+
+static void
+input_ctrl_record_focus_latency(struct seat_ctx *ctx_seat,
+        struct weston_view *focus, const struct timespec *time)
+{
+    if (NULL != focus)
+        input_ctrl_record_latency(ctx_seat,
+                input_ctrl_get_surf_ctx_from_surf(ctx_seat->input_ctx,
+                                                  focus->surface),
+                time);
+}
+
+static void
+input_latency_scope_begin(struct weston_log_subscription *sub, void *data)
+{
+    struct input_context *ctx = data;
+    const struct ivi_layout_interface *interface = ctx->ivishell->interface;
+    struct input_latency *latency;
+    struct seat_ctx *ctx_seat;
+    uint32_t stage, bucket;
+
+    weston_log_subscription_printf(sub,
+            "histograms: bucket 0 < 128us, bucket n >= 64us << n\n");
+
+    wl_list_for_each(ctx_seat, &ctx->seat_list, seat_node) {
+        wl_list_for_each(latency, &ctx_seat->latency_list, link) {
+            for (stage = 0; stage < INPUT_LATENCY_STAGES; stage++) {
+                weston_log_subscription_printf(sub, "seat %s surface %u %s:",
+                        ctx_seat->west_seat->seat_name,
+                        interface->get_id_of_surface(
+                                latency->surf->layout_surface),
+                        input_latency_stage_name(stage));
+                for (bucket = 0; bucket < INPUT_LATENCY_BUCKETS; bucket++)
+                    weston_log_subscription_printf(sub, " %u",
+                            latency->histogram[stage][bucket]);
+                weston_log_subscription_printf(sub, "\n");
+            }
+        }
+    }
+}
+
 static void
 keyboard_grab_key(struct weston_keyboard_grab *grab, const struct timespec *time,
                   uint32_t key, uint32_t state)
@@ -426,6 +1529,7 @@ keyboard_grab_key(struct weston_keyboard_grab *grab, const struct timespec *time
 
         surface = interface->surface_get_weston_surface(surf_ctx->layout_surface);
         input_ctrl_kbd_wl_snd_event(seat_ctx, surface, grab->keyboard, &kbd_data);
+        input_ctrl_record_latency(seat_ctx, surf_ctx, time);
     }
 }
 
@@ -540,8 +1644,7 @@ input_ctrl_ptr_set_west_focus(struct seat_ctx *ctx_seat,
     struct seat_focus *st_focus;
 
     if (NULL == view) {
-        view = weston_compositor_pick_view(pointer->seat->compositor,
-                pointer->pos);
+        view = input_ctrl_pick_view(ctx_seat, pointer->pos);
     }
 
     if (pointer->focus != view) {
@@ -666,15 +1769,18 @@ pointer_grab_motion(struct weston_pointer_grab *grab, const struct timespec *tim
     /*Motion results in re-evaluation of pointer focus*/
     seat->forced_ptr_focus_surf = NULL;
     weston_pointer_send_motion(grab->pointer, time, event);
+    input_ctrl_record_focus_latency(seat, grab->pointer->focus, time);
 }
 
 static void
 pointer_grab_button(struct weston_pointer_grab *grab, const struct timespec *time,
                     uint32_t button, uint32_t state)
 {
+    struct seat_ctx *seat = wl_container_of(grab, seat, pointer_grab);
     struct weston_pointer *pointer = grab->pointer;
 
     weston_pointer_send_button(pointer, time, button, state);
+    input_ctrl_record_focus_latency(seat, pointer->focus, time);
 
     if (pointer->button_count == 0 &&
         state == WL_POINTER_BUTTON_STATE_RELEASED) {
@@ -687,7 +1793,10 @@ pointer_grab_axis(struct weston_pointer_grab *grab,
                   const struct timespec *time,
                   struct weston_pointer_axis_event *event)
 {
+    struct seat_ctx *seat = wl_container_of(grab, seat, pointer_grab);
+
     weston_pointer_send_axis(grab->pointer, time, event);
+    input_ctrl_record_focus_latency(seat, grab->pointer->focus, time);
 }
 
 static void
@@ -721,68 +1830,290 @@ static struct weston_pointer_grab_interface pointer_grab_interface = {
 };
 
 static void
-input_ctrl_touch_set_west_focus(struct seat_ctx *ctx_seat,
-        struct weston_touch *touch, const struct timespec *time,
-        int touch_id, struct weston_coord_global pos)
+input_ctrl_touch_set_west_focus(struct seat_ctx *ctx_seat,
+        struct weston_touch *touch, const struct timespec *time,
+        int touch_id, struct weston_coord_global pos)
+{
+    /*Weston would have set the focus here*/
+    struct ivisurface *surf_ctx;
+    struct seat_focus *st_focus;
+
+    if (touch->focus == NULL)
+        return;
+
+    surf_ctx = input_ctrl_get_surf_ctx_from_surf(ctx_seat->input_ctx,
+                            touch->focus->surface);
+
+    if (NULL != surf_ctx) {
+        if (touch->num_tp == 1) {
+            st_focus = input_ctrl_snd_focus_to_controller(surf_ctx, ctx_seat,
+                    ILM_INPUT_DEVICE_TOUCH, ILM_TRUE);
+        } else {
+            st_focus = get_accepted_seat(surf_ctx, ctx_seat);
+        }
+
+        if (st_focus != NULL) {
+            weston_touch_send_down(touch, time, touch_id, pos);
+
+        } else {
+            weston_touch_set_focus(touch, NULL);
+        }
+    } else {
+        /*Support non ivi-surfaces like input panel*/
+        weston_touch_send_down(touch, time, touch_id, pos);
+    }
+}
+
+/** Check if the touch has focused resources.
+ *
+ * \param touch The touch to check for focused resources.
+ * \return Whether or not this touch has focused resources
+ */
+static bool
+ivi_weston_touch_has_focus_resource(struct weston_touch *touch)
+{
+	if (!touch->focus)
+		return false;
+
+	if (wl_list_empty(&touch->focus_resource_list))
+		return false;
+
+	return true;
+}
+
+static void
+input_ctrl_touch_west_send_cancel(struct weston_touch *touch)
+{
+    struct wl_resource *resource;
+
+    if (!ivi_weston_touch_has_focus_resource(touch))
+        return;
+
+    wl_resource_for_each(resource, &touch->focus_resource_list)
+        wl_touch_send_cancel(resource);
+
+}
+
+static void
+touch_coalesce_detach(struct touch_coalesce *coalesce)
+{
+    if (NULL == coalesce->surf)
+        return;
+
+    wl_list_remove(&coalesce->commit_listener.link);
+    coalesce->surf = NULL;
+    coalesce->west_surf = NULL;
+    coalesce->busy = false;
+}
+
+static void
+touch_coalesce_disarm(struct touch_coalesce *coalesce)
+{
+    if (!coalesce->hold_armed)
+        return;
+
+    wl_event_source_timer_update(coalesce->hold_timer, 0);
+    coalesce->hold_armed = false;
+}
+
+static void
+touch_coalesce_drop(struct touch_coalesce *coalesce)
+{
+    if (NULL != coalesce->surf)
+        coalesce->surf->touch_dropped += coalesce->num_motion;
+    coalesce->num_motion = 0;
+    touch_coalesce_disarm(coalesce);
+}
+
+static bool
+touch_coalesce_has_focus(struct seat_ctx *ctx_seat)
+{
+    struct weston_touch *touch = ctx_seat->touch_grab.touch;
+
+    return (NULL != touch->focus) &&
+           (touch->focus->surface == ctx_seat->touch_coalesce.west_surf);
+}
+
+/* Sends the held back motion events, ahead of an event which has to keep
+ * its order relative to them */
+static void
+touch_coalesce_flush(struct seat_ctx *ctx_seat)
+{
+    struct touch_coalesce *coalesce = &ctx_seat->touch_coalesce;
+    struct weston_touch *touch = ctx_seat->touch_grab.touch;
+    int i;
+
+    if (0 == coalesce->num_motion)
+        return;
+
+    if (!touch_coalesce_has_focus(ctx_seat)) {
+        touch_coalesce_drop(coalesce);
+        return;
+    }
+
+    for (i = 0; i < coalesce->num_motion; i++) {
+        weston_touch_send_motion(touch, &coalesce->motion[i].time,
+                                 coalesce->motion[i].touch_id,
+                                 coalesce->motion[i].pos);
+        input_ctrl_record_latency(ctx_seat, coalesce->surf,
+                                  &coalesce->motion[i].time);
+    }
+    coalesce->num_motion = 0;
+    coalesce->frame_pending = true;
+    touch_coalesce_disarm(coalesce);
+}
+
+static void
+touch_coalesce_send_frame(struct seat_ctx *ctx_seat)
+{
+    struct touch_coalesce *coalesce = &ctx_seat->touch_coalesce;
+
+    weston_touch_send_frame(ctx_seat->touch_grab.touch);
+    coalesce->frame_pending = false;
+    coalesce->frame_time = coalesce->last_time;
+
+    if ((NULL != coalesce->surf) &&
+        (IVI_INPUT_TOUCH_COALESCING_COMMIT == coalesce->surf->touch_coalescing))
+        coalesce->busy = true;
+}
+
+static int
+touch_coalesce_handle_hold_timer(void *data)
+{
+    struct seat_ctx *ctx_seat = data;
+    struct touch_coalesce *coalesce = &ctx_seat->touch_coalesce;
+
+    coalesce->hold_armed = false;
+    if (0 == coalesce->num_motion)
+        return 0;
+
+    if (!touch_coalesce_has_focus(ctx_seat)) {
+        touch_coalesce_drop(coalesce);
+        return 0;
+    }
+
+    touch_coalesce_flush(ctx_seat);
+    touch_coalesce_send_frame(ctx_seat);
+    return 0;
+}
+
+/* Arms the timer for the rest of the hold time of the motion events held
+ * back since the last frame */
+static void
+touch_coalesce_arm(struct seat_ctx *ctx_seat)
 {
-    /*Weston would have set the focus here*/
-    struct ivisurface *surf_ctx;
-    struct seat_focus *st_focus;
+    struct touch_coalesce *coalesce = &ctx_seat->touch_coalesce;
+    struct wl_event_loop *loop;
+    int64_t held;
+    int msec;
 
-    if (touch->focus == NULL)
+    if (coalesce->hold_armed)
         return;
 
-    surf_ctx = input_ctrl_get_surf_ctx_from_surf(ctx_seat->input_ctx,
-                            touch->focus->surface);
-
-    if (NULL != surf_ctx) {
-        if (touch->num_tp == 1) {
-            st_focus = input_ctrl_snd_focus_to_controller(surf_ctx, ctx_seat,
-                    ILM_INPUT_DEVICE_TOUCH, ILM_TRUE);
-        } else {
-            st_focus = get_accepted_seat(surf_ctx, ctx_seat);
+    if (NULL == coalesce->hold_timer) {
+        loop = wl_display_get_event_loop(
+                ctx_seat->input_ctx->ivishell->compositor->wl_display);
+        coalesce->hold_timer = wl_event_loop_add_timer(loop,
+                touch_coalesce_handle_hold_timer, ctx_seat);
+        if (NULL == coalesce->hold_timer) {
+            weston_log("%s: Failed to create the touch hold timer\n",
+                       __FUNCTION__);
+            return;
         }
+    }
 
-        if (st_focus != NULL) {
-            weston_touch_send_down(touch, time, touch_id, pos);
+    held = input_latency_usec(&coalesce->last_time, &coalesce->frame_time);
+    msec = (int)((TOUCH_COALESCE_MAX_HOLD_USEC - held + 999) / 1000);
+    if (msec < 1)
+        msec = 1;
 
-        } else {
-            weston_touch_set_focus(touch, NULL);
-        }
-    } else {
-        /*Support non ivi-surfaces like input panel*/
-        weston_touch_send_down(touch, time, touch_id, pos);
+    wl_event_source_timer_update(coalesce->hold_timer, msec);
+    coalesce->hold_armed = true;
+}
+
+static void
+touch_coalesce_handle_commit(struct wl_listener *listener, void *data)
+{
+    struct touch_coalesce *coalesce =
+            wl_container_of(listener, coalesce, commit_listener);
+    struct seat_ctx *ctx_seat =
+            wl_container_of(coalesce, ctx_seat, touch_coalesce);
+
+    coalesce->busy = false;
+    if (0 == coalesce->num_motion)
+        return;
+
+    if (!touch_coalesce_has_focus(ctx_seat)) {
+        touch_coalesce_drop(coalesce);
+        return;
     }
+
+    touch_coalesce_flush(ctx_seat);
+    touch_coalesce_send_frame(ctx_seat);
 }
 
-/** Check if the touch has focused resources.
- *
- * \param touch The touch to check for focused resources.
- * \return Whether or not this touch has focused resources
- */
-static bool
-ivi_weston_touch_has_focus_resource(struct weston_touch *touch)
+/* Returns the focused surface if its touch motion events are coalesced.
+ * Motion events held back for a surface which lost the focus are
+ * dropped. */
+static struct ivisurface *
+touch_coalesce_focus(struct seat_ctx *ctx_seat)
 {
-	if (!touch->focus)
-		return false;
+    struct touch_coalesce *coalesce = &ctx_seat->touch_coalesce;
+    struct weston_touch *touch = ctx_seat->touch_grab.touch;
+    struct ivisurface *surf_ctx = NULL;
 
-	if (wl_list_empty(&touch->focus_resource_list))
-		return false;
+    if (NULL != touch->focus)
+        surf_ctx = input_ctrl_get_surf_ctx_from_surf(ctx_seat->input_ctx,
+                                                     touch->focus->surface);
 
-	return true;
+    if ((NULL != surf_ctx) &&
+        (IVI_INPUT_TOUCH_COALESCING_NONE == surf_ctx->touch_coalescing))
+        surf_ctx = NULL;
+
+    if (coalesce->surf == surf_ctx)
+        return surf_ctx;
+
+    touch_coalesce_drop(coalesce);
+    touch_coalesce_detach(coalesce);
+    if (NULL == surf_ctx)
+        return NULL;
+
+    coalesce->surf = surf_ctx;
+    coalesce->west_surf = touch->focus->surface;
+    coalesce->commit_listener.notify = touch_coalesce_handle_commit;
+    wl_signal_add(&coalesce->west_surf->commit_signal,
+                  &coalesce->commit_listener);
+
+    return surf_ctx;
 }
 
 static void
-input_ctrl_touch_west_send_cancel(struct weston_touch *touch)
+touch_coalesce_add_motion(struct seat_ctx *ctx_seat,
+        const struct timespec *time, int touch_id,
+        struct weston_coord_global pos)
 {
-    struct wl_resource *resource;
-
-    if (!ivi_weston_touch_has_focus_resource(touch))
-        return;
+    struct touch_coalesce *coalesce = &ctx_seat->touch_coalesce;
+    struct touch_motion *motion = NULL;
+    int i;
+
+    for (i = 0; i < coalesce->num_motion; i++) {
+        if (coalesce->motion[i].touch_id == touch_id) {
+            motion = &coalesce->motion[i];
+            coalesce->surf->touch_dropped++;
+            break;
+        }
+    }
 
-    wl_resource_for_each(resource, &touch->focus_resource_list)
-        wl_touch_send_cancel(resource);
+    if (NULL == motion) {
+        if (TOUCH_COALESCE_POINTS == coalesce->num_motion)
+            touch_coalesce_flush(ctx_seat);
+        motion = &coalesce->motion[coalesce->num_motion++];
+        motion->touch_id = touch_id;
+    }
 
+    motion->time = *time;
+    motion->pos = pos;
+    coalesce->last_time = *time;
 }
 
 static void
@@ -792,6 +2123,11 @@ input_ctrl_touch_clear_focus(struct seat_ctx *ctx_seat)
     struct weston_touch *touch = ctx_seat->touch_grab.touch;
     struct ivisurface *surf_ctx;
 
+    /* the held back motion events are cancelled together with the
+     * touch sequence */
+    touch_coalesce_drop(&ctx_seat->touch_coalesce);
+    ctx_seat->touch_coalesce.frame_pending = false;
+
     if (touch->focus != NULL) {
 
         surf_ctx = input_ctrl_get_surf_ctx_from_surf(ctx,
@@ -812,13 +2148,34 @@ touch_grab_down(struct weston_touch_grab *grab, const struct timespec *time,
 {
     struct seat_ctx *seat = wl_container_of(grab, seat, touch_grab);
     struct weston_coord_global pos;
+    struct weston_view *view;
 
     /* if touch device has no focused view, there is nothing to do*/
     if (grab->touch->focus == NULL)
         return;
 
+    /* weston focuses the topmost view, which may not accept the seat */
+    if (grab->touch->num_tp == 1) {
+        pos.c = weston_coord_from_fixed(x, y);
+        view = input_ctrl_pick_view(seat, pos);
+        if (view != grab->touch->focus)
+            weston_touch_set_focus(grab->touch, view);
+        if (NULL == view)
+            return;
+    }
+
+    if (NULL != touch_coalesce_focus(seat)) {
+        touch_coalesce_flush(seat);
+        /* a new touch sequence does not wait for a commit */
+        if (grab->touch->num_tp == 1)
+            seat->touch_coalesce.busy = false;
+        seat->touch_coalesce.frame_pending = true;
+        seat->touch_coalesce.last_time = *time;
+    }
+
     pos.c = weston_coord_from_fixed(x, y);
     input_ctrl_touch_set_west_focus(seat, grab->touch, time, touch_id, pos);
+    input_ctrl_record_focus_latency(seat, grab->touch->focus, time);
 }
 
 static void
@@ -831,6 +2188,12 @@ touch_grab_up(struct weston_touch_grab *grab, const struct timespec *time,
     struct ivisurface *surf_ctx;
 
     if (NULL != touch->focus) {
+        if (NULL != touch_coalesce_focus(seat)) {
+            touch_coalesce_flush(seat);
+            seat->touch_coalesce.frame_pending = true;
+            seat->touch_coalesce.last_time = *time;
+        }
+
         if (touch->num_tp == 0) {
             surf_ctx = input_ctrl_get_surf_ctx_from_surf(ctx,
                                     touch->focus->surface);
@@ -839,6 +2202,7 @@ touch_grab_up(struct weston_touch_grab *grab, const struct timespec *time,
                     seat, ILM_INPUT_DEVICE_TOUCH, ILM_FALSE);
         }
         weston_touch_send_up(touch, time, touch_id);
+        input_ctrl_record_focus_latency(seat, touch->focus, time);
     }
 }
 
@@ -846,16 +2210,40 @@ static void
 touch_grab_motion(struct weston_touch_grab *grab, const struct timespec *time, int touch_id,
                   wl_fixed_t x, wl_fixed_t y)
 {
+    struct seat_ctx *seat = wl_container_of(grab, seat, touch_grab);
     struct weston_coord_global pos;
 
     pos.c = weston_coord_from_fixed(x, y);
+    if (NULL != touch_coalesce_focus(seat)) {
+        touch_coalesce_add_motion(seat, time, touch_id, pos);
+        return;
+    }
+
     weston_touch_send_motion(grab->touch, time, touch_id, pos);
+    input_ctrl_record_focus_latency(seat, grab->touch->focus, time);
 }
 
 static void
 touch_grab_frame(struct weston_touch_grab *grab)
 {
-    weston_touch_send_frame(grab->touch);
+    struct seat_ctx *seat = wl_container_of(grab, seat, touch_grab);
+    struct touch_coalesce *coalesce = &seat->touch_coalesce;
+
+    if (coalesce->num_motion > 0) {
+        /* only motion events since the last frame, they wait for the
+         * surface to commit */
+        if (coalesce->busy && !coalesce->frame_pending &&
+            (input_latency_usec(&coalesce->last_time, &coalesce->frame_time)
+                    < TOUCH_COALESCE_MAX_HOLD_USEC)) {
+            touch_coalesce_arm(seat);
+            return;
+        }
+
+        /* in frame mode, the frame ends the coalescing */
+        touch_coalesce_flush(seat);
+    }
+
+    touch_coalesce_send_frame(seat);
 }
 
 static void
@@ -890,6 +2278,20 @@ get_seat_capabilities(struct weston_seat *seat)
     return caps;
 }
 
+static void
+send_seat_created(struct wl_resource *resource, struct seat_ctx *ctx_seat,
+                  int32_t is_default_seat)
+{
+    struct weston_seat *seat = ctx_seat->west_seat;
+
+    ivi_input_send_seat_created(resource, seat->seat_name,
+                                get_seat_capabilities(seat), is_default_seat);
+    if (wl_resource_get_version(resource) >=
+            IVI_INPUT_SEAT_HANDLE_SINCE_VERSION)
+        ivi_input_send_seat_handle(resource, seat->seat_name,
+                                   ctx_seat->handle);
+}
+
 static void
 handle_seat_updated_caps(struct wl_listener *listener, void *data)
 {
@@ -935,6 +2337,9 @@ destroy_seat(struct seat_ctx *ctx_seat)
 {
     struct ivisurface *surf;
     struct wl_resource *resource;
+    struct kbd_client_cache *cache, *tmp_cache;
+    struct input_latency *latency, *tmp_latency;
+    struct seat_slot *slot;
 
     /* Remove seat acceptance from surfaces which have input acceptance from
      * this seat */
@@ -947,9 +2352,29 @@ destroy_seat(struct seat_ctx *ctx_seat)
         ivi_input_send_seat_destroyed(resource,
                                       ctx_seat->west_seat->seat_name);
     }
+    wl_list_for_each_safe(cache, tmp_cache, &ctx_seat->kbd_client_caches,
+                          link) {
+        kbd_cache_destroy(cache);
+    }
+
+    wl_list_for_each_safe(latency, tmp_latency, &ctx_seat->latency_list,
+                          link) {
+        input_latency_destroy(latency);
+    }
+    touch_coalesce_detach(&ctx_seat->touch_coalesce);
+    if (NULL != ctx_seat->touch_coalesce.hold_timer)
+        wl_event_source_remove(ctx_seat->touch_coalesce.hold_timer);
+
     wl_list_remove(&ctx_seat->destroy_listener.link);
     wl_list_remove(&ctx_seat->updated_caps_listener.link);
     wl_list_remove(&ctx_seat->seat_node);
+    ctx_seat->input_ctx->seat_bits_used &= ~ctx_seat->seat_bit;
+    if (0 != ctx_seat->handle) {
+        slot = (struct seat_slot *)ctx_seat->input_ctx->seats_by_handle.data +
+               (ctx_seat->handle & SEAT_HANDLE_SLOT_MASK) - 1;
+        slot->seat = NULL;
+        slot->generation++;
+    }
     free(ctx_seat);
 }
 
@@ -971,6 +2396,7 @@ handle_seat_create(struct wl_listener *listener, void *data)
     const struct ivi_layout_interface *interface =
         input_ctx->ivishell->interface;
     int32_t is_default_seat = ILM_FALSE;
+    struct seat_slot *handle_slot = NULL, *slot;
     struct seat_ctx *ctx = calloc(1, sizeof *ctx);
     if (ctx == NULL) {
         weston_log("%s: Failed to allocate memory\n", __FUNCTION__);
@@ -979,6 +2405,43 @@ handle_seat_create(struct wl_listener *listener, void *data)
 
     ctx->input_ctx = input_ctx;
     ctx->west_seat = seat;
+    wl_list_init(&ctx->kbd_client_caches);
+    wl_list_init(&ctx->latency_list);
+
+    /* seats beyond the width of the bitset fall back to searching the
+     * accepted seat list of the surfaces */
+    if (~input_ctx->seat_bits_used) {
+        ctx->seat_bit = ~input_ctx->seat_bits_used &
+                        (input_ctx->seat_bits_used + 1);
+        input_ctx->seat_bits_used |= ctx->seat_bit;
+    }
+
+    wl_array_for_each(slot, &input_ctx->seats_by_handle) {
+        if ((NULL == slot->seat) &&
+            (slot->generation < SEAT_HANDLE_GENERATIONS)) {
+            handle_slot = slot;
+            break;
+        }
+    }
+
+    if ((NULL == handle_slot) &&
+        (input_ctx->seats_by_handle.size / sizeof *handle_slot <
+         SEAT_HANDLE_SLOT_MASK)) {
+        handle_slot = wl_array_add(&input_ctx->seats_by_handle,
+                                   sizeof *handle_slot);
+        if (NULL != handle_slot)
+            handle_slot->generation = 0;
+    }
+
+    if (NULL != handle_slot) {
+        handle_slot->seat = ctx;
+        ctx->handle = (handle_slot->generation << SEAT_HANDLE_SLOT_BITS) |
+                      (handle_slot -
+                       (struct seat_slot *)input_ctx->seats_by_handle.data + 1);
+    } else {
+        weston_log("%s: Failed to allocate a handle for seat %s\n",
+                   __FUNCTION__, seat->seat_name);
+    }
 
     ctx->keyboard_grab.interface = &keyboard_grab_interface;
     ctx->pointer_grab.interface = &pointer_grab_interface;
@@ -994,9 +2457,7 @@ handle_seat_create(struct wl_listener *listener, void *data)
     is_default_seat = (strcmp(input_ctx->seat_default_name, seat->seat_name))
                         ? ILM_FALSE : ILM_TRUE;
     wl_resource_for_each(resource, &input_ctx->resource_list) {
-        ivi_input_send_seat_created(resource,
-                                    seat->seat_name,
-                                    get_seat_capabilities(seat), is_default_seat);
+        send_seat_created(resource, ctx, is_default_seat);
     }
 
     /* If default seat is created, we have to add it to the accepted_seat_list
@@ -1006,7 +2467,7 @@ handle_seat_create(struct wl_listener *listener, void *data)
             add_accepted_seat(surf, ctx);
             send_input_acceptance(input_ctx,
                                  interface->get_id_of_surface(surf->layout_surface),
-                                 input_ctx->seat_default_name, ILM_TRUE);
+                                 ctx, ILM_TRUE);
         }
     }
 }
@@ -1017,6 +2478,21 @@ input_ctrl_free_surf_ctx(struct input_context *ctx, struct ivisurface *surf_ctx)
     struct seat_ctx *seat_ctx;
     struct seat_focus *st_focus;
     struct seat_focus *tmp_st_focus;
+    struct input_latency *latency, *tmp_latency;
+
+    wl_list_for_each(seat_ctx, &ctx->seat_list, seat_node) {
+        wl_list_for_each_safe(latency, tmp_latency, &seat_ctx->latency_list,
+                              link) {
+            if (latency->surf == surf_ctx)
+                input_latency_destroy(latency);
+        }
+
+        if (seat_ctx->touch_coalesce.surf == surf_ctx) {
+            seat_ctx->touch_coalesce.num_motion = 0;
+            touch_coalesce_disarm(&seat_ctx->touch_coalesce);
+            touch_coalesce_detach(&seat_ctx->touch_coalesce);
+        }
+    }
 
     wl_list_for_each_safe(st_focus, tmp_st_focus,
             &surf_ctx->accepted_seat_list, link) {
@@ -1028,6 +2504,15 @@ input_ctrl_free_surf_ctx(struct input_context *ctx, struct ivisurface *surf_ctx)
         wl_list_remove(&st_focus->link);
         free(st_focus);
     }
+    surf_ctx->accepted_seats = 0;
+
+    if (NULL != surf_ctx->input_key_surface)
+        surface_map_remove(&ctx->surfaces_by_surf,
+                           (uintptr_t)surf_ctx->input_key_surface);
+    if (surf_ctx->input_key_id != IVI_INVALID_ID)
+        surface_map_remove(&ctx->surfaces_by_id, surf_ctx->input_key_id);
+    surf_ctx->input_key_surface = NULL;
+    surf_ctx->input_key_id = IVI_INVALID_ID;
 }
 
 static void
@@ -1050,15 +2535,33 @@ handle_surface_create(struct wl_listener *listener, void *data)
     const struct ivi_layout_interface *interface =
         input_ctx->ivishell->interface;
     struct seat_ctx *seat_ctx;
+    uint32_t id;
 
     wl_list_init(&ivisurface->accepted_seat_list);
+    ivisurface->accepted_seats = 0;
+
+    ivisurface->input_key_surface =
+        interface->surface_get_weston_surface(ivisurface->layout_surface);
+    if (surface_map_insert(&input_ctx->surfaces_by_surf,
+                           (uintptr_t)ivisurface->input_key_surface,
+                           ivisurface) < 0) {
+        weston_log("%s: Failed to allocate memory for surface index\n",
+                   __FUNCTION__);
+        ivisurface->input_key_surface = NULL;
+    }
+
+    /* surfaces without id yet are indexed when they are looked up by id */
+    ivisurface->input_key_id = IVI_INVALID_ID;
+    id = interface->get_id_of_surface(ivisurface->layout_surface);
+    if (id != IVI_INVALID_ID)
+        input_ctrl_index_surf_id(input_ctx, ivisurface, id);
 
     seat_ctx = input_ctrl_get_seat_ctx(input_ctx, input_ctx->seat_default_name);
     if (seat_ctx) {
         add_accepted_seat(ivisurface, seat_ctx);
         send_input_acceptance(input_ctx,
                               interface->get_id_of_surface(ivisurface->layout_surface),
-                              input_ctx->seat_default_name, ILM_TRUE);
+                              seat_ctx, ILM_TRUE);
     }
 }
 
@@ -1110,11 +2613,10 @@ input_set_input_focus(struct wl_client *client,
 
 static void
 setup_input_acceptance(struct input_context *ctx,
-                       uint32_t surface, const char *seat,
+                       uint32_t surface, struct seat_ctx *ctx_seat,
                        int32_t accepted)
 {
     struct ivisurface *ivisurface;
-    struct seat_ctx *ctx_seat;
     struct weston_surface *w_surf;
     int found_seat = 0;
     const struct ivi_layout_interface *interface =
@@ -1124,13 +2626,6 @@ setup_input_acceptance(struct input_context *ctx,
     struct weston_keyboard *keyboard;
     struct seat_focus *st_focus;
 
-    ctx_seat = input_ctrl_get_seat_ctx(ctx, seat);
-
-    if (NULL == ctx_seat) {
-        weston_log("%s: seat: %s was not found\n", __FUNCTION__, seat);
-        return;
-    }
-
     ivisurface = input_ctrl_get_surf_ctx_from_id(ctx, surface);
 
     if (NULL != ivisurface) {
@@ -1183,7 +2678,7 @@ setup_input_acceptance(struct input_context *ctx,
     }
 
     if (found_seat)
-        send_input_acceptance(ctx, surface, seat, accepted);
+        send_input_acceptance(ctx, surface, ctx_seat, accepted);
 }
 
 static void
@@ -1193,12 +2688,318 @@ input_set_input_acceptance(struct wl_client *client,
                                       int32_t accepted)
 {
     struct input_context *ctx = wl_resource_get_user_data(resource);
-    setup_input_acceptance(ctx, surface, seat, accepted);
+    struct seat_ctx *ctx_seat = input_ctrl_get_seat_ctx(ctx, seat);
+
+    if (NULL == ctx_seat) {
+        weston_log("%s: seat: %s was not found\n", __FUNCTION__, seat);
+        return;
+    }
+
+    setup_input_acceptance(ctx, surface, ctx_seat, accepted);
+}
+
+static void
+input_set_input_acceptance_handle(struct wl_client *client,
+                                  struct wl_resource *resource,
+                                  uint32_t surface, uint32_t seat,
+                                  int32_t accepted)
+{
+    struct input_context *ctx = wl_resource_get_user_data(resource);
+    struct seat_ctx *ctx_seat = input_ctrl_get_seat_ctx_from_handle(ctx, seat);
+
+    if (NULL == ctx_seat) {
+        weston_log("%s: seat handle %u was not found\n", __FUNCTION__, seat);
+        return;
+    }
+
+    setup_input_acceptance(ctx, surface, ctx_seat, accepted);
+}
+
+#define INPUT_BATCH_MAX_SEATS 32
+
+struct input_batch_entry {
+    uint32_t surface;
+    uint32_t flags;
+    uint32_t seats;
+    uint32_t focus_mask;
+    uint32_t focus;
+};
+
+static int
+input_batch_get_seats(struct input_context *ctx, struct wl_array *handles,
+        struct seat_ctx *seats[INPUT_BATCH_MAX_SEATS])
+{
+    uint32_t *handle;
+    int num_seats = 0;
+
+    if (handles->size % sizeof *handle) {
+        weston_log("%s: invalid size of seats\n", __FUNCTION__);
+        return -1;
+    }
+
+    if (handles->size / sizeof *handle > INPUT_BATCH_MAX_SEATS) {
+        weston_log("%s: more than %d seats\n", __FUNCTION__,
+                   INPUT_BATCH_MAX_SEATS);
+        return -1;
+    }
+
+    wl_array_for_each(handle, handles) {
+        seats[num_seats] = input_ctrl_get_seat_ctx_from_handle(ctx, *handle);
+        if (NULL == seats[num_seats]) {
+            weston_log("%s: seat handle %u was not found\n", __FUNCTION__,
+                       *handle);
+            return -1;
+        }
+
+        num_seats++;
+    }
+
+    return num_seats;
+}
+
+static void
+input_batch_set_acceptance(struct input_context *ctx,
+        struct input_batch_entry *entry, struct seat_ctx **seats,
+        int num_seats)
+{
+    struct ivisurface *surf = input_ctrl_get_surf_ctx_from_id(ctx,
+                                                              entry->surface);
+    struct seat_focus *st_focus, *tmp_st_focus;
+    struct seat_ctx *ctx_seat;
+    bool in_batch;
+    int i;
+
+    wl_list_for_each_safe(st_focus, tmp_st_focus, &surf->accepted_seat_list,
+                          link) {
+        ctx_seat = st_focus->seat_ctx;
+        in_batch = false;
+        for (i = 0; i < num_seats; i++) {
+            if ((seats[i] == ctx_seat) && (entry->seats & (1U << i)))
+                in_batch = true;
+        }
+
+        if (!in_batch)
+            setup_input_acceptance(ctx, entry->surface, ctx_seat, ILM_FALSE);
+    }
+
+    for (i = 0; i < num_seats; i++) {
+        if ((entry->seats & (1U << i)) &&
+            (NULL == get_accepted_seat(surf, seats[i])))
+            setup_input_acceptance(ctx, entry->surface, seats[i], ILM_TRUE);
+    }
+}
+
+static void
+input_set_input_batch(struct wl_client *client,
+                      struct wl_resource *resource,
+                      struct wl_array *seat_handles,
+                      struct wl_array *entries)
+{
+    struct input_context *ctx = wl_resource_get_user_data(resource);
+    struct seat_ctx *seats[INPUT_BATCH_MAX_SEATS];
+    struct input_batch_entry *entry, *other;
+    uint32_t exclusive_focus = 0;
+    uint32_t device;
+    int num_seats;
+
+    num_seats = input_batch_get_seats(ctx, seat_handles, seats);
+    if (num_seats < 0) {
+        ivi_input_send_input_batch_failed(resource);
+        return;
+    }
+
+    if (entries->size % sizeof *entry) {
+        weston_log("%s: invalid size of entries\n", __FUNCTION__);
+        ivi_input_send_input_batch_failed(resource);
+        return;
+    }
+
+    /* nothing is applied if any entry is invalid */
+    wl_array_for_each(entry, entries) {
+        if (NULL == input_ctrl_get_surf_ctx_from_id(ctx, entry->surface)) {
+            weston_log("%s: surface %d was not found\n", __FUNCTION__,
+                       entry->surface);
+            ivi_input_send_input_batch_failed(resource);
+            return;
+        }
+
+        for (other = entries->data; other < entry; other++) {
+            if (other->surface == entry->surface) {
+                weston_log("%s: surface %d has more than one entry\n",
+                           __FUNCTION__, entry->surface);
+                ivi_input_send_input_batch_failed(resource);
+                return;
+            }
+        }
+
+        if ((num_seats < INPUT_BATCH_MAX_SEATS) &&
+            (entry->seats >> num_seats)) {
+            weston_log("%s: surface %d accepts unnamed seats\n",
+                       __FUNCTION__, entry->surface);
+            ivi_input_send_input_batch_failed(resource);
+            return;
+        }
+
+        device = entry->focus_mask & entry->focus &
+                 (ILM_INPUT_DEVICE_POINTER | ILM_INPUT_DEVICE_TOUCH);
+        if (exclusive_focus & device) {
+            weston_log("%s: pointer or touch focus set on more than one "
+                       "surface\n", __FUNCTION__);
+            ivi_input_send_input_batch_failed(resource);
+            return;
+        }
+        exclusive_focus |= device;
+    }
+
+    wl_array_for_each(entry, entries) {
+        if (entry->flags & IVI_INPUT_INPUT_BATCH_FLAGS_SET_ACCEPTANCE)
+            input_batch_set_acceptance(ctx, entry, seats, num_seats);
+    }
+
+    wl_array_for_each(entry, entries) {
+        device = entry->focus_mask & ~entry->focus;
+        if (device)
+            setup_input_focus(ctx, entry->surface, device, ILM_FALSE);
+    }
+
+    wl_array_for_each(entry, entries) {
+        device = entry->focus_mask & entry->focus;
+        if (device)
+            setup_input_focus(ctx, entry->surface, device, ILM_TRUE);
+    }
+}
+
+static void
+input_get_latency_stats(struct wl_client *client,
+                        struct wl_resource *resource,
+                        uint32_t seat, uint32_t surface)
+{
+    struct input_context *ctx = wl_resource_get_user_data(resource);
+    const struct ivi_layout_interface *interface = ctx->ivishell->interface;
+    struct input_latency *latency;
+    struct seat_ctx *ctx_seat;
+    struct wl_array histogram;
+    uint32_t *buckets;
+    uint32_t stage;
+
+    ctx_seat = input_ctrl_get_seat_ctx_from_handle(ctx, seat);
+    if (NULL == ctx_seat)
+        return;
+
+    wl_array_init(&histogram);
+    buckets = wl_array_add(&histogram, INPUT_LATENCY_BUCKETS * sizeof(uint32_t));
+    if (NULL == buckets) {
+        wl_resource_post_no_memory(resource);
+        return;
+    }
+
+    for (stage = 0; stage < INPUT_LATENCY_STAGES; stage++) {
+        memset(buckets, 0, histogram.size);
+        wl_list_for_each(latency, &ctx_seat->latency_list, link) {
+            if (interface->get_id_of_surface(latency->surf->layout_surface)
+                    == surface) {
+                memcpy(buckets, latency->histogram[stage], histogram.size);
+                break;
+            }
+        }
+        ivi_input_send_latency_histogram(resource, seat, surface, stage,
+                                         &histogram);
+    }
+
+    wl_array_release(&histogram);
+}
+
+static void
+input_set_touch_coalescing(struct wl_client *client,
+                           struct wl_resource *resource,
+                           uint32_t surface, uint32_t mode)
+{
+    struct input_context *ctx = wl_resource_get_user_data(resource);
+    struct ivisurface *surf_ctx;
+    struct seat_ctx *seat_ctx;
+
+    if (mode > IVI_INPUT_TOUCH_COALESCING_COMMIT) {
+        weston_log("%s: Invalid touch coalescing mode %u\n",
+                   __FUNCTION__, mode);
+        return;
+    }
+
+    surf_ctx = input_ctrl_get_surf_ctx_from_id(ctx, surface);
+    if (NULL == surf_ctx) {
+        weston_log("%s: surface %d was not found\n", __FUNCTION__, surface);
+        return;
+    }
+
+    /* the held back events are sent with the old mode */
+    wl_list_for_each(seat_ctx, &ctx->seat_list, seat_node) {
+        if (seat_ctx->touch_coalesce.surf != surf_ctx)
+            continue;
+
+        touch_coalesce_flush(seat_ctx);
+        if (seat_ctx->touch_coalesce.frame_pending)
+            touch_coalesce_send_frame(seat_ctx);
+        touch_coalesce_detach(&seat_ctx->touch_coalesce);
+    }
+
+    surf_ctx->touch_coalescing = mode;
+    surf_ctx->touch_dropped = 0;
+}
+
+static void
+input_get_touch_coalescing(struct wl_client *client,
+                           struct wl_resource *resource,
+                           uint32_t surface)
+{
+    struct input_context *ctx = wl_resource_get_user_data(resource);
+    struct ivisurface *surf_ctx;
+
+    surf_ctx = input_ctrl_get_surf_ctx_from_id(ctx, surface);
+    if (NULL == surf_ctx)
+        return;
+
+    ivi_input_send_touch_coalescing(resource, surface,
+                                    surf_ctx->touch_coalescing,
+                                    surf_ctx->touch_dropped);
+}
+
+static void
+input_get_surface_at(struct wl_client *client,
+                     struct wl_resource *resource,
+                     uint32_t seat, int32_t x, int32_t y)
+{
+    struct input_context *ctx = wl_resource_get_user_data(resource);
+    const struct ivi_layout_interface *interface = ctx->ivishell->interface;
+    struct weston_coord_global pos;
+    struct weston_view *view;
+    struct ivisurface *surf_ctx;
+    struct seat_ctx *ctx_seat;
+
+    ctx_seat = input_ctrl_get_seat_ctx_from_handle(ctx, seat);
+    if (NULL == ctx_seat)
+        return;
+
+    pos.c = weston_coord(x, y);
+    view = input_ctrl_pick_view(ctx_seat, pos);
+    if (NULL == view)
+        return;
+
+    surf_ctx = input_ctrl_get_surf_ctx_from_surf(ctx, view->surface);
+    if (NULL == surf_ctx)
+        return;
+
+    ivi_input_send_surface_at(resource,
+            interface->get_id_of_surface(surf_ctx->layout_surface));
 }
 
 static const struct ivi_input_interface input_implementation = {
     input_set_input_focus,
-    input_set_input_acceptance
+    input_set_input_acceptance,
+    input_get_latency_stats,
+    input_set_touch_coalescing,
+    input_get_touch_coalescing,
+    input_set_input_batch,
+    input_set_input_acceptance_handle,
+    input_get_surface_at
 };
 
 static void
@@ -1206,7 +3007,7 @@ bind_ivi_input(struct wl_client *client, void *data,
                uint32_t version, uint32_t id)
 {
     struct input_context *ctx = data;
-    struct weston_seat *seat;
+    struct seat_ctx *ctx_seat;
     struct wl_resource *resource;
     struct ivisurface *ivisurface;
     const struct ivi_layout_interface *interface =
@@ -1215,18 +3016,18 @@ bind_ivi_input(struct wl_client *client, void *data,
     uint32_t ivi_surf_id;
     int32_t is_default_seat = ILM_FALSE;
 
-    resource = wl_resource_create(client, &ivi_input_interface, 1, id);
+    resource = wl_resource_create(client, &ivi_input_interface, version, id);
     wl_resource_set_implementation(resource, &input_implementation,
                                    ctx, unbind_resource_controller);
 
     wl_list_insert(&ctx->resource_list, wl_resource_get_link(resource));
 
     /* Send seat events for all known seats to the client */
-    wl_list_for_each(seat, &ctx->ivishell->compositor->seat_list, link) {
-        is_default_seat = (strcmp(ctx->seat_default_name, seat->seat_name))
+    wl_list_for_each(ctx_seat, &ctx->seat_list, seat_node) {
+        is_default_seat = (strcmp(ctx->seat_default_name,
+                                  ctx_seat->west_seat->seat_name))
                             ? ILM_FALSE : ILM_TRUE;
-        ivi_input_send_seat_created(resource, seat->seat_name,
-                                    get_seat_capabilities(seat), is_default_seat);
+        send_seat_created(resource, ctx_seat, is_default_seat);
     }
     /* Send focus and acceptance events for all known surfaces to the client */
     wl_list_for_each(ivisurface, &ctx->ivishell->list_surface, link) {
@@ -1234,9 +3035,8 @@ bind_ivi_input(struct wl_client *client, void *data,
         wl_list_for_each(st_focus, &ivisurface->accepted_seat_list, link) {
             ivi_input_send_input_focus(resource, ivi_surf_id,
                                        st_focus->focus, ILM_TRUE);
-            ivi_input_send_input_acceptance(resource, ivi_surf_id,
-                                            st_focus->seat_ctx->west_seat->seat_name,
-                                            ILM_TRUE);
+            send_input_acceptance_to(resource, ivi_surf_id,
+                                     st_focus->seat_ctx, ILM_TRUE);
         }
     }
 }
@@ -1286,6 +3086,12 @@ destroy_input_context(struct input_context *ctx)
         wl_resource_destroy(resource);
     }
 
+    surface_map_release(&ctx->surfaces_by_surf);
+    surface_map_release(&ctx->surfaces_by_id);
+    wl_array_release(&ctx->seats_by_handle);
+    pick_index_release(&ctx->pick_index);
+    weston_log_scope_destroy(ctx->latency_scope);
+
     if (ctx->seat_default_name) {
         free(ctx->seat_default_name);
     }
@@ -1376,6 +3182,7 @@ create_input_context(struct ivishell *shell)
     ctx->ivishell = shell;
     wl_list_init(&ctx->resource_list);
     wl_list_init(&ctx->seat_list);
+    wl_array_init(&ctx->seats_by_handle);
 
     /* get the default seat*/
     if (get_config(ctx) != 0) {
@@ -1392,6 +3199,13 @@ create_input_context(struct ivishell *shell)
     ctx->ivishell->interface->shell_add_destroy_listener_once(
             &ctx->shell_destroy_listener, input_controller_destroy);
 
+    pick_index_init(&ctx->pick_index, shell);
+
+    ctx->latency_scope = weston_compositor_add_log_scope(shell->compositor,
+            "ivi-input-latency",
+            "Latency of input events per seat and surface\n",
+            input_latency_scope_begin, NULL, ctx);
+
     ctx->seat_create_listener.notify = &handle_seat_create;
     wl_signal_add(&ctx->ivishell->compositor->seat_created_signal, &ctx->seat_create_listener);
 
@@ -1422,7 +3236,7 @@ input_controller_init(struct ivishell *shell)
                 successful_init_stage++;
             break;
         case 1:
-            if (wl_global_create(shell->compositor->wl_display, &ivi_input_interface, 2,
+            if (wl_global_create(shell->compositor->wl_display, &ivi_input_interface, 3,
                                  ctx, bind_ivi_input) != NULL) {
                 successful_init_stage++;
             }
@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and
+ * its documentation for any purpose is hereby granted without fee, provided
+ * that the above copyright notice appear in all copies and that both that
+ * copyright notice and this permission notice appear in supporting
+ * documentation, and that the name of the copyright holders not be used in
+ * advertising or publicity pertaining to distribution of the software
+ * without specific, written prior permission.  The copyright holders make
+ * no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS
+ * SOFTWARE, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS, IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER
+ * RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+ * CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ivi-pick-grid.h"
+
+static struct pick_grid_cell *
+grid_cell(struct pick_grid *grid, int32_t col, int32_t row)
+{
+    return &grid->cells[row * PICK_GRID_DIM + col];
+}
+
+/* Column or row of a coordinate, clamped to the grid */
+static int32_t
+grid_index(int32_t pos, int32_t origin, int32_t cell_size)
+{
+    int32_t index;
+
+    if (pos < origin)
+        return 0;
+
+    index = (pos - origin) / cell_size;
+    return index < PICK_GRID_DIM ? index : PICK_GRID_DIM - 1;
+}
+
+static int
+cell_add(struct pick_grid_cell *cell, struct pick_grid_entry *entry)
+{
+    struct pick_grid_entry **entries;
+    uint32_t size;
+
+    if (cell->num_entries == cell->size_entries) {
+        size = cell->size_entries ? cell->size_entries * 2 : 8;
+        entries = realloc(cell->entries, size * sizeof *entries);
+        if (NULL == entries)
+            return -1;
+
+        cell->entries = entries;
+        cell->size_entries = size;
+    }
+
+    cell->entries[cell->num_entries++] = entry;
+    cell->sorted = false;
+    return 0;
+}
+
+/* Keeps the order of the other entries, so a sorted cell stays sorted */
+static void
+cell_remove(struct pick_grid_cell *cell, struct pick_grid_entry *entry)
+{
+    uint32_t i;
+
+    for (i = 0; i < cell->num_entries; i++) {
+        if (cell->entries[i] != entry)
+            continue;
+
+        memmove(&cell->entries[i], &cell->entries[i + 1],
+                (cell->num_entries - i - 1) * sizeof *cell->entries);
+        cell->num_entries--;
+        return;
+    }
+}
+
+/* Insertion sort, the cells are mostly sorted already */
+static void
+cell_sort(struct pick_grid_cell *cell)
+{
+    struct pick_grid_entry *entry;
+    uint32_t i, j;
+
+    for (i = 1; i < cell->num_entries; i++) {
+        entry = cell->entries[i];
+        for (j = i; j > 0 && cell->entries[j - 1]->rank > entry->rank; j--)
+            cell->entries[j] = cell->entries[j - 1];
+        cell->entries[j] = entry;
+    }
+
+    cell->sorted = true;
+}
+
+void
+pick_grid_init(struct pick_grid *grid)
+{
+    memset(grid, 0, sizeof *grid);
+    grid->cell_width = 1;
+    grid->cell_height = 1;
+}
+
+void
+pick_grid_release(struct pick_grid *grid)
+{
+    uint32_t i;
+
+    for (i = 0; i < PICK_GRID_DIM * PICK_GRID_DIM; i++)
+        free(grid->cells[i].entries);
+}
+
+void
+pick_grid_reset(struct pick_grid *grid, int32_t x, int32_t y,
+                int32_t width, int32_t height)
+{
+    struct pick_grid_cell *cell;
+    uint32_t i, j;
+
+    for (i = 0; i < PICK_GRID_DIM * PICK_GRID_DIM; i++) {
+        cell = &grid->cells[i];
+        for (j = 0; j < cell->num_entries; j++) {
+            cell->entries[j]->col1 = 1;
+            cell->entries[j]->col2 = 0;
+        }
+        cell->num_entries = 0;
+    }
+
+    grid->x = x;
+    grid->y = y;
+    grid->cell_width = (width + PICK_GRID_DIM - 1) / PICK_GRID_DIM;
+    grid->cell_height = (height + PICK_GRID_DIM - 1) / PICK_GRID_DIM;
+    if (grid->cell_width < 1)
+        grid->cell_width = 1;
+    if (grid->cell_height < 1)
+        grid->cell_height = 1;
+}
+
+void
+pick_grid_entry_init(struct pick_grid_entry *entry)
+{
+    memset(entry, 0, sizeof *entry);
+    entry->col1 = 1;
+    entry->col2 = 0;
+}
+
+int
+pick_grid_place(struct pick_grid *grid, struct pick_grid_entry *entry,
+                int32_t x1, int32_t y1, int32_t x2, int32_t y2)
+{
+    int32_t col1, row1, col2, row2, col, row;
+
+    col1 = grid_index(x1, grid->x, grid->cell_width);
+    row1 = grid_index(y1, grid->y, grid->cell_height);
+    col2 = grid_index(x2 - 1, grid->x, grid->cell_width);
+    row2 = grid_index(y2 - 1, grid->y, grid->cell_height);
+
+    entry->x1 = x1;
+    entry->y1 = y1;
+    entry->x2 = x2;
+    entry->y2 = y2;
+
+    /* a box moved within its cells does not touch them */
+    if ((col1 == entry->col1) && (row1 == entry->row1) &&
+        (col2 == entry->col2) && (row2 == entry->row2))
+        return 0;
+
+    pick_grid_remove(grid, entry);
+
+    for (row = row1; row <= row2; row++) {
+        for (col = col1; col <= col2; col++) {
+            if (cell_add(grid_cell(grid, col, row), entry) < 0) {
+                entry->col1 = col1;
+                entry->row1 = row1;
+                entry->col2 = col2;
+                entry->row2 = row2;
+                pick_grid_remove(grid, entry);
+                return -1;
+            }
+        }
+    }
+
+    entry->col1 = col1;
+    entry->row1 = row1;
+    entry->col2 = col2;
+    entry->row2 = row2;
+    return 0;
+}
+
+void
+pick_grid_remove(struct pick_grid *grid, struct pick_grid_entry *entry)
+{
+    int32_t col, row;
+
+    for (row = entry->row1; row <= entry->row2; row++)
+        for (col = entry->col1; col <= entry->col2; col++)
+            cell_remove(grid_cell(grid, col, row), entry);
+
+    entry->col1 = 1;
+    entry->col2 = 0;
+}
+
+void
+pick_grid_set_rank(struct pick_grid *grid, struct pick_grid_entry *entry,
+                   uint32_t rank)
+{
+    int32_t col, row;
+
+    if (entry->rank == rank)
+        return;
+
+    entry->rank = rank;
+    for (row = entry->row1; row <= entry->row2; row++)
+        for (col = entry->col1; col <= entry->col2; col++)
+            grid_cell(grid, col, row)->sorted = false;
+}
+
+const struct pick_grid_cell *
+pick_grid_lookup(struct pick_grid *grid, int32_t x, int32_t y)
+{
+    struct pick_grid_cell *cell;
+
+    cell = grid_cell(grid, grid_index(x, grid->x, grid->cell_width),
+                     grid_index(y, grid->y, grid->cell_height));
+    if (!cell->sorted)
+        cell_sort(cell);
+
+    return cell;
+}
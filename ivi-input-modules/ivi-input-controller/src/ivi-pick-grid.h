@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and
+ * its documentation for any purpose is hereby granted without fee, provided
+ * that the above copyright notice appear in all copies and that both that
+ * copyright notice and this permission notice appear in supporting
+ * documentation, and that the name of the copyright holders not be used in
+ * advertising or publicity pertaining to distribution of the software
+ * without specific, written prior permission.  The copyright holders make
+ * no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS
+ * SOFTWARE, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS, IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER
+ * RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+ * CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef IVI_PICK_GRID_H
+#define IVI_PICK_GRID_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define PICK_GRID_DIM 16
+
+/*
+ * A box in the grid, embedded by the user. The box is [x1, x2) x [y1, y2),
+ * rank is the stacking order, lower ranks are on top.
+ */
+struct pick_grid_entry {
+    int32_t x1, y1, x2, y2;
+    uint32_t rank;
+
+    /* cells covered by the box, col1 > col2 while not in the grid */
+    int32_t col1, row1, col2, row2;
+};
+
+/* The entries of a cell, sorted by rank when sorted is set */
+struct pick_grid_cell {
+    struct pick_grid_entry **entries;
+    uint32_t num_entries;
+    uint32_t size_entries;
+    bool sorted;
+};
+
+/*
+ * Uniform grid over an area, for finding the boxes at a position. A box is
+ * added to every cell it overlaps, boxes and positions outside of the area
+ * belong to the nearest cells at its border. A change of a box only
+ * touches the cells it covered and covers, the cells are sorted by rank
+ * when a position in them is looked up.
+ */
+struct pick_grid {
+    int32_t x, y;
+    int32_t cell_width, cell_height;
+    struct pick_grid_cell cells[PICK_GRID_DIM * PICK_GRID_DIM];
+};
+
+void
+pick_grid_init(struct pick_grid *grid);
+
+void
+pick_grid_release(struct pick_grid *grid);
+
+/* Removes all entries and sets the area covered by the cells, the entries
+ * are placed again afterwards */
+void
+pick_grid_reset(struct pick_grid *grid, int32_t x, int32_t y,
+                int32_t width, int32_t height);
+
+void
+pick_grid_entry_init(struct pick_grid_entry *entry);
+
+/* Adds the entry with its box to the cells, or moves it to the cells of
+ * the box. Returns -1 without memory, the entry is not in the grid then */
+int
+pick_grid_place(struct pick_grid *grid, struct pick_grid_entry *entry,
+                int32_t x1, int32_t y1, int32_t x2, int32_t y2);
+
+void
+pick_grid_remove(struct pick_grid *grid, struct pick_grid_entry *entry);
+
+void
+pick_grid_set_rank(struct pick_grid *grid, struct pick_grid_entry *entry,
+                   uint32_t rank);
+
+/* Returns the cell of the position, its entries are topmost first */
+const struct pick_grid_cell *
+pick_grid_lookup(struct pick_grid *grid, int32_t x, int32_t y);
+
+#endif /* IVI_PICK_GRID_H */
@@ -30,5 +30,6 @@ typedef const char    t_ilm_const_char;
 typedef double        t_ilm_float;
 typedef unsigned long t_ilm_ulong;
 typedef long          t_ilm_long;
+typedef unsigned long long t_ilm_uint64;
 
 #endif /* _ILM_PLATFORM_H_ */
@@ -136,6 +136,37 @@ typedef unsigned int ilmInputDevice;
 #define ILM_INPUT_DEVICE_TOUCH      ((ilmInputDevice) 1 << 2)
 #define ILM_INPUT_DEVICE_ALL        ((ilmInputDevice) ~0)
 
+/**
+ * \brief Stages of the input latency measured by the compositor
+ * \ingroup ilmClient
+ */
+typedef enum e_ilmInputLatencyStage
+{
+    ILM_INPUT_LATENCY_DISPATCH = 0,     /*!< from the input event to sending it to the client */
+    ILM_INPUT_LATENCY_COMMIT = 1,       /*!< from sending the event to the next commit of the surface */
+    ILM_INPUT_LATENCY_PRESENT = 2,      /*!< from the input event to the presentation of that commit */
+    ILM_INPUT_LATENCY_STAGES = 3
+} ilmInputLatencyStage;
+
+/**
+ * \brief Number of buckets of an input latency histogram. Bucket 0 counts
+ * latencies below 128 microseconds, bucket n latencies from 64 << n
+ * microseconds, the last bucket all higher latencies.
+ * \ingroup ilmClient
+ */
+#define ILM_INPUT_LATENCY_BUCKETS 16
+
+/**
+ * \brief Coalescing of the touch motion events sent to a surface
+ * \ingroup ilmClient
+ */
+typedef enum e_ilmTouchCoalescing
+{
+    ILM_TOUCH_COALESCING_NONE = 0,      /*!< every motion event is sent */
+    ILM_TOUCH_COALESCING_FRAME = 1,     /*!< motion events of a touch point between two touch frames are merged */
+    ILM_TOUCH_COALESCING_COMMIT = 2     /*!< motion events of a touch point are merged until the surface commits */
+} ilmTouchCoalescing;
+
 /**
  * \brief Typedef for representing a layer
  * \ingroup ilmClient
@@ -232,6 +263,32 @@ struct ilmScreenProperties
     t_ilm_char connectorName[256];  /*!< name of the connector of the screen */
 };
 
+/**
+ * \brief Typedef for representing the input configuration of a surface,
+ * see ilm_setInputConfig
+ * \ingroup ilmControl
+ **/
+struct ilmInputConfig
+{
+    t_ilm_surface surfaceID;        /*!< surface to configure */
+    t_ilm_bool setAcceptance;       /*!< replace the accepted seats of the surface by seats */
+    t_ilm_uint numSeats;            /*!< number of accepted seats */
+    t_ilm_string* seats;            /*!< names of the accepted seats */
+    ilmInputDevice focusMask;       /*!< bitmask of the devices whose focus is changed */
+    ilmInputDevice focus;           /*!< bitmask of the devices of focusMask which get the focus */
+};
+
+/**
+ * \brief Typedef for representing a counter of the compositor,
+ * see ilm_getCompositorStats
+ * \ingroup ilmControl
+ **/
+struct ilmCompositorStat
+{
+    t_ilm_char name[64];            /*!< name of the counter, e.g. "commits" */
+    t_ilm_uint64 value;             /*!< value of the counter */
+};
+
 /**
  * enum representing the possible flags for changed properties in notification callbacks.
  */
@@ -382,6 +382,58 @@ ilmErrorTypes ilm_takeAsyncScreenshot(t_ilm_uint screen,
 						screenshotErrorNotificationFunc callback_error,
 						void *user_data);
 
+/**
+ * \brief Get a checksum of the content of a surface
+ * The checksum is computed by the compositor from the buffer attached to
+ * the surface and cached until the surface commits new content, so it can
+ * be polled to detect frozen frames without transferring the content.
+ * \ingroup ilmControl
+ * \param[in] surfaceID Identifier of the surface
+ * \param[out] pChecksum pointer where the checksum is stored
+ * \return ILM_SUCCESS if the method call was successful
+ * \return ILM_FAILED if the client can not call the method on the service.
+ * \return ILM_ERROR_RESOURCE_NOT_FOUND if the surface does not exist
+ * \return ILM_ERROR_NOT_IMPLEMENTED if the compositor does not support checksums
+ */
+ilmErrorTypes ilm_getSurfaceChecksum(t_ilm_surface surfaceID, t_ilm_uint *pChecksum);
+
+/**
+ * \brief Get a checksum of the content of a screen region
+ * The compositor reads back the region after the next repaint of the screen,
+ * so this call blocks until the screen has been repainted.
+ * \ingroup ilmControl
+ * \param[in] screenID Identifier of the screen
+ * \param[in] x horizontal start position of the region
+ * \param[in] y vertical start position of the region
+ * \param[in] width width of the region, 0 together with height for the rest of the screen
+ * \param[in] height height of the region
+ * \param[out] pChecksum pointer where the checksum is stored
+ * \return ILM_SUCCESS if the method call was successful
+ * \return ILM_FAILED if the client can not call the method on the service.
+ * \return ILM_ERROR_INVALID_ARGUMENTS if the screen does not exist or the region is outside of it
+ * \return ILM_ERROR_NOT_IMPLEMENTED if the compositor does not support checksums
+ */
+ilmErrorTypes ilm_getScreenChecksum(t_ilm_display screenID, t_ilm_int x, t_ilm_int y,
+                                    t_ilm_int width, t_ilm_int height,
+                                    t_ilm_uint *pChecksum);
+
+/**
+ * \brief Get the counters the compositor keeps about its activity
+ * The counters include the number of requests of every type, of events sent
+ * to every controller, of layout commits and their duration in microseconds,
+ * of screenshots and their bytes, and the number of notifications, surfaces
+ * and layers. Counters which are still 0 may be left out.
+ * \ingroup ilmControl
+ * \param[out] pLength Pointer where the number of counters should be stored
+ * \param[out] ppStats Array where the counters should be stored,
+ *             memory for ppStats is internally allocated with malloc
+ * \return ILM_SUCCESS if the method call was successful
+ * \return ILM_FAILED if the client can not call the method on the service.
+ * \return ILM_ERROR_NOT_IMPLEMENTED if the compositor does not keep counters
+ */
+ilmErrorTypes ilm_getCompositorStats(t_ilm_int *pLength,
+                                     struct ilmCompositorStat **ppStats);
+
 /**
  * \brief Take a screenshot of a certain surface
  * The screenshot is saved as bmp file with the corresponding filename.
@@ -411,6 +463,101 @@ ilmErrorTypes ilm_takeAsyncSurfaceScreenshot(t_ilm_surface surfaceid,
 						screenshotErrorNotificationFunc callback_error,
 						void *user_data);
 
+/**
+ * \brief Take a downscaled screenshot of a certain screen with non-blocking.
+ * The compositor scales the content of the screen to width x height pixels,
+ * so only the thumbnail is transferred to the client.
+ * \ingroup ilmControl
+ * \param[in] screen Id of screen to be used
+ * \param[in] width width of the thumbnail in pixels
+ * \param[in] height height of the thumbnail in pixels
+ * \param[in] callback_done callback called when thumbnail is acquired
+ * \param[in] callback_error callback called when thumbnail acqusition failed
+ * \param[in] user_data callback user data passed in by called
+ * \return ILM_SUCCESS if the method call was successful
+ * \return ILM_FAILED if the client can not call the method on the service.
+ * \return ILM_ERROR_INVALID_ARGUMENTS if the screen does not exist or the size is 0
+ * \return ILM_ERROR_NOT_IMPLEMENTED if the compositor does not support thumbnails
+ */
+ilmErrorTypes ilm_takeAsyncScreenThumbnail(t_ilm_uint screen,
+						t_ilm_uint width, t_ilm_uint height,
+						screenshotDoneNotificationFunc callback_done,
+						screenshotErrorNotificationFunc callback_error,
+						void *user_data);
+
+/**
+ * \brief Take a downscaled screenshot of a certain surface with non-blocking.
+ * The compositor scales the content of the surface to width x height pixels,
+ * so only the thumbnail is transferred to the client.
+ * \ingroup ilmControl
+ * \param[in] surfaceid Identifier of the surface to take the thumbnail of
+ * \param[in] width width of the thumbnail in pixels
+ * \param[in] height height of the thumbnail in pixels
+ * \param[in] callback_done callback called when thumbnail is acquired
+ * \param[in] callback_error callback called when thumbnail acqusition failed
+ * \param[in] user_data callback user data passed in by called
+ * \return ILM_SUCCESS if the method call was successful
+ * \return ILM_FAILED if the client can not call the method on the service.
+ * \return ILM_ERROR_INVALID_ARGUMENTS if the size is 0
+ * \return ILM_ERROR_NOT_IMPLEMENTED if the compositor does not support thumbnails
+ */
+ilmErrorTypes ilm_takeAsyncSurfaceThumbnail(t_ilm_surface surfaceid,
+						t_ilm_uint width, t_ilm_uint height,
+						screenshotDoneNotificationFunc callback_done,
+						screenshotErrorNotificationFunc callback_error,
+						void *user_data);
+
+/**
+ * \brief Take a screenshot of a region of a certain screen with non-blocking.
+ * Only the region is read back by the compositor, the buffer passed to
+ * callback_done has the size of the region.
+ * \ingroup ilmControl
+ * \param[in] screen Id of screen to be used
+ * \param[in] x horizontal position of the region on the screen
+ * \param[in] y vertical position of the region on the screen
+ * \param[in] width width of the region
+ * \param[in] height height of the region
+ * \param[in] callback_done callback called when screenshot is acquired
+ * \param[in] callback_error callback called when screenshot acqusition failed
+ * \param[in] user_data callback user data passed in by called
+ * \return ILM_SUCCESS if the method call was successful
+ * \return ILM_FAILED if the client can not call the method on the service.
+ * \return ILM_ERROR_INVALID_ARGUMENTS if the screen does not exist or the region is empty
+ * \return ILM_ERROR_NOT_IMPLEMENTED if the compositor does not support regions
+ */
+ilmErrorTypes ilm_takeAsyncScreenshotRegion(t_ilm_uint screen,
+						t_ilm_int x, t_ilm_int y,
+						t_ilm_int width, t_ilm_int height,
+						screenshotDoneNotificationFunc callback_done,
+						screenshotErrorNotificationFunc callback_error,
+						void *user_data);
+
+/**
+ * \brief Take a screenshot of a region of a certain surface with non-blocking.
+ * The region is given in buffer coordinates of the surface. Only the region
+ * is dumped by the compositor, the buffer passed to callback_done has the
+ * size of the region.
+ * \ingroup ilmControl
+ * \param[in] surfaceid Identifier of the surface to take the screenshot of
+ * \param[in] x horizontal position of the region in the surface
+ * \param[in] y vertical position of the region in the surface
+ * \param[in] width width of the region
+ * \param[in] height height of the region
+ * \param[in] callback_done callback called when screenshot is acquired
+ * \param[in] callback_error callback called when screenshot acqusition failed
+ * \param[in] user_data callback user data passed in by called
+ * \return ILM_SUCCESS if the method call was successful
+ * \return ILM_FAILED if the client can not call the method on the service.
+ * \return ILM_ERROR_INVALID_ARGUMENTS if the region is empty
+ * \return ILM_ERROR_NOT_IMPLEMENTED if the compositor does not support regions
+ */
+ilmErrorTypes ilm_takeAsyncSurfaceScreenshotRegion(t_ilm_surface surfaceid,
+						t_ilm_int x, t_ilm_int y,
+						t_ilm_int width, t_ilm_int height,
+						screenshotDoneNotificationFunc callback_done,
+						screenshotErrorNotificationFunc callback_error,
+						void *user_data);
+
 /**
  * \brief register for notification on property changes of layer
  * \ingroup ilmControl
@@ -422,6 +569,25 @@ ilmErrorTypes ilm_takeAsyncSurfaceScreenshot(t_ilm_surface surfaceid,
  */
 ilmErrorTypes ilm_layerAddNotification(t_ilm_layer layer, layerNotificationFunc callback);
 
+/**
+ * \brief register for notification on selected property changes of layer
+ * The compositor only sends the properties selected by mask and merges
+ * changes, so that the callback is called at most maxRate times per second.
+ * \ingroup ilmControl
+ * \param[in] layer id of layer to register for notification
+ * \param[in] callback pointer to function to be called for notification
+ * \param[in] mask bitmask of the properties to be notified about
+ * \param[in] maxRate maximum number of notifications per second, 0 for no limit
+ * \return ILM_SUCCESS if the method call was successful
+ * \return ILM_FAILED if the client can not call the method on the service.
+ * \return ILM_ERROR_INVALID_ARGUMENT if the given layer does not exist
+ * \return ILM_ERROR_NOT_IMPLEMENTED if the compositor does not support filtered notifications
+ */
+ilmErrorTypes ilm_layerAddNotificationEx(t_ilm_layer layer,
+                                         layerNotificationFunc callback,
+                                         t_ilm_notification_mask mask,
+                                         t_ilm_uint maxRate);
+
 /**
  * \brief remove notification on property changes of layer
  * \ingroup ilmControl
@@ -443,6 +609,73 @@ ilmErrorTypes ilm_layerRemoveNotification(t_ilm_layer layer);
  */
 ilmErrorTypes ilm_surfaceAddNotification(t_ilm_surface surface, surfaceNotificationFunc callback);
 
+/**
+ * \brief register for notification on selected property changes of surface
+ * The compositor only sends the properties selected by mask and merges
+ * changes, so that the callback is called at most maxRate times per second.
+ * \ingroup ilmControl
+ * \param[in] surface id of surface to register for notification
+ * \param[in] callback pointer to function to be called for notification
+ * \param[in] mask bitmask of the properties to be notified about
+ * \param[in] maxRate maximum number of notifications per second, 0 for no limit
+ * \return ILM_SUCCESS if the method call was successful
+ * \return ILM_FAILED if the client can not call the method on the service.
+ * \return ILM_ERROR_INVALID_ARGUMENT if the given surface already has notification callback registered
+ * \return ILM_ERROR_NOT_IMPLEMENTED if the compositor does not support filtered notifications
+ */
+ilmErrorTypes ilm_surfaceAddNotificationEx(t_ilm_surface surface,
+                                           surfaceNotificationFunc callback,
+                                           t_ilm_notification_mask mask,
+                                           t_ilm_uint maxRate);
+
+/**
+ * \brief register for notification on property changes of all surfaces
+ * The callback is called for every existing and future surface which has
+ * no callback registered with ilm_surfaceAddNotification.
+ * \ingroup ilmControl
+ * \param[in] callback pointer to function to be called for notification
+ * \param[in] mask bitmask of the properties to be notified about
+ * \return ILM_SUCCESS if the method call was successful
+ * \return ILM_FAILED if the client can not call the method on the service.
+ * \return ILM_ERROR_INVALID_ARGUMENT if callback is NULL
+ * \return ILM_ERROR_NOT_IMPLEMENTED if the compositor does not support wildcard notifications
+ */
+ilmErrorTypes ilm_surfaceAddNotificationAll(surfaceNotificationFunc callback,
+                                            t_ilm_notification_mask mask);
+
+/**
+ * \brief remove notification on property changes of all surfaces
+ * \ingroup ilmControl
+ * \return ILM_SUCCESS if the method call was successful
+ * \return ILM_FAILED if the client can not call the method on the service.
+ * \return ILM_ERROR_INVALID_ARGUMENT if no callback is registered for all surfaces
+ */
+ilmErrorTypes ilm_surfaceRemoveNotificationAll(void);
+
+/**
+ * \brief register for notification on property changes of all layers
+ * The callback is called for every existing and future layer which has
+ * no callback registered with ilm_layerAddNotification.
+ * \ingroup ilmControl
+ * \param[in] callback pointer to function to be called for notification
+ * \param[in] mask bitmask of the properties to be notified about
+ * \return ILM_SUCCESS if the method call was successful
+ * \return ILM_FAILED if the client can not call the method on the service.
+ * \return ILM_ERROR_INVALID_ARGUMENT if callback is NULL
+ * \return ILM_ERROR_NOT_IMPLEMENTED if the compositor does not support wildcard notifications
+ */
+ilmErrorTypes ilm_layerAddNotificationAll(layerNotificationFunc callback,
+                                          t_ilm_notification_mask mask);
+
+/**
+ * \brief remove notification on property changes of all layers
+ * \ingroup ilmControl
+ * \return ILM_SUCCESS if the method call was successful
+ * \return ILM_FAILED if the client can not call the method on the service.
+ * \return ILM_ERROR_INVALID_ARGUMENT if no callback is registered for all layers
+ */
+ilmErrorTypes ilm_layerRemoveNotificationAll(void);
+
 /**
  * \brief remove notification on property changes of surface
  * \ingroup ilmControl
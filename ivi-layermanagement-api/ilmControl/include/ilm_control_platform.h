@@ -43,10 +43,32 @@ struct wayland_context {
     notificationFunc notification;
     void *notification_user_data;
 
+    surfaceNotificationFunc surface_notification_all;
+    layerNotificationFunc layer_notification_all;
+
     ilmErrorTypes error_flag;
 
     struct ivi_input *input_controller;
 
+    /* reply to the last input latency query, one bit per received stage */
+    t_ilm_uint input_latency[ILM_INPUT_LATENCY_STAGES][ILM_INPUT_LATENCY_BUCKETS];
+    uint32_t has_input_latency;
+
+    /* struct ilmCompositorStat received since the last stats query */
+    struct wl_array stats;
+
+    /* reply to the last touch coalescing query */
+    bool has_touch_coalescing;
+    uint32_t touch_coalescing;
+    uint32_t touch_dropped;
+
+    /* reply to the last input surface query */
+    bool has_surface_at;
+    uint32_t surface_at;
+
+    /* set when the compositor rejected the last input batch */
+    bool input_batch_failed;
+
     struct wl_shm *wl_shm;
     bool has_argb8888;
 };
@@ -69,6 +91,8 @@ struct ilm_control_context {
 struct seat_context {
     struct wl_list link;
     char *seat_name;
+    /* handle of the seat in the ivi_input protocol, 0 if unknown */
+    uint32_t handle;
     bool is_default;
     ilmInputDevice capabilities;
 };
@@ -76,6 +100,7 @@ struct seat_context {
 struct accepted_seat {
     struct wl_list link;
     char *seat_name;
+    uint32_t seat_handle;
 };
 
 struct surface_context {
@@ -86,6 +111,9 @@ struct surface_context {
     struct wl_list list_accepted_seats;
     surfaceNotificationFunc notification;
 
+    t_ilm_uint checksum;
+    bool has_checksum;
+
     struct wayland_context *ctx;
 };
 
@@ -64,6 +64,9 @@ struct screen_context {
 
     struct wl_array render_order;
 
+    t_ilm_uint checksum;
+    bool has_checksum;
+
     struct wayland_context *ctx;
 };
 
@@ -211,6 +214,30 @@ static struct wl_output_listener output_listener = {
     .scale = output_listener_scale
 };
 
+static void
+notify_layer(struct layer_context *ctx_layer, t_ilm_notification_mask mask)
+{
+    layerNotificationFunc callback = ctx_layer->notification;
+
+    if (callback == NULL)
+        callback = ctx_layer->ctx->layer_notification_all;
+
+    if (callback != NULL)
+        callback(ctx_layer->id_layer, &ctx_layer->prop, mask);
+}
+
+static void
+notify_surface(struct surface_context *ctx_surf, t_ilm_notification_mask mask)
+{
+    surfaceNotificationFunc callback = ctx_surf->notification;
+
+    if (callback == NULL)
+        callback = ctx_surf->ctx->surface_notification_all;
+
+    if (callback != NULL)
+        callback(ctx_surf->id_surface, &ctx_surf->prop, mask);
+}
+
 static void
 wm_listener_layer_visibility(void *data, struct ivi_wm *controller,
                              uint32_t layer_id, int32_t visibility)
@@ -227,11 +254,7 @@ wm_listener_layer_visibility(void *data, struct ivi_wm *controller,
 
     ctx_layer->prop.visibility = (t_ilm_bool)visibility;
 
-    if (ctx_layer->notification != NULL) {
-        ctx_layer->notification(ctx_layer->id_layer,
-                                &ctx_layer->prop,
-                                ILM_NOTIFICATION_VISIBILITY);
-    }
+    notify_layer(ctx_layer, ILM_NOTIFICATION_VISIBILITY);
 }
 
 static void
@@ -250,11 +273,7 @@ wm_listener_layer_opacity(void *data, struct ivi_wm *controller,
 
     ctx_layer->prop.opacity = (t_ilm_float)wl_fixed_to_double(opacity);
 
-    if (ctx_layer->notification != NULL) {
-        ctx_layer->notification(ctx_layer->id_layer,
-                                &ctx_layer->prop,
-                                ILM_NOTIFICATION_OPACITY);
-    }
+    notify_layer(ctx_layer, ILM_NOTIFICATION_OPACITY);
 }
 
 static void
@@ -280,11 +299,7 @@ wm_listener_layer_source_rectangle(void *data, struct ivi_wm *controller,
     ctx_layer->prop.sourceWidth = (t_ilm_uint)width;
     ctx_layer->prop.sourceHeight = (t_ilm_uint)height;
 
-    if (ctx_layer->notification != NULL) {
-        ctx_layer->notification(ctx_layer->id_layer,
-                                &ctx_layer->prop,
-                                ILM_NOTIFICATION_SOURCE_RECT);
-    }
+    notify_layer(ctx_layer, ILM_NOTIFICATION_SOURCE_RECT);
 }
 
 static void
@@ -310,11 +325,7 @@ wm_listener_layer_destination_rectangle(void *data, struct ivi_wm *controller,
     ctx_layer->prop.destWidth = (t_ilm_uint)width;
     ctx_layer->prop.destHeight = (t_ilm_uint)height;
 
-    if (ctx_layer->notification != NULL) {
-        ctx_layer->notification(ctx_layer->id_layer,
-                                &ctx_layer->prop,
-                                ILM_NOTIFICATION_DEST_RECT);
-    }
+    notify_layer(ctx_layer, ILM_NOTIFICATION_DEST_RECT);
 }
 
 static void
@@ -431,11 +442,7 @@ wm_listener_surface_visibility(void *data, struct ivi_wm *controller,
 
     ctx_surf->prop.visibility = (t_ilm_bool)visibility;
 
-    if (ctx_surf->notification != NULL) {
-        ctx_surf->notification(ctx_surf->id_surface,
-                                &ctx_surf->prop,
-                                ILM_NOTIFICATION_VISIBILITY);
-    }
+    notify_surface(ctx_surf, ILM_NOTIFICATION_VISIBILITY);
 }
 
 static void
@@ -454,11 +461,7 @@ wm_listener_surface_opacity(void *data, struct ivi_wm *controller,
 
     ctx_surf->prop.opacity = (t_ilm_float)wl_fixed_to_double(opacity);
 
-    if (ctx_surf->notification != NULL) {
-        ctx_surf->notification(ctx_surf->id_surface,
-                                &ctx_surf->prop,
-                                ILM_NOTIFICATION_OPACITY);
-    }
+    notify_surface(ctx_surf, ILM_NOTIFICATION_OPACITY);
 }
 
 static void
@@ -479,11 +482,7 @@ wm_listener_surface_size(void *data, struct ivi_wm *controller,
     ctx_surf->prop.origSourceWidth = (t_ilm_uint)width;
     ctx_surf->prop.origSourceHeight = (t_ilm_uint)height;
 
-    if (ctx_surf->notification != NULL) {
-        ctx_surf->notification(ctx_surf->id_surface,
-                                &ctx_surf->prop,
-                                ILM_NOTIFICATION_CONFIGURED);
-    }
+    notify_surface(ctx_surf, ILM_NOTIFICATION_CONFIGURED);
 }
 
 static void
@@ -509,11 +508,7 @@ wm_listener_surface_source_rectangle(void *data, struct ivi_wm *controller,
     ctx_surf->prop.sourceWidth = (t_ilm_uint)width;
     ctx_surf->prop.sourceHeight = (t_ilm_uint)height;
 
-    if (ctx_surf->notification != NULL) {
-        ctx_surf->notification(ctx_surf->id_surface,
-                                &ctx_surf->prop,
-                                ILM_NOTIFICATION_SOURCE_RECT);
-    }
+    notify_surface(ctx_surf, ILM_NOTIFICATION_SOURCE_RECT);
 }
 
 static void
@@ -539,11 +534,7 @@ wm_listener_surface_destination_rectangle(void *data, struct ivi_wm *controller,
     ctx_surf->prop.destWidth = (t_ilm_uint)width;
     ctx_surf->prop.destHeight = (t_ilm_uint)height;
 
-    if (ctx_surf->notification != NULL) {
-        ctx_surf->notification(ctx_surf->id_surface,
-                                &ctx_surf->prop,
-                                ILM_NOTIFICATION_DEST_RECT);
-    }
+    notify_surface(ctx_surf, ILM_NOTIFICATION_DEST_RECT);
 }
 
 static void
@@ -604,11 +595,7 @@ wm_listener_surface_destroyed(void *data, struct ivi_wm *controller,
     if(!ctx_surf)
         return;
 
-    if (ctx_surf->notification != NULL) {
-        ctx_surf->notification(ctx_surf->id_surface,
-                               &ctx_surf->prop,
-                               ILM_NOTIFICATION_CONTENT_REMOVED);
-    }
+    notify_surface(ctx_surf, ILM_NOTIFICATION_CONTENT_REMOVED);
 
     if (ctx_surf->ctx->notification != NULL) {
         ilmObjectType surface = ILM_SURFACE;
@@ -659,6 +646,38 @@ wm_listener_surface_error(void *data, struct ivi_wm *controller,
         ctx->error_flag = error_code;
 }
 
+static void
+wm_listener_surface_checksum(void *data, struct ivi_wm *controller,
+                             uint32_t surface_id, uint32_t checksum)
+{
+    struct wayland_context *ctx = data;
+    struct surface_context *ctx_surf;
+
+    ctx_surf = get_surface_context(ctx, surface_id);
+    if(!ctx_surf)
+        return;
+
+    ctx_surf->checksum = (t_ilm_uint)checksum;
+    ctx_surf->has_checksum = true;
+}
+
+static void
+wm_listener_stat(void *data, struct ivi_wm *controller, const char *name,
+                 uint32_t value_hi, uint32_t value_lo)
+{
+    struct wayland_context *ctx = data;
+    struct ilmCompositorStat *stat;
+    (void)controller;
+
+    stat = wl_array_add(&ctx->stats, sizeof *stat);
+    if (!stat)
+        return;
+
+    memset(stat, 0, sizeof *stat);
+    strncpy(stat->name, name, sizeof(stat->name) - 1);
+    stat->value = ((t_ilm_uint64)value_hi << 32) | value_lo;
+}
+
 static struct ivi_wm_listener wm_listener=
 {
     wm_listener_surface_visibility,
@@ -678,6 +697,8 @@ static struct ivi_wm_listener wm_listener=
     wm_listener_surface_size,
     wm_listener_surface_stats,
     wm_listener_layer_surface_added,
+    wm_listener_surface_checksum,
+    wm_listener_stat,
 };
 
 static void
@@ -745,12 +766,24 @@ wm_screen_listener_error(void *data, struct ivi_wm_screen *controller,
         ctx_screen->ctx->error_flag = error_code;
 }
 
+static void
+wm_screen_listener_checksum(void *data, struct ivi_wm_screen *controller,
+                            uint32_t checksum)
+{
+    struct screen_context *ctx_screen = data;
+    (void) controller;
+
+    ctx_screen->checksum = (t_ilm_uint)checksum;
+    ctx_screen->has_checksum = true;
+}
+
 static struct ivi_wm_screen_listener wm_screen_listener=
 {
     wm_screen_listener_screen_id,
     wm_screen_listener_layer_added,
     wm_screen_listener_connector_name,
-    wm_screen_listener_error
+    wm_screen_listener_error,
+    wm_screen_listener_checksum
 };
 
 static struct seat_context *
@@ -764,6 +797,17 @@ find_seat(struct wl_list *list, const char *name)
     return NULL;
 }
 
+static struct seat_context *
+find_seat_by_handle(struct wl_list *list, uint32_t handle)
+{
+    struct seat_context *seat;
+    wl_list_for_each(seat, list, link) {
+        if (seat->handle == handle)
+            return seat;
+    }
+    return NULL;
+}
+
 static void
 input_listener_seat_created(void *data,
                             struct ivi_input *ivi_input,
@@ -812,10 +856,25 @@ input_listener_seat_destroyed(void *data,
 {
     struct wayland_context *ctx = data;
     struct seat_context *seat = find_seat(&ctx->list_seat, name);
+    struct surface_context *surface_ctx;
+    struct accepted_seat *accepted_seat, *next;
     if (seat == NULL) {
         fprintf(stderr, "Warning: Cannot find seat %s to delete it\n", name);
         return;
     }
+
+    /* the compositor drops the acceptance of the seat without events */
+    wl_list_for_each(surface_ctx, &ctx->list_surface, link) {
+        wl_list_for_each_safe(accepted_seat, next,
+                              &surface_ctx->list_accepted_seats, link) {
+            if (strcmp(accepted_seat->seat_name, name) != 0)
+                continue;
+            free(accepted_seat->seat_name);
+            wl_list_remove(&accepted_seat->link);
+            free(accepted_seat);
+        }
+    }
+
     free(seat->seat_name);
     wl_list_remove(&seat->link);
     free(seat);
@@ -840,14 +899,13 @@ input_listener_input_focus(void *data,
 }
 
 static void
-input_listener_input_acceptance(void *data,
-                                struct ivi_input *ivi_input,
-                                uint32_t surface,
-                                const char *seat,
-                                int32_t accepted)
+update_input_acceptance(struct wayland_context *ctx,
+                        uint32_t surface,
+                        const char *seat,
+                        uint32_t seat_handle,
+                        int32_t accepted)
 {
     struct accepted_seat *accepted_seat, *next;
-    struct wayland_context *ctx = data;
     struct surface_context *surface_ctx = NULL;
     int surface_found = 0;
     int accepted_seat_found = 0;
@@ -867,8 +925,12 @@ input_listener_input_acceptance(void *data,
 
     wl_list_for_each_safe(accepted_seat, next,
                           &surface_ctx->list_accepted_seats, link) {
-        if (strcmp(accepted_seat->seat_name, seat) != 0)
+        if (seat_handle != 0) {
+            if (accepted_seat->seat_handle != seat_handle)
+                continue;
+        } else if (strcmp(accepted_seat->seat_name, seat) != 0) {
             continue;
+        }
 
         if (accepted != ILM_TRUE) {
             /* Remove this from the accepted seats */
@@ -897,15 +959,125 @@ input_listener_input_acceptance(void *data,
         return;
     }
     accepted_seat->seat_name = strdup(seat);
+    accepted_seat->seat_handle = seat_handle;
     wl_list_insert(&surface_ctx->list_accepted_seats, &accepted_seat->link);
 }
 
+static void
+input_listener_input_acceptance(void *data,
+                                struct ivi_input *ivi_input,
+                                uint32_t surface,
+                                const char *seat,
+                                int32_t accepted)
+{
+    struct wayland_context *ctx = data;
+
+    update_input_acceptance(ctx, surface, seat, 0, accepted);
+}
+
+static void
+input_listener_latency_histogram(void *data,
+                                 struct ivi_input *ivi_input,
+                                 uint32_t seat,
+                                 uint32_t surface,
+                                 uint32_t stage,
+                                 struct wl_array *histogram)
+{
+    struct wayland_context *ctx = data;
+    size_t size = histogram->size;
+
+    if (stage >= ILM_INPUT_LATENCY_STAGES)
+        return;
+
+    if (size > sizeof(ctx->input_latency[stage]))
+        size = sizeof(ctx->input_latency[stage]);
+
+    memset(ctx->input_latency[stage], 0, sizeof(ctx->input_latency[stage]));
+    memcpy(ctx->input_latency[stage], histogram->data, size);
+    ctx->has_input_latency |= 1U << stage;
+}
+
+static void
+input_listener_touch_coalescing(void *data,
+                                struct ivi_input *ivi_input,
+                                uint32_t surface,
+                                uint32_t mode,
+                                uint32_t dropped)
+{
+    struct wayland_context *ctx = data;
+
+    ctx->touch_coalescing = mode;
+    ctx->touch_dropped = dropped;
+    ctx->has_touch_coalescing = true;
+}
+
+static void
+input_listener_seat_handle(void *data,
+                           struct ivi_input *ivi_input,
+                           const char *name,
+                           uint32_t handle)
+{
+    struct wayland_context *ctx = data;
+    struct seat_context *seat = find_seat(&ctx->list_seat, name);
+    if (seat == NULL) {
+        fprintf(stderr, "Warning: Cannot find seat for name %s\n", name);
+        return;
+    }
+    seat->handle = handle;
+}
+
+static void
+input_listener_input_acceptance_handle(void *data,
+                                       struct ivi_input *ivi_input,
+                                       uint32_t surface,
+                                       uint32_t seat_handle,
+                                       int32_t accepted)
+{
+    struct wayland_context *ctx = data;
+    struct seat_context *seat = find_seat_by_handle(&ctx->list_seat,
+                                                    seat_handle);
+    if ((seat == NULL) || (seat_handle == 0)) {
+        fprintf(stderr, "Warning: Cannot find seat for handle %u\n",
+                seat_handle);
+        return;
+    }
+
+    update_input_acceptance(ctx, surface, seat->seat_name, seat_handle,
+                            accepted);
+}
+
+static void
+input_listener_surface_at(void *data,
+                          struct ivi_input *ivi_input,
+                          uint32_t surface)
+{
+    struct wayland_context *ctx = data;
+
+    ctx->surface_at = surface;
+    ctx->has_surface_at = true;
+}
+
+static void
+input_listener_input_batch_failed(void *data,
+                                  struct ivi_input *ivi_input)
+{
+    struct wayland_context *ctx = data;
+
+    ctx->input_batch_failed = true;
+}
+
 static struct ivi_input_listener input_listener = {
     input_listener_seat_created,
     input_listener_seat_capabilities,
     input_listener_seat_destroyed,
     input_listener_input_focus,
-    input_listener_input_acceptance
+    input_listener_input_acceptance,
+    input_listener_latency_histogram,
+    input_listener_touch_coalescing,
+    input_listener_seat_handle,
+    input_listener_input_acceptance_handle,
+    input_listener_surface_at,
+    input_listener_input_batch_failed
 };
 
 static void
@@ -927,10 +1099,10 @@ registry_handle_control(void *data,
                        uint32_t version)
 {
     struct wayland_context *ctx = data;
-    (void)version;
     if (strcmp(interface, "ivi_wm") == 0) {
         ctx->controller = wl_registry_bind(registry, name,
-                                           &ivi_wm_interface, 2);
+                                           &ivi_wm_interface,
+                                           version < 3 ? version : 3);
         if (ctx->controller == NULL) {
             fprintf(stderr, "Failed to registry bind ivi_wm\n");
             return;
@@ -940,7 +1112,8 @@ registry_handle_control(void *data,
 
     } else if (strcmp(interface, "ivi_input") == 0) {
         ctx->input_controller =
-            wl_registry_bind(registry, name, &ivi_input_interface, 2);
+            wl_registry_bind(registry, name, &ivi_input_interface,
+                             version < 3 ? version : 3);
 
         if (ctx->input_controller == NULL) {
             fprintf(stderr, "Failed to registry bind input controller\n");
@@ -1085,6 +1258,8 @@ static void destroy_control_resources(void)
         }
     }
 
+    wl_array_release(&ctx->wl.stats);
+
     if (ctx->wl.display) {
         wl_display_flush(ctx->wl.display);
     }
@@ -1196,6 +1371,7 @@ ilmControl_init(t_ilm_nativedisplay nativedisplay)
     wl_list_init(&ctx->wl.list_layer);
     wl_list_init(&ctx->wl.list_surface);
     wl_list_init(&ctx->wl.list_seat);
+    wl_array_init(&ctx->wl.stats);
 
     {
        pthread_mutexattr_t a;
@@ -1584,6 +1760,48 @@ ilm_getPropertiesOfScreen(t_ilm_display screenID,
     return returnValue;
 }
 
+ILM_EXPORT ilmErrorTypes
+ilm_getScreenChecksum(t_ilm_display screenID, t_ilm_int x, t_ilm_int y,
+                      t_ilm_int width, t_ilm_int height, t_ilm_uint *pChecksum)
+{
+    ilmErrorTypes returnValue = ILM_FAILED;
+    struct ilm_control_context *const ctx = &ilm_context;
+    struct screen_context *ctx_screen = NULL;
+    int ret = 0;
+
+    if (pChecksum == NULL)
+        return ILM_ERROR_INVALID_ARGUMENTS;
+
+    lock_context(ctx);
+    ctx_screen = get_screen_context_by_id(&ctx->wl, (uint32_t)screenID);
+    if (ctx_screen == NULL) {
+        returnValue = ILM_ERROR_INVALID_ARGUMENTS;
+    } else if (ivi_wm_screen_get_version(ctx_screen->controller) <
+               IVI_WM_SCREEN_CHECKSUM_SINCE_VERSION) {
+        returnValue = ILM_ERROR_NOT_IMPLEMENTED;
+    } else {
+        ctx_screen->has_checksum = false;
+        ivi_wm_screen_checksum(ctx_screen->controller, x, y, width, height);
+
+        /* the checksum is sent after the next repaint of the screen */
+        do {
+            ret = wl_display_dispatch_queue(ctx->wl.display, ctx->wl.queue);
+        } while ((ret != -1) && !ctx_screen->has_checksum &&
+                 (ctx->wl.error_flag == ILM_SUCCESS));
+
+        if ((ret != -1) && ctx_screen->has_checksum) {
+            *pChecksum = ctx_screen->checksum;
+            returnValue = ILM_SUCCESS;
+        } else if (ctx->wl.error_flag != ILM_SUCCESS) {
+            returnValue = ctx->wl.error_flag;
+            ctx->wl.error_flag = ILM_SUCCESS;
+        }
+    }
+
+    unlock_context(ctx);
+    return returnValue;
+}
+
 ILM_EXPORT ilmErrorTypes
 ilm_getScreenIDs(t_ilm_uint* pNumberOfIDs, t_ilm_uint** ppIDs)
 {
@@ -2506,21 +2724,291 @@ ilm_takeSurfaceScreenshot(t_ilm_const_string filename,
     return ilm_takeSurfaceShoot(surfaceid, filename, NULL, NULL, NULL);
 }
 
+/* The thumbnails and regions of screens and surfaces are all written in
+ * the argb8888 format of the buffer */
+static struct screenshot_context *
+create_async_screenshot(uint32_t width, uint32_t height,
+                        screenshotDoneNotificationFunc callback_done,
+                        screenshotErrorNotificationFunc callback_error,
+                        void *user_data)
+{
+    struct screenshot_context *ctx_scrshot =
+            calloc(1, sizeof(struct screenshot_context));
+
+    if (!ctx_scrshot) {
+        fprintf(stderr, "Failed to allocate memory for screenshot_context\n");
+        return NULL;
+    }
+    ctx_scrshot->result = ILM_FAILED;
+    ctx_scrshot->callback_done = callback_done;
+    ctx_scrshot->callback_error = callback_error;
+    ctx_scrshot->callback_priv = user_data;
+
+    ctx_scrshot->ivi_buffer = create_shm_buffer(width, height, ILM_FALSE);
+    if (ctx_scrshot->ivi_buffer == NULL) {
+        fprintf(stderr, "create_shm_buffer got a failure\n");
+        free(ctx_scrshot);
+        return NULL;
+    }
+
+    return ctx_scrshot;
+}
+
+static ilmErrorTypes
+start_async_screenshot(struct ilm_control_context *ctx,
+                       struct ivi_screenshot *scrshot,
+                       struct screenshot_context *ctx_scrshot)
+{
+    if (!scrshot) {
+        destroy_shm_buffer(ctx_scrshot->ivi_buffer);
+        free(ctx_scrshot);
+        return ILM_FAILED;
+    }
+
+    /* the screenshot context is freed in the done or error callback */
+    ivi_screenshot_add_listener(scrshot, &screenshot_listener, ctx_scrshot);
+    wl_display_flush(ctx->wl.display);
+    return ILM_SUCCESS;
+}
+
+ILM_EXPORT ilmErrorTypes
+ilm_takeAsyncScreenThumbnail(t_ilm_uint screen,
+                             t_ilm_uint width, t_ilm_uint height,
+                             screenshotDoneNotificationFunc callback_done,
+                             screenshotErrorNotificationFunc callback_error,
+                             void *user_data)
+{
+    ilmErrorTypes returnValue = ILM_FAILED;
+    struct ilm_control_context *const ctx = &ilm_context;
+    struct screenshot_context *ctx_scrshot = NULL;
+    struct screen_context *ctx_scrn = NULL;
+
+    if (!callback_done && !callback_error)
+        return ILM_SUCCESS;
+
+    if ((width == 0) || (height == 0))
+        return ILM_ERROR_INVALID_ARGUMENTS;
+
+    lock_context(ctx);
+    ctx_scrn = get_screen_context_by_id(&ctx->wl, (uint32_t)screen);
+    if (ctx_scrn == NULL) {
+        returnValue = ILM_ERROR_INVALID_ARGUMENTS;
+    } else if (ivi_wm_screen_get_version(ctx_scrn->controller) <
+               IVI_WM_SCREEN_THUMBNAIL_SINCE_VERSION) {
+        returnValue = ILM_ERROR_NOT_IMPLEMENTED;
+    } else {
+        ctx_scrshot = create_async_screenshot(width, height,
+                                              callback_done, callback_error,
+                                              user_data);
+        if (ctx_scrshot)
+            returnValue = start_async_screenshot(ctx,
+                    ivi_wm_screen_thumbnail(ctx_scrn->controller,
+                                            ctx_scrshot->ivi_buffer->wl_buffer),
+                    ctx_scrshot);
+    }
+    unlock_context(ctx);
+
+    return returnValue;
+}
+
+ILM_EXPORT ilmErrorTypes
+ilm_takeAsyncSurfaceThumbnail(t_ilm_surface surfaceid,
+                              t_ilm_uint width, t_ilm_uint height,
+                              screenshotDoneNotificationFunc callback_done,
+                              screenshotErrorNotificationFunc callback_error,
+                              void *user_data)
+{
+    ilmErrorTypes returnValue = ILM_FAILED;
+    struct ilm_control_context *const ctx = &ilm_context;
+    struct screenshot_context *ctx_scrshot = NULL;
+
+    if (!callback_done && !callback_error)
+        return ILM_SUCCESS;
+
+    if ((width == 0) || (height == 0))
+        return ILM_ERROR_INVALID_ARGUMENTS;
+
+    lock_context(ctx);
+    if (!ctx->wl.controller) {
+        returnValue = ILM_FAILED;
+    } else if (ivi_wm_get_version(ctx->wl.controller) <
+               IVI_WM_SURFACE_THUMBNAIL_SINCE_VERSION) {
+        returnValue = ILM_ERROR_NOT_IMPLEMENTED;
+    } else {
+        /* the size of the surface is not needed, the compositor scales
+         * its content to the buffer */
+        ctx_scrshot = create_async_screenshot(width, height,
+                                              callback_done, callback_error,
+                                              user_data);
+        if (ctx_scrshot)
+            returnValue = start_async_screenshot(ctx,
+                    ivi_wm_surface_thumbnail(ctx->wl.controller,
+                                             ctx_scrshot->ivi_buffer->wl_buffer,
+                                             surfaceid),
+                    ctx_scrshot);
+    }
+    unlock_context(ctx);
+
+    return returnValue;
+}
+
+ILM_EXPORT ilmErrorTypes
+ilm_takeAsyncScreenshotRegion(t_ilm_uint screen, t_ilm_int x, t_ilm_int y,
+                              t_ilm_int width, t_ilm_int height,
+                              screenshotDoneNotificationFunc callback_done,
+                              screenshotErrorNotificationFunc callback_error,
+                              void *user_data)
+{
+    ilmErrorTypes returnValue = ILM_FAILED;
+    struct ilm_control_context *const ctx = &ilm_context;
+    struct screenshot_context *ctx_scrshot = NULL;
+    struct screen_context *ctx_scrn = NULL;
+
+    if (!callback_done && !callback_error)
+        return ILM_SUCCESS;
+
+    if ((x < 0) || (y < 0) || (width <= 0) || (height <= 0))
+        return ILM_ERROR_INVALID_ARGUMENTS;
+
+    lock_context(ctx);
+    ctx_scrn = get_screen_context_by_id(&ctx->wl, (uint32_t)screen);
+    if (ctx_scrn == NULL) {
+        returnValue = ILM_ERROR_INVALID_ARGUMENTS;
+    } else if (ivi_wm_screen_get_version(ctx_scrn->controller) <
+               IVI_WM_SCREEN_SCREENSHOT_REGION_SINCE_VERSION) {
+        returnValue = ILM_ERROR_NOT_IMPLEMENTED;
+    } else {
+        /* the buffer only holds the region */
+        ctx_scrshot = create_async_screenshot(width, height,
+                                              callback_done, callback_error,
+                                              user_data);
+        if (ctx_scrshot)
+            returnValue = start_async_screenshot(ctx,
+                    ivi_wm_screen_screenshot_region(ctx_scrn->controller,
+                                            ctx_scrshot->ivi_buffer->wl_buffer,
+                                            x, y, width, height),
+                    ctx_scrshot);
+    }
+    unlock_context(ctx);
+
+    return returnValue;
+}
+
+ILM_EXPORT ilmErrorTypes
+ilm_takeAsyncSurfaceScreenshotRegion(t_ilm_surface surfaceid,
+                                     t_ilm_int x, t_ilm_int y,
+                                     t_ilm_int width, t_ilm_int height,
+                                     screenshotDoneNotificationFunc callback_done,
+                                     screenshotErrorNotificationFunc callback_error,
+                                     void *user_data)
+{
+    ilmErrorTypes returnValue = ILM_FAILED;
+    struct ilm_control_context *const ctx = &ilm_context;
+    struct screenshot_context *ctx_scrshot = NULL;
+
+    if (!callback_done && !callback_error)
+        return ILM_SUCCESS;
+
+    if ((x < 0) || (y < 0) || (width <= 0) || (height <= 0))
+        return ILM_ERROR_INVALID_ARGUMENTS;
+
+    lock_context(ctx);
+    if (!ctx->wl.controller) {
+        returnValue = ILM_FAILED;
+    } else if (ivi_wm_get_version(ctx->wl.controller) <
+               IVI_WM_SURFACE_SCREENSHOT_REGION_SINCE_VERSION) {
+        returnValue = ILM_ERROR_NOT_IMPLEMENTED;
+    } else {
+        /* the buffer only holds the region */
+        ctx_scrshot = create_async_screenshot(width, height,
+                                              callback_done, callback_error,
+                                              user_data);
+        if (ctx_scrshot)
+            returnValue = start_async_screenshot(ctx,
+                    ivi_wm_surface_screenshot_region(ctx->wl.controller,
+                                             ctx_scrshot->ivi_buffer->wl_buffer,
+                                             surfaceid, x, y, width, height),
+                    ctx_scrshot);
+    }
+    unlock_context(ctx);
+
+    return returnValue;
+}
+
+static int32_t
+convert_notification_mask(t_ilm_notification_mask mask)
+{
+    int32_t param = 0;
+
+    if (mask & ILM_NOTIFICATION_VISIBILITY)
+        param |= IVI_WM_PARAM_VISIBILITY;
+
+    if (mask & ILM_NOTIFICATION_OPACITY)
+        param |= IVI_WM_PARAM_OPACITY;
+
+    if (mask & ILM_NOTIFICATION_SOURCE_RECT)
+        param |= IVI_WM_PARAM_SOURCE_RECTANGLE;
+
+    if (mask & ILM_NOTIFICATION_DEST_RECT)
+        param |= IVI_WM_PARAM_DESTINATION_RECTANGLE;
+
+    if (mask & ILM_NOTIFICATION_CONFIGURED)
+        param |= IVI_WM_PARAM_CONFIGURE;
+
+    return param;
+}
+
+static bool
+is_filtered_sync(t_ilm_notification_mask mask, t_ilm_uint maxRate)
+{
+    return (mask != ILM_NOTIFICATION_ALL) || (maxRate != 0);
+}
+
+static bool
+has_filtered_sync(struct wayland_context *ctx)
+{
+    return ivi_wm_get_version(ctx->controller) >=
+           IVI_WM_SURFACE_SYNC_FILTERED_SINCE_VERSION;
+}
+
 ILM_EXPORT ilmErrorTypes
 ilm_layerAddNotification(t_ilm_layer layer,
                              layerNotificationFunc callback)
+{
+    return ilm_layerAddNotificationEx(layer, callback,
+                                      ILM_NOTIFICATION_ALL, 0);
+}
+
+ILM_EXPORT ilmErrorTypes
+ilm_layerAddNotificationEx(t_ilm_layer layer,
+                           layerNotificationFunc callback,
+                           t_ilm_notification_mask mask,
+                           t_ilm_uint maxRate)
 {
     ilmErrorTypes returnValue = ILM_FAILED;
     struct ilm_control_context *ctx = sync_and_acquire_instance();
     struct layer_context *ctx_layer = NULL;
 
+    if (is_filtered_sync(mask, maxRate) &&
+        !has_filtered_sync(&ctx->wl)) {
+        release_instance();
+        return ILM_ERROR_NOT_IMPLEMENTED;
+    }
+
     ctx_layer = (struct layer_context*)wayland_controller_get_layer_context(
                     &ctx->wl, (uint32_t)layer);
     if (ctx_layer == NULL) {
         returnValue = ILM_ERROR_INVALID_ARGUMENTS;
     } else {
         ctx_layer->notification = callback;
-        ivi_wm_layer_sync(ctx->wl.controller, layer, IVI_WM_SYNC_ADD);
+        if (is_filtered_sync(mask, maxRate))
+            ivi_wm_layer_sync_filtered(ctx->wl.controller, layer,
+                                       IVI_WM_SYNC_ADD,
+                                       convert_notification_mask(mask),
+                                       maxRate);
+        else
+            ivi_wm_layer_sync(ctx->wl.controller, layer, IVI_WM_SYNC_ADD);
+
         if (wl_display_roundtrip_queue(ctx->wl.display, ctx->wl.queue) == -1)
             fprintf(stderr, "wl_display_roundtrip queue failed\n");
 
@@ -2607,11 +3095,27 @@ ilm_unregisterNotification(void)
 ILM_EXPORT ilmErrorTypes
 ilm_surfaceAddNotification(t_ilm_surface surface,
                              surfaceNotificationFunc callback)
+{
+    return ilm_surfaceAddNotificationEx(surface, callback,
+                                        ILM_NOTIFICATION_ALL, 0);
+}
+
+ILM_EXPORT ilmErrorTypes
+ilm_surfaceAddNotificationEx(t_ilm_surface surface,
+                             surfaceNotificationFunc callback,
+                             t_ilm_notification_mask mask,
+                             t_ilm_uint maxRate)
 {
     ilmErrorTypes returnValue = ILM_FAILED;
     struct ilm_control_context *ctx = sync_and_acquire_instance();
     struct surface_context *ctx_surf = NULL;
 
+    if (is_filtered_sync(mask, maxRate) &&
+        !has_filtered_sync(&ctx->wl)) {
+        release_instance();
+        return ILM_ERROR_NOT_IMPLEMENTED;
+    }
+
     ctx_surf = (struct surface_context*)get_surface_context(
                     &ctx->wl, (uint32_t)surface);
 
@@ -2624,7 +3128,15 @@ ilm_surfaceAddNotification(t_ilm_surface surface,
     else {
         if (callback != NULL) {
             ctx_surf->notification = callback;
-            ivi_wm_surface_sync(ctx->wl.controller, surface, IVI_WM_SYNC_ADD);
+            if (is_filtered_sync(mask, maxRate))
+                ivi_wm_surface_sync_filtered(ctx->wl.controller, surface,
+                                             IVI_WM_SYNC_ADD,
+                                             convert_notification_mask(mask),
+                                             maxRate);
+            else
+                ivi_wm_surface_sync(ctx->wl.controller, surface,
+                                    IVI_WM_SYNC_ADD);
+
             if (wl_display_roundtrip_queue(ctx->wl.display, ctx->wl.queue) == -1)
                 fprintf(stderr, "wl_display_roundtrip queue failed\n");
 
@@ -2670,6 +3182,96 @@ ilm_surfaceRemoveNotification(t_ilm_surface surface)
     return returnValue;
 }
 
+ILM_EXPORT ilmErrorTypes
+ilm_surfaceAddNotificationAll(surfaceNotificationFunc callback,
+                              t_ilm_notification_mask mask)
+{
+    ilmErrorTypes returnValue = ILM_FAILED;
+    struct ilm_control_context *ctx = sync_and_acquire_instance();
+
+    if (callback == NULL) {
+        returnValue = ILM_ERROR_INVALID_ARGUMENTS;
+    } else if (!has_filtered_sync(&ctx->wl)) {
+        returnValue = ILM_ERROR_NOT_IMPLEMENTED;
+    } else {
+        ctx->wl.surface_notification_all = callback;
+        ivi_wm_surface_sync_all(ctx->wl.controller, IVI_WM_SYNC_ADD,
+                                convert_notification_mask(mask));
+        if (wl_display_roundtrip_queue(ctx->wl.display, ctx->wl.queue) == -1)
+            fprintf(stderr, "wl_display_roundtrip queue failed\n");
+
+        returnValue = ILM_SUCCESS;
+    }
+
+    release_instance();
+    return returnValue;
+}
+
+ILM_EXPORT ilmErrorTypes
+ilm_surfaceRemoveNotificationAll(void)
+{
+    ilmErrorTypes returnValue = ILM_FAILED;
+    struct ilm_control_context *ctx = sync_and_acquire_instance();
+
+    if (ctx->wl.surface_notification_all != NULL) {
+        ivi_wm_surface_sync_all(ctx->wl.controller, IVI_WM_SYNC_REMOVE, 0);
+        wl_display_roundtrip_queue(ctx->wl.display, ctx->wl.queue);
+
+        ctx->wl.surface_notification_all = NULL;
+        returnValue = ILM_SUCCESS;
+    } else {
+        returnValue = ILM_ERROR_INVALID_ARGUMENTS;
+    }
+
+    release_instance();
+    return returnValue;
+}
+
+ILM_EXPORT ilmErrorTypes
+ilm_layerAddNotificationAll(layerNotificationFunc callback,
+                            t_ilm_notification_mask mask)
+{
+    ilmErrorTypes returnValue = ILM_FAILED;
+    struct ilm_control_context *ctx = sync_and_acquire_instance();
+
+    if (callback == NULL) {
+        returnValue = ILM_ERROR_INVALID_ARGUMENTS;
+    } else if (!has_filtered_sync(&ctx->wl)) {
+        returnValue = ILM_ERROR_NOT_IMPLEMENTED;
+    } else {
+        ctx->wl.layer_notification_all = callback;
+        ivi_wm_layer_sync_all(ctx->wl.controller, IVI_WM_SYNC_ADD,
+                              convert_notification_mask(mask));
+        if (wl_display_roundtrip_queue(ctx->wl.display, ctx->wl.queue) == -1)
+            fprintf(stderr, "wl_display_roundtrip queue failed\n");
+
+        returnValue = ILM_SUCCESS;
+    }
+
+    release_instance();
+    return returnValue;
+}
+
+ILM_EXPORT ilmErrorTypes
+ilm_layerRemoveNotificationAll(void)
+{
+    ilmErrorTypes returnValue = ILM_FAILED;
+    struct ilm_control_context *ctx = sync_and_acquire_instance();
+
+    if (ctx->wl.layer_notification_all != NULL) {
+        ivi_wm_layer_sync_all(ctx->wl.controller, IVI_WM_SYNC_REMOVE, 0);
+        wl_display_roundtrip_queue(ctx->wl.display, ctx->wl.queue);
+
+        ctx->wl.layer_notification_all = NULL;
+        returnValue = ILM_SUCCESS;
+    } else {
+        returnValue = ILM_ERROR_INVALID_ARGUMENTS;
+    }
+
+    release_instance();
+    return returnValue;
+}
+
 ILM_EXPORT ilmErrorTypes
 ilm_getPropertiesOfSurface(t_ilm_uint surfaceID,
                         struct ilmSurfaceProperties* pSurfaceProperties)
@@ -2703,6 +3305,78 @@ ilm_getPropertiesOfSurface(t_ilm_uint surfaceID,
     return returnValue;
 }
 
+ILM_EXPORT ilmErrorTypes
+ilm_getSurfaceChecksum(t_ilm_surface surfaceID, t_ilm_uint *pChecksum)
+{
+    ilmErrorTypes returnValue = ILM_FAILED;
+    struct ilm_control_context *const ctx = &ilm_context;
+    struct surface_context *ctx_surface = NULL;
+
+    if (pChecksum == NULL)
+        return ILM_ERROR_INVALID_ARGUMENTS;
+
+    lock_context(ctx);
+
+    if (ivi_wm_get_version(ctx->wl.controller) <
+        IVI_WM_SURFACE_CHECKSUM_SINCE_VERSION) {
+        unlock_context(ctx);
+        return ILM_ERROR_NOT_IMPLEMENTED;
+    }
+
+    ctx_surface = get_surface_context(&ctx->wl, (uint32_t)surfaceID);
+    if (ctx_surface != NULL)
+        ctx_surface->has_checksum = false;
+
+    ivi_wm_surface_checksum(ctx->wl.controller, surfaceID);
+    int ret = wl_display_roundtrip_queue(ctx->wl.display, ctx->wl.queue);
+
+    ctx_surface = get_surface_context(&ctx->wl, (uint32_t)surfaceID);
+
+    if ((ret != -1) && (ctx_surface != NULL) && ctx_surface->has_checksum) {
+        *pChecksum = ctx_surface->checksum;
+        returnValue = ILM_SUCCESS;
+    } else if (ctx->wl.error_flag != ILM_SUCCESS) {
+        returnValue = ctx->wl.error_flag;
+        ctx->wl.error_flag = ILM_SUCCESS;
+    }
+
+    unlock_context(ctx);
+    return returnValue;
+}
+
+ILM_EXPORT ilmErrorTypes
+ilm_getCompositorStats(t_ilm_int *pLength, struct ilmCompositorStat **ppStats)
+{
+    ilmErrorTypes returnValue = ILM_FAILED;
+    struct ilm_control_context *const ctx = &ilm_context;
+
+    if ((pLength == NULL) || (ppStats == NULL))
+        return ILM_ERROR_INVALID_ARGUMENTS;
+
+    lock_context(ctx);
+
+    if (ivi_wm_get_version(ctx->wl.controller) <
+        IVI_WM_GET_STATS_SINCE_VERSION) {
+        unlock_context(ctx);
+        return ILM_ERROR_NOT_IMPLEMENTED;
+    }
+
+    ctx->wl.stats.size = 0;
+    ivi_wm_get_stats(ctx->wl.controller);
+
+    if (wl_display_roundtrip_queue(ctx->wl.display, ctx->wl.queue) != -1) {
+        *ppStats = malloc(ctx->wl.stats.size ? ctx->wl.stats.size : 1);
+        if (*ppStats != NULL) {
+            memcpy(*ppStats, ctx->wl.stats.data, ctx->wl.stats.size);
+            *pLength = ctx->wl.stats.size / sizeof **ppStats;
+            returnValue = ILM_SUCCESS;
+        }
+    }
+
+    unlock_context(ctx);
+    return returnValue;
+}
+
 ILM_EXPORT ilmErrorTypes
 ilm_layerAddSurface(t_ilm_layer layerId,
                         t_ilm_surface surfaceId)
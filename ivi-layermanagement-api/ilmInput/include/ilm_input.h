@@ -129,6 +129,97 @@ ilm_getInputFocus(t_ilm_surface **surfaceIDs, ilmInputDevice** bitmasks,
 ilmErrorTypes
 ilm_getDefaultSeat(t_ilm_string *seat_name);
 
+/**
+ * \brief      Get the histogram of the latency of input events of a seat
+ *             sent to a surface
+ * \ingroup    ilmControl
+ * \param[in]  seat_name   The name of the seat
+ * \param[in]  surfaceID   The surface which received the input events
+ * \param[in]  stage       The stage of the latency
+ * \param[out] histogram   The counts of events per latency bucket, see
+ *                         ILM_INPUT_LATENCY_BUCKETS
+ * \return     ILM_SUCCESS if the method call was successful
+ * \return     ILM_FAILED  if the seat does not exist
+ * \return     ILM_ERROR_NOT_IMPLEMENTED if the compositor does not measure
+ *             input latency
+ */
+ilmErrorTypes
+ilm_getInputLatencyHistogram(t_ilm_const_string seat_name,
+                             t_ilm_surface surfaceID,
+                             ilmInputLatencyStage stage,
+                             t_ilm_uint histogram[ILM_INPUT_LATENCY_BUCKETS]);
+
+/**
+ * \brief      Set how touch motion events sent to a surface are merged.
+ *             Down, up and cancel events keep their order relative to the
+ *             motion events. The count of dropped events is reset.
+ * \ingroup    ilmControl
+ * \param[in]  surfaceID   The surface to set the coalescing of
+ * \param[in]  mode        The coalescing of the touch motion events
+ * \return     ILM_SUCCESS if the method call was successful
+ * \return     ILM_FAILED  if the surface does not exist
+ * \return     ILM_ERROR_NOT_IMPLEMENTED if the compositor does not
+ *             coalesce touch motion events
+ */
+ilmErrorTypes
+ilm_setTouchCoalescing(t_ilm_surface surfaceID, ilmTouchCoalescing mode);
+
+/**
+ * \brief      Get how touch motion events sent to a surface are merged
+ * \ingroup    ilmControl
+ * \param[in]  surfaceID   The surface to get the coalescing of
+ * \param[out] mode        The coalescing of the touch motion events
+ * \param[out] dropped     The count of motion events which were merged
+ *                         or cancelled since the mode was set
+ * \return     ILM_SUCCESS if the method call was successful
+ * \return     ILM_FAILED  if the surface does not exist
+ * \return     ILM_ERROR_NOT_IMPLEMENTED if the compositor does not
+ *             coalesce touch motion events
+ */
+ilmErrorTypes
+ilm_getTouchCoalescing(t_ilm_surface surfaceID, ilmTouchCoalescing *mode,
+                       t_ilm_uint *dropped);
+
+/**
+ * \brief      Get the surface which gets the pointer or touch focus of a
+ *             seat at a position
+ * \ingroup    ilmControl
+ * \param[in]  seat_name   The name of the seat
+ * \param[in]  x           The horizontal position in global coordinates
+ * \param[in]  y           The vertical position in global coordinates
+ * \param[out] surfaceID   The topmost surface at the position which takes
+ *                         input from the seat
+ * \return     ILM_SUCCESS if the method call was successful
+ * \return     ILM_FAILED  if the seat does not exist or no surface takes
+ *                         input from the seat at the position
+ * \return     ILM_ERROR_NOT_IMPLEMENTED if the compositor cannot be asked
+ */
+ilmErrorTypes
+ilm_getInputSurfaceAt(t_ilm_const_string seat_name, t_ilm_int x, t_ilm_int y,
+                      t_ilm_surface *surfaceID);
+
+/**
+ * \brief      Set the accepted seats and the focus of many surfaces with
+ *             one request, which the compositor applies at once. The
+ *             accepted seats of all surfaces are set before the focus, and
+ *             focus is removed before it is set. The call waits until the
+ *             compositor has applied or rejected the batch.
+ * \ingroup    ilmControl
+ * \param[in]  num_configs The number of entries in configs
+ * \param[in]  configs     The input configuration of the surfaces
+ * \return     ILM_SUCCESS if the method call was successful
+ * \return     ILM_FAILED  if a surface or seat does not exist, a surface
+ *                         has more than one config, more than 32 seats are
+ *                         named, the pointer or touch focus is set on more
+ *                         than one surface, or the compositor rejected the
+ *                         batch. Nothing is changed then.
+ * \return     ILM_ERROR_NOT_IMPLEMENTED if the compositor does not
+ *             support input batches
+ */
+ilmErrorTypes
+ilm_setInputConfig(t_ilm_uint num_configs,
+                   const struct ilmInputConfig *configs);
+
 #ifdef __cplusplus
 } /**/
 #endif /* __cplusplus */
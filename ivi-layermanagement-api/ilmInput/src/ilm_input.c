@@ -27,6 +27,54 @@
 
 extern struct ilm_control_context ilm_context;
 
+static int
+is_accepted_seat(struct accepted_seat *accepted_seat, struct seat_context *seat)
+{
+    /* seats are compared by handle if the compositor sent them */
+    if (seat->handle != 0)
+        return accepted_seat->seat_handle == seat->handle;
+
+    return strcmp(accepted_seat->seat_name, seat->seat_name) == 0;
+}
+
+/* Returns the seat of the name if the compositor sent its handle */
+static struct seat_context *
+get_seat_with_handle(struct ilm_control_context *ctx,
+                     t_ilm_const_string seat_name)
+{
+    struct seat_context *seat;
+
+    wl_list_for_each(seat, &ctx->wl.list_seat, link) {
+        if (strcmp(seat->seat_name, seat_name) != 0)
+            continue;
+
+        if (seat->handle == 0) {
+            fprintf(stderr, "seat: %s has no handle\n", seat_name);
+            return NULL;
+        }
+        return seat;
+    }
+
+    fprintf(stderr, "seat: %s not found\n", seat_name);
+    return NULL;
+}
+
+static void
+send_input_acceptance(struct ilm_control_context *ctx, t_ilm_surface surfaceID,
+                      const char *seat_name, uint32_t seat_handle,
+                      t_ilm_bool accepted)
+{
+    if ((seat_handle != 0) &&
+        (ivi_input_get_version(ctx->wl.input_controller) >=
+         IVI_INPUT_SET_INPUT_ACCEPTANCE_HANDLE_SINCE_VERSION))
+        ivi_input_set_input_acceptance_handle(ctx->wl.input_controller,
+                                              surfaceID, seat_handle,
+                                              accepted);
+    else
+        ivi_input_set_input_acceptance(ctx->wl.input_controller,
+                                       surfaceID, seat_name, accepted);
+}
+
 ILM_EXPORT ilmErrorTypes
 ilm_setInputAcceptanceOn(t_ilm_surface surfaceID, t_ilm_uint num_seats,
                          t_ilm_string *seats)
@@ -36,14 +84,22 @@ ilm_setInputAcceptanceOn(t_ilm_surface surfaceID, t_ilm_uint num_seats,
     struct surface_context *surface_ctx = NULL;
     struct accepted_seat *accepted_seat;
     struct seat_context *seat;
+    struct seat_context **seat_ctxs = NULL;
     int surface_found = 0;
-    int seat_found = 0;
 
     if ((seats == NULL) && (num_seats != 0)) {
         fprintf(stderr, "Invalid Argument\n");
         return ILM_FAILED;
     }
 
+    if (num_seats != 0) {
+        seat_ctxs = calloc(num_seats, sizeof *seat_ctxs);
+        if (seat_ctxs == NULL) {
+            fprintf(stderr, "Failed to allocate memory for seat list\n");
+            return ILM_FAILED;
+        }
+    }
+
     ctx = sync_and_acquire_instance();
 
     wl_list_for_each(surface_ctx, &ctx->wl.list_surface, link) {
@@ -56,22 +112,26 @@ ilm_setInputAcceptanceOn(t_ilm_surface surfaceID, t_ilm_uint num_seats,
     if (!surface_found) {
         fprintf(stderr, "surface ID %d not found\n", surfaceID);
         release_instance();
+        free(seat_ctxs);
         return ILM_FAILED;
     }
 
+    /* Seat names are only compared here, the seats are identified by
+     * their handles from now on */
     for(i = 0; i < num_seats; i++) {
         wl_list_for_each(seat, &ctx->wl.list_seat, link) {
-            if (strcmp(seat->seat_name, seats[i]) == 0)
-                    seat_found = 1;
+            if (strcmp(seat->seat_name, seats[i]) == 0) {
+                seat_ctxs[i] = seat;
+                break;
+            }
         }
 
-        if (!seat_found) {
+        if (seat_ctxs[i] == NULL) {
             fprintf(stderr, "seat: %s not found\n", seats[i]);
             release_instance();
+            free(seat_ctxs);
             return ILM_FAILED;
         }
-
-        seat_found = 0;
     }
     /* Send events to add input acceptance for every seat in 'seats', but
      * not on the surface's list */
@@ -80,14 +140,13 @@ ilm_setInputAcceptanceOn(t_ilm_surface surfaceID, t_ilm_uint num_seats,
 
         wl_list_for_each(accepted_seat, &surface_ctx->list_accepted_seats,
                          link) {
-            if (strcmp(accepted_seat->seat_name, seats[i]) == 0)
+            if (is_accepted_seat(accepted_seat, seat_ctxs[i]))
                 has_seat = 1;
         }
 
         if (!has_seat) {
-            ivi_input_set_input_acceptance(ctx->wl.input_controller,
-                                                      surfaceID, seats[i],
-                                                      ILM_TRUE);
+            send_input_acceptance(ctx, surfaceID, seat_ctxs[i]->seat_name,
+                                  seat_ctxs[i]->handle, ILM_TRUE);
         }
     }
 
@@ -96,17 +155,16 @@ ilm_setInputAcceptanceOn(t_ilm_surface surfaceID, t_ilm_uint num_seats,
     wl_list_for_each(accepted_seat, &surface_ctx->list_accepted_seats, link) {
         int has_seat = 0;
         for (i = 0; i < num_seats; i++) {
-            if (strcmp(accepted_seat->seat_name, seats[i]) == 0)
+            if (is_accepted_seat(accepted_seat, seat_ctxs[i]))
                 has_seat = 1;
         }
         if (!has_seat)
-            ivi_input_set_input_acceptance(ctx->wl.input_controller,
-                                                      surfaceID,
-                                                      accepted_seat->seat_name,
-                                                      ILM_FALSE);
+            send_input_acceptance(ctx, surfaceID, accepted_seat->seat_name,
+                                  accepted_seat->seat_handle, ILM_FALSE);
     }
 
     release_instance();
+    free(seat_ctxs);
     return ILM_SUCCESS;
 }
 
@@ -356,3 +414,346 @@ ilm_getDefaultSeat(t_ilm_string *seat_name)
     release_instance();
     return (*seat_name) ? ILM_SUCCESS : ILM_FAILED;
 }
+
+ILM_EXPORT ilmErrorTypes
+ilm_getInputLatencyHistogram(t_ilm_const_string seat_name,
+                             t_ilm_surface surfaceID,
+                             ilmInputLatencyStage stage,
+                             t_ilm_uint histogram[ILM_INPUT_LATENCY_BUCKETS])
+{
+    struct ilm_control_context *ctx;
+    struct seat_context *seat;
+    ilmErrorTypes returnValue = ILM_FAILED;
+
+    if ((seat_name == NULL) || (histogram == NULL) ||
+        (stage >= ILM_INPUT_LATENCY_STAGES)) {
+        fprintf(stderr, "Invalid Argument\n");
+        return ILM_FAILED;
+    }
+
+    ctx = sync_and_acquire_instance();
+
+    if (ctx->wl.input_controller == NULL) {
+        release_instance();
+        return ILM_FAILED;
+    }
+
+    if (ivi_input_get_version(ctx->wl.input_controller) <
+        IVI_INPUT_GET_LATENCY_STATS_SINCE_VERSION) {
+        release_instance();
+        return ILM_ERROR_NOT_IMPLEMENTED;
+    }
+
+    seat = get_seat_with_handle(ctx, seat_name);
+    if (seat == NULL) {
+        release_instance();
+        return ILM_FAILED;
+    }
+
+    ctx->wl.has_input_latency = 0;
+    ivi_input_get_latency_stats(ctx->wl.input_controller, seat->handle,
+                                surfaceID);
+
+    if ((wl_display_roundtrip_queue(ctx->wl.display, ctx->wl.queue) != -1) &&
+        (ctx->wl.has_input_latency & (1U << stage))) {
+        memcpy(histogram, ctx->wl.input_latency[stage],
+               sizeof(ctx->wl.input_latency[stage]));
+        returnValue = ILM_SUCCESS;
+    }
+
+    release_instance();
+    return returnValue;
+}
+
+ILM_EXPORT ilmErrorTypes
+ilm_setTouchCoalescing(t_ilm_surface surfaceID, ilmTouchCoalescing mode)
+{
+    struct ilm_control_context *ctx;
+    struct surface_context *ctx_surf;
+    ilmErrorTypes returnValue = ILM_FAILED;
+
+    if (mode > ILM_TOUCH_COALESCING_COMMIT) {
+        fprintf(stderr, "Invalid Argument\n");
+        return ILM_FAILED;
+    }
+
+    ctx = sync_and_acquire_instance();
+
+    if (ctx->wl.input_controller == NULL) {
+        release_instance();
+        return ILM_FAILED;
+    }
+
+    if (ivi_input_get_version(ctx->wl.input_controller) <
+        IVI_INPUT_SET_TOUCH_COALESCING_SINCE_VERSION) {
+        release_instance();
+        return ILM_ERROR_NOT_IMPLEMENTED;
+    }
+
+    wl_list_for_each(ctx_surf, &ctx->wl.list_surface, link) {
+        if (ctx_surf->id_surface == surfaceID) {
+            ivi_input_set_touch_coalescing(ctx->wl.input_controller,
+                                           surfaceID, mode);
+            returnValue = ILM_SUCCESS;
+            break;
+        }
+    }
+
+    if (returnValue != ILM_SUCCESS)
+        fprintf(stderr, "Surface %d was not found\n", surfaceID);
+
+    release_instance();
+    return returnValue;
+}
+
+ILM_EXPORT ilmErrorTypes
+ilm_getTouchCoalescing(t_ilm_surface surfaceID, ilmTouchCoalescing *mode,
+                       t_ilm_uint *dropped)
+{
+    struct ilm_control_context *ctx;
+    ilmErrorTypes returnValue = ILM_FAILED;
+
+    if ((mode == NULL) || (dropped == NULL)) {
+        fprintf(stderr, "Invalid Argument\n");
+        return ILM_FAILED;
+    }
+
+    ctx = sync_and_acquire_instance();
+
+    if (ctx->wl.input_controller == NULL) {
+        release_instance();
+        return ILM_FAILED;
+    }
+
+    if (ivi_input_get_version(ctx->wl.input_controller) <
+        IVI_INPUT_GET_TOUCH_COALESCING_SINCE_VERSION) {
+        release_instance();
+        return ILM_ERROR_NOT_IMPLEMENTED;
+    }
+
+    ctx->wl.has_touch_coalescing = false;
+    ivi_input_get_touch_coalescing(ctx->wl.input_controller, surfaceID);
+
+    if ((wl_display_roundtrip_queue(ctx->wl.display, ctx->wl.queue) != -1) &&
+        ctx->wl.has_touch_coalescing) {
+        *mode = (ilmTouchCoalescing)ctx->wl.touch_coalescing;
+        *dropped = ctx->wl.touch_dropped;
+        returnValue = ILM_SUCCESS;
+    }
+
+    release_instance();
+    return returnValue;
+}
+
+ILM_EXPORT ilmErrorTypes
+ilm_getInputSurfaceAt(t_ilm_const_string seat_name, t_ilm_int x, t_ilm_int y,
+                      t_ilm_surface *surfaceID)
+{
+    struct ilm_control_context *ctx;
+    struct seat_context *seat;
+    ilmErrorTypes returnValue = ILM_FAILED;
+
+    if ((seat_name == NULL) || (surfaceID == NULL)) {
+        fprintf(stderr, "Invalid Argument\n");
+        return ILM_FAILED;
+    }
+
+    ctx = sync_and_acquire_instance();
+
+    if (ctx->wl.input_controller == NULL) {
+        release_instance();
+        return ILM_FAILED;
+    }
+
+    if (ivi_input_get_version(ctx->wl.input_controller) <
+        IVI_INPUT_GET_SURFACE_AT_SINCE_VERSION) {
+        release_instance();
+        return ILM_ERROR_NOT_IMPLEMENTED;
+    }
+
+    seat = get_seat_with_handle(ctx, seat_name);
+    if (seat == NULL) {
+        release_instance();
+        return ILM_FAILED;
+    }
+
+    ctx->wl.has_surface_at = false;
+    ivi_input_get_surface_at(ctx->wl.input_controller, seat->handle, x, y);
+
+    if ((wl_display_roundtrip_queue(ctx->wl.display, ctx->wl.queue) != -1) &&
+        ctx->wl.has_surface_at) {
+        *surfaceID = ctx->wl.surface_at;
+        returnValue = ILM_SUCCESS;
+    }
+
+    release_instance();
+    return returnValue;
+}
+
+#define INPUT_CONFIG_MAX_SEATS 32
+
+static int
+input_config_intern_seat(struct ilm_control_context *ctx,
+                         uint32_t *handles, int *num_handles,
+                         t_ilm_const_string seat_name)
+{
+    struct seat_context *seat = get_seat_with_handle(ctx, seat_name);
+    int i;
+
+    if (seat == NULL)
+        return -1;
+
+    for (i = 0; i < *num_handles; i++) {
+        if (handles[i] == seat->handle)
+            return i;
+    }
+
+    if (*num_handles == INPUT_CONFIG_MAX_SEATS) {
+        fprintf(stderr, "More than %d seats\n", INPUT_CONFIG_MAX_SEATS);
+        return -1;
+    }
+
+    handles[*num_handles] = seat->handle;
+    return (*num_handles)++;
+}
+
+static ilmErrorTypes
+input_config_add_entry(struct ilm_control_context *ctx,
+                       const struct ilmInputConfig *config,
+                       uint32_t *handles, int *num_handles,
+                       struct wl_array *entries)
+{
+    struct surface_context *ctx_surf;
+    uint32_t *entry;
+    uint32_t seat_mask = 0;
+    int surface_found = 0;
+    int index;
+    t_ilm_uint i;
+
+    wl_list_for_each(ctx_surf, &ctx->wl.list_surface, link) {
+        if (ctx_surf->id_surface == config->surfaceID) {
+            surface_found = 1;
+            break;
+        }
+    }
+
+    if (!surface_found) {
+        fprintf(stderr, "Surface %d was not found\n", config->surfaceID);
+        return ILM_FAILED;
+    }
+
+    if (config->setAcceptance) {
+        if ((config->seats == NULL) && (config->numSeats != 0)) {
+            fprintf(stderr, "Invalid Argument\n");
+            return ILM_FAILED;
+        }
+
+        for (i = 0; i < config->numSeats; i++) {
+            index = input_config_intern_seat(ctx, handles, num_handles,
+                                             config->seats[i]);
+            if (index < 0)
+                return ILM_FAILED;
+            seat_mask |= 1U << index;
+        }
+    }
+
+    entry = wl_array_add(entries, 5 * sizeof *entry);
+    if (entry == NULL) {
+        fprintf(stderr, "Failed to allocate memory for input config\n");
+        return ILM_FAILED;
+    }
+
+    entry[0] = config->surfaceID;
+    entry[1] = config->setAcceptance ?
+               IVI_INPUT_INPUT_BATCH_FLAGS_SET_ACCEPTANCE : 0;
+    entry[2] = seat_mask;
+    entry[3] = config->focusMask;
+    entry[4] = config->focus;
+
+    return ILM_SUCCESS;
+}
+
+ILM_EXPORT ilmErrorTypes
+ilm_setInputConfig(t_ilm_uint num_configs,
+                   const struct ilmInputConfig *configs)
+{
+    struct ilm_control_context *ctx;
+    ilmErrorTypes returnValue = ILM_SUCCESS;
+    uint32_t handles[INPUT_CONFIG_MAX_SEATS];
+    int num_handles = 0;
+    struct wl_array seats;
+    struct wl_array entries;
+    ilmInputDevice exclusive_focus = 0;
+    ilmInputDevice device;
+    uint32_t *seat_handles;
+    t_ilm_uint i, k;
+
+    if ((configs == NULL) && (num_configs != 0)) {
+        fprintf(stderr, "Invalid Argument\n");
+        return ILM_FAILED;
+    }
+
+    for (i = 0; i < num_configs; i++) {
+        for (k = 0; k < i; k++) {
+            if (configs[k].surfaceID == configs[i].surfaceID) {
+                fprintf(stderr, "Surface %d has more than one config\n",
+                        configs[i].surfaceID);
+                return ILM_FAILED;
+            }
+        }
+
+        device = configs[i].focusMask & configs[i].focus &
+                 (ILM_INPUT_DEVICE_POINTER | ILM_INPUT_DEVICE_TOUCH);
+        if (exclusive_focus & device) {
+            fprintf(stderr,
+                    "Cannot set pointer or touch focus for multiple surfaces\n");
+            return ILM_FAILED;
+        }
+        exclusive_focus |= device;
+    }
+
+    ctx = sync_and_acquire_instance();
+
+    if (ctx->wl.input_controller == NULL) {
+        release_instance();
+        return ILM_FAILED;
+    }
+
+    if (ivi_input_get_version(ctx->wl.input_controller) <
+        IVI_INPUT_SET_INPUT_BATCH_SINCE_VERSION) {
+        release_instance();
+        return ILM_ERROR_NOT_IMPLEMENTED;
+    }
+
+    wl_array_init(&seats);
+    wl_array_init(&entries);
+
+    for (i = 0; (i < num_configs) && (returnValue == ILM_SUCCESS); i++)
+        returnValue = input_config_add_entry(ctx, &configs[i], handles,
+                                             &num_handles, &entries);
+
+    if ((returnValue == ILM_SUCCESS) && (num_handles != 0)) {
+        seat_handles = wl_array_add(&seats, num_handles * sizeof *handles);
+        if (seat_handles == NULL) {
+            fprintf(stderr, "Failed to allocate memory for seat handles\n");
+            returnValue = ILM_FAILED;
+        } else {
+            memcpy(seat_handles, handles, num_handles * sizeof *handles);
+        }
+    }
+
+    if (returnValue == ILM_SUCCESS) {
+        ctx->wl.input_batch_failed = false;
+        ivi_input_set_input_batch(ctx->wl.input_controller, &seats, &entries);
+
+        /* the compositor checks the batch again against its own state */
+        if ((wl_display_roundtrip_queue(ctx->wl.display, ctx->wl.queue) == -1) ||
+            ctx->wl.input_batch_failed)
+            returnValue = ILM_FAILED;
+    }
+
+    wl_array_release(&seats);
+    wl_array_release(&entries);
+    release_instance();
+    return returnValue;
+}
@@ -734,6 +734,73 @@ TEST_F(NotificationTest, MultipleRegistrationsSurface)
     ASSERT_EQ(ILM_SUCCESS,ilm_surfaceRemoveNotification(surface));
 }
 
+TEST_F(NotificationTest, NotifyOnSurfaceFilteredMask)
+{
+    ASSERT_EQ(ILM_SUCCESS,ilm_surfaceAddNotificationEx(surface,&SurfaceCallbackFunction,
+                                                       ILM_NOTIFICATION_VISIBILITY, 0));
+    // change something not selected by the mask
+    t_ilm_float opacity = 0.789;
+    ilm_surfaceSetOpacity(surface,opacity);
+    ilm_surfaceSetVisibility(surface,true);
+    ilm_commitChanges();
+
+    // expect callback to have been called only for the visibility
+    assertCallbackcalled(2);
+
+    EXPECT_EQ(surface,callbackSurfaceId);
+    EXPECT_TRUE(SurfaceProperties.visibility);
+    EXPECT_EQ(ILM_NOTIFICATION_VISIBILITY|ILM_NOTIFICATION_CONTENT_AVAILABLE,mask);
+
+    ASSERT_EQ(ILM_SUCCESS,ilm_surfaceRemoveNotification(surface));
+}
+
+TEST_F(NotificationTest, NotifyOnLayerRateLimited)
+{
+    ASSERT_EQ(ILM_SUCCESS,ilm_layerAddNotificationEx(layer,&LayerCallbackFunction,
+                                                     ILM_NOTIFICATION_OPACITY, 4));
+    // first change is sent immediately
+    ilm_layerSetOpacity(layer,0.2);
+    ilm_commitChanges();
+    assertCallbackcalled();
+
+    // following changes within the interval are merged into one event
+    ilm_layerSetOpacity(layer,0.4);
+    ilm_commitChanges();
+    ilm_layerSetOpacity(layer,0.6);
+    ilm_commitChanges();
+    assertCallbackcalled();
+
+    EXPECT_EQ(layer,callbackLayerId);
+    EXPECT_NEAR(0.6, LayerProperties.opacity, 0.01);
+    EXPECT_EQ(ILM_NOTIFICATION_OPACITY,mask);
+
+    ASSERT_EQ(ILM_SUCCESS,ilm_layerRemoveNotification(layer));
+}
+
+TEST_F(NotificationTest, NotifyOnAllSurfaces)
+{
+    ASSERT_EQ(ILM_SUCCESS,ilm_surfaceAddNotificationAll(&SurfaceCallbackFunction,
+                                                        ILM_NOTIFICATION_ALL));
+    // change something
+    ilm_surfaceSetVisibility(surface,true);
+    ilm_commitChanges();
+
+    // expect callback to have been called without a content available event
+    assertCallbackcalled();
+
+    EXPECT_EQ(surface,callbackSurfaceId);
+    EXPECT_TRUE(SurfaceProperties.visibility);
+    EXPECT_EQ(ILM_NOTIFICATION_VISIBILITY,mask);
+
+    ASSERT_EQ(ILM_SUCCESS,ilm_surfaceRemoveNotificationAll());
+
+    ilm_surfaceSetVisibility(surface,false);
+    ilm_commitChanges();
+
+    // assert that we have not been notified
+    assertNoCallbackIsCalled();
+}
+
 TEST_F(NotificationTest, DefaultIsNotToReceiveNotificationsSurface)
 {
     // get called once
@@ -774,6 +841,58 @@ TEST_F(NotificationTest, getNotificationWhenScreenshotDone)
     ASSERT_NE(screenshotData.fd.load(), -1);
 }
 
+TEST_F(NotificationTest, getNotificationWhenThumbnailDone)
+{
+    /* Call ilm_takeAsyncScreenThumbnail with right screen id
+     * The ilm_takeAsyncScreenThumbnail should return ILM_SUCCESS
+     * Screenshot done callback should trigged
+     */
+    screenshot_data_t screenshotData;
+    screenshotData.fd.store(-1);
+    ASSERT_EQ(ILM_SUCCESS, ilm_takeAsyncScreenThumbnail(0, 64, 36, ScreenshotDoneCallbackFunc, ScreenshotErrorCallbackFunc, &screenshotData));
+    assertCallbackcalled();
+    ASSERT_NE(screenshotData.fd.load(), -1);
+
+    /* Call ilm_takeAsyncSurfaceThumbnail with right surface id
+     * The ilm_takeAsyncSurfaceThumbnail should return ILM_SUCCESS
+     * Screenshot done callback should trigged
+     */
+    screenshotData.fd.store(-1);
+    ASSERT_EQ(ILM_SUCCESS, ilm_takeAsyncSurfaceThumbnail(surface, 16, 16, ScreenshotDoneCallbackFunc, ScreenshotErrorCallbackFunc, &screenshotData));
+    assertCallbackcalled();
+    ASSERT_NE(screenshotData.fd.load(), -1);
+
+    /* A thumbnail without pixels is rejected on the client side */
+    ASSERT_EQ(ILM_ERROR_INVALID_ARGUMENTS, ilm_takeAsyncScreenThumbnail(0, 0, 36, ScreenshotDoneCallbackFunc, ScreenshotErrorCallbackFunc, &screenshotData));
+    assertNoCallbackIsCalled();
+}
+
+TEST_F(NotificationTest, getNotificationWhenRegionScreenshotDone)
+{
+    /* Call ilm_takeAsyncScreenshotRegion with right screen id
+     * The ilm_takeAsyncScreenshotRegion should return ILM_SUCCESS
+     * Screenshot done callback should trigged
+     */
+    screenshot_data_t screenshotData;
+    screenshotData.fd.store(-1);
+    ASSERT_EQ(ILM_SUCCESS, ilm_takeAsyncScreenshotRegion(0, 8, 8, 32, 16, ScreenshotDoneCallbackFunc, ScreenshotErrorCallbackFunc, &screenshotData));
+    assertCallbackcalled();
+    ASSERT_NE(screenshotData.fd.load(), -1);
+
+    /* Call ilm_takeAsyncSurfaceScreenshotRegion with right surface id
+     * The ilm_takeAsyncSurfaceScreenshotRegion should return ILM_SUCCESS
+     * Screenshot done callback should trigged
+     */
+    screenshotData.fd.store(-1);
+    ASSERT_EQ(ILM_SUCCESS, ilm_takeAsyncSurfaceScreenshotRegion(surface, 0, 0, 4, 4, ScreenshotDoneCallbackFunc, ScreenshotErrorCallbackFunc, &screenshotData));
+    assertCallbackcalled();
+    ASSERT_NE(screenshotData.fd.load(), -1);
+
+    /* An empty region is rejected on the client side */
+    ASSERT_EQ(ILM_ERROR_INVALID_ARGUMENTS, ilm_takeAsyncScreenshotRegion(0, 0, 0, 0, 16, ScreenshotDoneCallbackFunc, ScreenshotErrorCallbackFunc, &screenshotData));
+    assertNoCallbackIsCalled();
+}
+
 TEST_F(NotificationTest, invalidInputsIsNotToReceiveNotificationsScreenshot)
 {
     /* Call ilm_takeAsyncScreenshot with wrong screen id
@@ -21,6 +21,7 @@
 
 #include <gtest/gtest.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <unistd.h>
 #include <sys/types.h>
@@ -618,6 +619,72 @@ TEST_F(IlmCommandTest, ilm_takeSurfaceScreenshot_InvalidInputs) {
     ASSERT_NE(0, remove(outputFile));
 }
 
+TEST_F(IlmCommandTest, ilm_getSurfaceChecksum) {
+    uint surface = iviSurfaces[0].surface_id;
+    t_ilm_uint checksum1 = 0, checksum2 = 0;
+    ASSERT_EQ(ILM_SUCCESS, ilm_commitChanges());
+
+    // surface does not commit in between, so the content is the same
+    ASSERT_EQ(ILM_SUCCESS, ilm_getSurfaceChecksum(surface, &checksum1));
+    ASSERT_EQ(ILM_SUCCESS, ilm_getSurfaceChecksum(surface, &checksum2));
+    EXPECT_EQ(checksum1, checksum2);
+}
+
+TEST_F(IlmCommandTest, ilm_getSurfaceChecksum_InvalidInput) {
+    t_ilm_uint checksum = 0;
+    ASSERT_NE(ILM_SUCCESS, ilm_getSurfaceChecksum(0xdeadbeef, &checksum));
+    ASSERT_NE(ILM_SUCCESS, ilm_getSurfaceChecksum(iviSurfaces[0].surface_id, NULL));
+}
+
+TEST_F(IlmCommandTest, ilm_getScreenChecksum) {
+    t_ilm_uint numberOfScreens;
+    t_ilm_uint* screenIDs;
+    t_ilm_uint checksum = 0;
+    ASSERT_EQ(ILM_SUCCESS, ilm_getScreenIDs(&numberOfScreens, &screenIDs));
+    ASSERT_GT(numberOfScreens, 0u);
+
+    EXPECT_EQ(ILM_SUCCESS, ilm_getScreenChecksum(screenIDs[0], 0, 0, 0, 0, &checksum));
+    EXPECT_EQ(ILM_SUCCESS, ilm_getScreenChecksum(screenIDs[0], 0, 0, 16, 16, &checksum));
+    // region outside of the screen
+    EXPECT_NE(ILM_SUCCESS, ilm_getScreenChecksum(screenIDs[0], -1, 0, 16, 16, &checksum));
+
+    free(screenIDs);
+}
+
+static t_ilm_uint64 getStat(const char *name)
+{
+    t_ilm_int length = 0;
+    struct ilmCompositorStat *stats = NULL;
+    t_ilm_uint64 value = 0;
+
+    EXPECT_EQ(ILM_SUCCESS, ilm_getCompositorStats(&length, &stats));
+    for (t_ilm_int i = 0; i < length; i++)
+    {
+        if (strcmp(stats[i].name, name) == 0)
+            value = stats[i].value;
+    }
+
+    free(stats);
+    return value;
+}
+
+TEST_F(IlmCommandTest, ilm_getCompositorStats) {
+    t_ilm_uint64 commits = getStat("commits");
+
+    ASSERT_EQ(ILM_SUCCESS, ilm_commitChanges());
+    EXPECT_EQ(commits + 1, getStat("commits"));
+    EXPECT_GE(getStat("requests.ivi_wm.commit_changes"), commits + 1);
+    EXPECT_GE(getStat("surfaces"), (t_ilm_uint64)iviSurfaces.size());
+    EXPECT_GE(getStat("controllers"), 1u);
+}
+
+TEST_F(IlmCommandTest, ilm_getCompositorStats_InvalidInput) {
+    t_ilm_int length = 0;
+    struct ilmCompositorStat *stats = NULL;
+    ASSERT_NE(ILM_SUCCESS, ilm_getCompositorStats(NULL, &stats));
+    ASSERT_NE(ILM_SUCCESS, ilm_getCompositorStats(&length, NULL));
+}
+
 TEST_F(IlmCommandTest, ilm_getPropertiesOfScreen) {
     t_ilm_uint numberOfScreens;
     t_ilm_uint* screenIDs;
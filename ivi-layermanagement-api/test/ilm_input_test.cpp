@@ -43,8 +43,32 @@ bool contains(T const *actual, size_t as, T expected)
    return false;
 }
 
+static void
+frameDone(void *data, struct wl_callback *callback, uint32_t time)
+{
+    *static_cast<bool *>(data) = true;
+    wl_callback_destroy(callback);
+}
+
+static const struct wl_callback_listener frameListener = {
+    frameDone
+};
+
 class IlmInputTest : public TestBase, public ::testing::Test {
 public:
+    /* Returns after the compositor repainted the surface */
+    void waitForRepaint(wl_surface *surface)
+    {
+        bool done = false;
+        struct wl_callback *callback = wl_surface_frame(surface);
+
+        wl_callback_add_listener(callback, &frameListener, &done);
+        wl_surface_damage(surface, 0, 0, 1, 1);
+        wl_surface_commit(surface);
+        while (!done && (wl_display_dispatch(wlDisplay) != -1))
+            ;
+    }
+
     void SetUp()
     {
         ASSERT_EQ(ILM_SUCCESS, ilm_initWithNativedisplay((t_ilm_nativedisplay)wlDisplay));
@@ -225,3 +249,243 @@ TEST_F(IlmInputTest, ilm_input_event_acceptance) {
 
     free(set_seats);
 }
+
+TEST_F(IlmInputTest, ilm_input_latency_histogram) {
+    t_ilm_surface surface1 = iviSurfaces[0].surface_id;
+    t_ilm_uint histogram[ILM_INPUT_LATENCY_BUCKETS];
+    t_ilm_string seat = NULL;
+
+    ASSERT_EQ(ILM_FAILED, ilm_getInputLatencyHistogram(NULL, surface1,
+                                                       ILM_INPUT_LATENCY_DISPATCH,
+                                                       histogram));
+
+    if (ilm_getDefaultSeat(&seat) == ILM_FAILED) {
+        GTEST_SKIP() << "Skipping input latency histogram, there isn't a default seat";
+    }
+
+    ASSERT_EQ(ILM_FAILED, ilm_getInputLatencyHistogram(seat, surface1,
+                                                       ILM_INPUT_LATENCY_STAGES,
+                                                       histogram));
+
+    /* A surface without input has empty histograms for all stages */
+    for (int stage = ILM_INPUT_LATENCY_DISPATCH;
+         stage < ILM_INPUT_LATENCY_STAGES; stage++) {
+        ASSERT_EQ(ILM_SUCCESS,
+                  ilm_getInputLatencyHistogram(seat, surface1,
+                                               (ilmInputLatencyStage)stage,
+                                               histogram));
+        for (int i = 0; i < ILM_INPUT_LATENCY_BUCKETS; i++)
+            EXPECT_EQ(0u, histogram[i]);
+    }
+
+    /* Unknown seats are refused */
+    EXPECT_EQ(ILM_FAILED, ilm_getInputLatencyHistogram("no-such-seat", surface1,
+                                                       ILM_INPUT_LATENCY_PRESENT,
+                                                       histogram));
+
+    free(seat);
+}
+
+TEST_F(IlmInputTest, ilm_input_touch_coalescing) {
+    t_ilm_surface surface1 = iviSurfaces[0].surface_id;
+    ilmTouchCoalescing mode;
+    t_ilm_uint dropped;
+
+    /* Touch motion events are not coalesced by default */
+    ASSERT_EQ(ILM_SUCCESS, ilm_getTouchCoalescing(surface1, &mode, &dropped));
+    EXPECT_EQ(ILM_TOUCH_COALESCING_NONE, mode);
+    EXPECT_EQ(0u, dropped);
+
+    ASSERT_EQ(ILM_SUCCESS, ilm_setTouchCoalescing(surface1,
+                                                  ILM_TOUCH_COALESCING_COMMIT));
+    ASSERT_EQ(ILM_SUCCESS, ilm_getTouchCoalescing(surface1, &mode, &dropped));
+    EXPECT_EQ(ILM_TOUCH_COALESCING_COMMIT, mode);
+    EXPECT_EQ(0u, dropped);
+
+    ASSERT_EQ(ILM_SUCCESS, ilm_setTouchCoalescing(surface1,
+                                                  ILM_TOUCH_COALESCING_FRAME));
+    ASSERT_EQ(ILM_SUCCESS, ilm_getTouchCoalescing(surface1, &mode, &dropped));
+    EXPECT_EQ(ILM_TOUCH_COALESCING_FRAME, mode);
+
+    /* Invalid inputs are refused */
+    EXPECT_EQ(ILM_FAILED, ilm_setTouchCoalescing(surface1,
+                                                 (ilmTouchCoalescing)3));
+    EXPECT_EQ(ILM_FAILED, ilm_getTouchCoalescing(surface1, NULL, &dropped));
+    EXPECT_EQ(ILM_FAILED, ilm_setTouchCoalescing(0xdead,
+                                                 ILM_TOUCH_COALESCING_FRAME));
+    EXPECT_EQ(ILM_FAILED, ilm_getTouchCoalescing(0xdead, &mode, &dropped));
+}
+
+TEST_F(IlmInputTest, ilm_input_surface_at) {
+    t_ilm_surface surfaces[] = {iviSurfaces[0].surface_id,
+                                iviSurfaces[1].surface_id};
+    t_ilm_layer layer = 0xbeef;
+    t_ilm_uint numberOfScreens = 0;
+    t_ilm_uint *screenIDs = NULL;
+    t_ilm_string seat = NULL;
+    t_ilm_surface surface;
+
+    if (ilm_getDefaultSeat(&seat) == ILM_FAILED) {
+        GTEST_SKIP() << "Skipping surface picking, there isn't a default seat";
+    }
+
+    ASSERT_EQ(ILM_SUCCESS, ilm_getScreenIDs(&numberOfScreens, &screenIDs));
+    ASSERT_GT(numberOfScreens, 0u);
+
+    ASSERT_EQ(ILM_SUCCESS, ilm_layerCreateWithDimension(&layer, 800, 480));
+    ASSERT_EQ(ILM_SUCCESS, ilm_layerSetVisibility(layer, ILM_TRUE));
+    ASSERT_EQ(ILM_SUCCESS, ilm_layerSetRenderOrder(layer, surfaces, 2));
+    for (int i = 0; i < 2; i++) {
+        ASSERT_EQ(ILM_SUCCESS, ilm_surfaceSetSourceRectangle(surfaces[i],
+                                                             0, 0, 1, 1));
+        ASSERT_EQ(ILM_SUCCESS, ilm_surfaceSetDestinationRectangle(
+                                       surfaces[i], 200 * i, 0, 100, 100));
+        ASSERT_EQ(ILM_SUCCESS, ilm_surfaceSetVisibility(surfaces[i],
+                                                        ILM_TRUE));
+    }
+    ASSERT_EQ(ILM_SUCCESS, ilm_displaySetRenderOrder(screenIDs[0], &layer, 1));
+    ASSERT_EQ(ILM_SUCCESS, ilm_commitChanges());
+    waitForRepaint(wlSurfaces[1]);
+
+    ASSERT_EQ(ILM_SUCCESS, ilm_getInputSurfaceAt(seat, 50, 50, &surface));
+    EXPECT_EQ(surfaces[0], surface);
+    ASSERT_EQ(ILM_SUCCESS, ilm_getInputSurfaceAt(seat, 250, 50, &surface));
+    EXPECT_EQ(surfaces[1], surface);
+    EXPECT_EQ(ILM_FAILED, ilm_getInputSurfaceAt(seat, 150, 50, &surface));
+
+    /* Moved by the controller */
+    ASSERT_EQ(ILM_SUCCESS, ilm_surfaceSetDestinationRectangle(
+                                   surfaces[0], 100, 0, 100, 100));
+    ASSERT_EQ(ILM_SUCCESS, ilm_commitChanges());
+    EXPECT_EQ(ILM_FAILED, ilm_getInputSurfaceAt(seat, 50, 50, &surface));
+    ASSERT_EQ(ILM_SUCCESS, ilm_getInputSurfaceAt(seat, 150, 50, &surface));
+    EXPECT_EQ(surfaces[0], surface);
+
+    /* Unmapped without a layout commit */
+    wl_surface_attach(wlSurfaces[0], NULL, 0, 0);
+    wl_surface_commit(wlSurfaces[0]);
+    waitForRepaint(wlSurfaces[1]);
+    EXPECT_EQ(ILM_FAILED, ilm_getInputSurfaceAt(seat, 150, 50, &surface));
+
+    /* Mapped again through the configure path of ivi-controller */
+    wl_surface_attach(wlSurfaces[0], wlBuffers[0], 0, 0);
+    wl_surface_damage(wlSurfaces[0], 0, 0, 1, 1);
+    wl_surface_commit(wlSurfaces[0]);
+    waitForRepaint(wlSurfaces[1]);
+    ASSERT_EQ(ILM_SUCCESS, ilm_getInputSurfaceAt(seat, 150, 50, &surface));
+    EXPECT_EQ(surfaces[0], surface);
+
+    /* Invalid inputs are refused */
+    EXPECT_EQ(ILM_FAILED, ilm_getInputSurfaceAt(NULL, 150, 50, &surface));
+    EXPECT_EQ(ILM_FAILED, ilm_getInputSurfaceAt(seat, 150, 50, NULL));
+    EXPECT_EQ(ILM_FAILED, ilm_getInputSurfaceAt("no-such-seat", 150, 50,
+                                                &surface));
+
+    free(screenIDs);
+    free(seat);
+}
+
+TEST_F(IlmInputTest, ilm_input_config_batch) {
+    t_ilm_string seat = NULL;
+    t_ilm_uint num_seats = 0;
+    t_ilm_string *seats = NULL;
+    struct ilmInputConfig configs[4];
+
+    if (ilm_getDefaultSeat(&seat) == ILM_FAILED) {
+        GTEST_SKIP() << "Skipping input config batch, there isn't a default seat";
+    }
+
+    /* One batch removes the default seat from two surfaces */
+    memset(configs, 0, sizeof configs);
+    for (int i = 0; i < 4; i++) {
+        configs[i].surfaceID = iviSurfaces[i].surface_id;
+        configs[i].setAcceptance = ILM_TRUE;
+        configs[i].numSeats = (i < 2) ? 0 : 1;
+        configs[i].seats = &seat;
+    }
+    ASSERT_EQ(ILM_SUCCESS, ilm_setInputConfig(4, configs));
+
+    for (int i = 0; i < 4; i++) {
+        ASSERT_EQ(ILM_SUCCESS,
+                  ilm_getInputAcceptanceOn(iviSurfaces[i].surface_id,
+                                           &num_seats, &seats));
+        EXPECT_EQ((i < 2) ? 0u : 1u, num_seats);
+        for (t_ilm_uint j = 0; j < num_seats; j++) {
+            EXPECT_STREQ(seat, seats[j]);
+            free(seats[j]);
+        }
+        free(seats);
+    }
+
+    /* Pointer focus can only be set on one surface */
+    configs[2].focusMask = configs[2].focus = ILM_INPUT_DEVICE_POINTER;
+    configs[3].focusMask = configs[3].focus = ILM_INPUT_DEVICE_POINTER;
+    EXPECT_EQ(ILM_FAILED, ilm_setInputConfig(4, configs));
+
+    /* A surface can only have one config */
+    configs[2].focusMask = configs[2].focus = 0;
+    configs[3].focusMask = configs[3].focus = 0;
+    configs[3].surfaceID = configs[2].surfaceID;
+    EXPECT_EQ(ILM_FAILED, ilm_setInputConfig(4, configs));
+
+    /* Nothing is applied if a surface does not exist */
+    configs[0].numSeats = 1;
+    configs[3].surfaceID = 0xdead;
+    EXPECT_EQ(ILM_FAILED, ilm_setInputConfig(4, configs));
+    ASSERT_EQ(ILM_SUCCESS,
+              ilm_getInputAcceptanceOn(iviSurfaces[0].surface_id,
+                                       &num_seats, &seats));
+    EXPECT_EQ(0u, num_seats);
+    free(seats);
+
+    free(seat);
+}
+
+TEST_F(IlmInputTest, ilm_input_acceptance_stress) {
+    const int iterations = 200;
+    t_ilm_string seat = NULL;
+    t_ilm_uint num_seats = 0;
+    t_ilm_string *seats = NULL;
+    std::vector<struct ilmInputConfig> configs(iviSurfaces.size());
+
+    if (ilm_getDefaultSeat(&seat) == ILM_FAILED) {
+        GTEST_SKIP() << "Skipping input acceptance stress, there isn't a default seat";
+    }
+
+    /* Toggle the acceptance of the default seat on all surfaces, one
+     * set_input_acceptance_handle per surface or one set_input_batch for
+     * all of them in turns. Batches fail for seats without handle. */
+    for (int i = 0; i < iterations; i++) {
+        if ((i / 2) % 2) {
+            for (size_t j = 0; j < iviSurfaces.size(); j++) {
+                memset(&configs[j], 0, sizeof configs[j]);
+                configs[j].surfaceID = iviSurfaces[j].surface_id;
+                configs[j].setAcceptance = ILM_TRUE;
+                configs[j].numSeats = (i % 2) ? 1 : 0;
+                configs[j].seats = &seat;
+            }
+            ASSERT_EQ(ILM_SUCCESS,
+                      ilm_setInputConfig(configs.size(), configs.data()));
+            continue;
+        }
+
+        for (size_t j = 0; j < iviSurfaces.size(); j++) {
+            ASSERT_EQ(ILM_SUCCESS,
+                      ilm_setInputAcceptanceOn(iviSurfaces[j].surface_id,
+                                               (i % 2) ? 1 : 0, &seat));
+        }
+    }
+
+    /* The last iteration accepted the seat again */
+    for (size_t j = 0; j < iviSurfaces.size(); j++) {
+        ASSERT_EQ(ILM_SUCCESS,
+                  ilm_getInputAcceptanceOn(iviSurfaces[j].surface_id,
+                                           &num_seats, &seats));
+        ASSERT_EQ(1u, num_seats);
+        EXPECT_STREQ(seat, seats[0]);
+        free(seats[0]);
+        free(seats);
+    }
+
+    free(seat);
+}
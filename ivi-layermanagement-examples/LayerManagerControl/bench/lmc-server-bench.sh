@@ -0,0 +1,72 @@
+#!/bin/sh
+############################################################################
+#
+# Copyright 2026 agent <agent@local>
+#
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+############################################################################
+#
+# Compares running LayerManagerControl commands as one process per command
+# with running them on a LayerManagerControl server, either with one client
+# process per command or with all commands streamed through one client.
+#
+# usage: lmc-server-bench.sh [<count>] [<command>]
+#
+# Needs a running compositor with ivi-controller.
+
+LMC=${LMC:-LayerManagerControl}
+COUNT=${1:-200}
+COMMAND=${2:-get screens}
+SOCKET=${XDG_RUNTIME_DIR:-/tmp}/lmc-bench-$$.sock
+
+now_ms() {
+    echo $(($(date +%s%N) / 1000000))
+}
+
+report() {
+    echo "$1: $COUNT commands in $2 ms, $(($2 * 1000 / COUNT)) usec per command"
+}
+
+start=$(now_ms)
+i=0
+while [ $i -lt $COUNT ]; do
+    $LMC $COMMAND > /dev/null
+    i=$((i + 1))
+done
+report "process per command" $(($(now_ms) - start))
+
+$LMC --server "$SOCKET" &
+SERVER=$!
+trap 'kill $SERVER 2> /dev/null' EXIT
+
+while [ ! -S "$SOCKET" ]; do
+    sleep 0.1
+done
+
+start=$(now_ms)
+i=0
+while [ $i -lt $COUNT ]; do
+    $LMC --connect "$SOCKET" $COMMAND > /dev/null
+    i=$((i + 1))
+done
+report "server, client per command" $(($(now_ms) - start))
+
+start=$(now_ms)
+i=0
+while [ $i -lt $COUNT ]; do
+    echo "$COMMAND"
+    i=$((i + 1))
+done | $LMC --connect "$SOCKET" > /dev/null
+report "server, one client" $(($(now_ms) - start))
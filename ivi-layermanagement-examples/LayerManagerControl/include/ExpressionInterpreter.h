@@ -20,6 +20,8 @@
 #define __EXPRESSIONINTERPRETER_H__
 
 #include "Expression.h"
+#include "ilm_common.h"
+#include <istream>
 #include <string>
 using namespace std;
 
@@ -36,6 +38,9 @@ class ExpressionInterpreter
 public:
     ExpressionInterpreter();
     CommandResult interpretCommand(string userInput);
+    CommandResult interpretScript(istream& script, bool singleCommit);
+    CommandResult connect();
+    void disconnect();
     string getLastError();
     static void printExpressionTree();
     static void printExpressionList();
@@ -43,8 +48,11 @@ public:
     static bool addExpression(callback funcPtr, string command);
 
 private:
+    CommandResult checkExecution(ilmErrorTypes commitResult);
+
     static Expression* mpRoot;
     string mErrorText;
+    bool mConnected;
 };
 
 #endif // __EXPRESSIONINTERPRETER_H__
@@ -128,6 +128,26 @@ tuple4 getSurfaceScreenCoordinates(t_scene_data* pScene, t_ilm_surface surface);
  */
 vector<t_ilm_surface> getSceneRenderOrder(t_scene_data* pScene);
 
+/*
+ * Prints the error of an ilm call and marks the running command as failed
+ */
+void printIlmError(ilmErrorTypes result);
+
+/*
+ * Returns true, if an ilm call of the last command failed, and resets it
+ */
+bool takeCommandFailed();
+
+/*
+ * Commits the changes of a command, unless the commits are deferred
+ */
+ilmErrorTypes commitChanges();
+
+/*
+ * Defers the commits of the commands, so that a batch of commands is committed at once
+ */
+void setCommitsDeferred(t_ilm_bool deferred);
+
 //=============================================================================
 //util.cpp
 //=============================================================================
@@ -219,6 +239,12 @@ void testNotificationLayer(t_ilm_layer layerid);
 void watchLayer(unsigned int* layerids, unsigned int layeridCount);
 void watchSurface(unsigned int* surfaceids, unsigned int surfaceidCount);
 
+/*
+ * Writes the notifications of all layers and surfaces as JSON lines with monotonic
+ * timestamps until SIGINT or SIGTERM, then the event rates and gaps per object
+ */
+void watchScene();
+
 
 //=============================================================================
 //analyze.cpp
@@ -249,4 +275,20 @@ void exportSceneToFile(string filename);
  */
 void exportXtext(string fileName, string grammar, string url);
 
+//=============================================================================
+//server.cpp
+//=============================================================================
+
+/*
+ * Runs the commands of the clients of a unix domain socket over one connection
+ * to the compositor, until SIGINT or SIGTERM
+ */
+int runServer(const char* socketPath);
+
+/*
+ * Runs a command, or the commands of stdin if command is empty, on a server
+ * and prints the results
+ */
+int runClient(const char* socketPath, const string& command);
+
 #endif
@@ -19,17 +19,20 @@
 #include "ExpressionInterpreter.h"
 #include "Expression.h"
 #include "ilm_control.h"
+#include "LMControl.h"
 #include <string>
 #include <sstream>
 #include <algorithm> // transform
 #include <ctype.h> // tolower
 
 #include <iostream>
+#include <time.h> // clock_gettime
 
 Expression* ExpressionInterpreter::mpRoot = NULL;
 
 ExpressionInterpreter::ExpressionInterpreter()
 : mErrorText("No error.")
+, mConnected(false)
 {
 }
 
@@ -153,7 +156,15 @@ CommandResult ExpressionInterpreter::interpretCommand(string userInput)
         Expression* expr = *(currentState.begin());
 
         ExpressionList executables = expr->getClosureExecutables(false);
-        if (executables.size() == 1)
+        if (executables.size() == 1 && mConnected)
+        {
+            // commands share the connection of a script or server
+            Expression* exec = executables.front();
+            takeCommandFailed();
+            exec->execute();
+            result = checkExecution(commitChanges());
+        }
+        else if (executables.size() == 1)
         {
             ilmErrorTypes initResult = ilm_init();
             if (ILM_SUCCESS != initResult)
@@ -164,8 +175,9 @@ CommandResult ExpressionInterpreter::interpretCommand(string userInput)
             else
             {
                 Expression* exec = executables.front();
+                takeCommandFailed();
                 exec->execute();
-                ilm_commitChanges();
+                result = checkExecution(ilm_commitChanges());
                 ilm_destroy();
             }
         }
@@ -184,6 +196,121 @@ CommandResult ExpressionInterpreter::interpretCommand(string userInput)
     return result;
 }
 
+CommandResult ExpressionInterpreter::checkExecution(ilmErrorTypes commitResult)
+{
+    if (takeCommandFailed())
+    {
+        mErrorText = "command failed.";
+        return CommandExecutionFailed;
+    }
+
+    if (ILM_SUCCESS != commitResult)
+    {
+        mErrorText = ILM_ERROR_STRING(commitResult);
+        return CommandExecutionFailed;
+    }
+
+    return CommandSuccess;
+}
+
+CommandResult ExpressionInterpreter::connect()
+{
+    ilmErrorTypes initResult = ilm_init();
+    if (ILM_SUCCESS != initResult)
+    {
+        mErrorText = ILM_ERROR_STRING(initResult);
+        return CommandExecutionFailed;
+    }
+
+    mConnected = true;
+    return CommandSuccess;
+}
+
+void ExpressionInterpreter::disconnect()
+{
+    ilm_destroy();
+    mConnected = false;
+}
+
+CommandResult ExpressionInterpreter::interpretScript(istream& script, bool singleCommit)
+{
+    if (CommandSuccess != connect())
+    {
+        return CommandExecutionFailed;
+    }
+
+    setCommitsDeferred(singleCommit ? ILM_TRUE : ILM_FALSE);
+
+    CommandResult result = CommandSuccess;
+    unsigned int lineNumber = 0;
+    unsigned int commandCount = 0;
+    string line;
+
+    struct timespec start;
+    struct timespec end;
+    struct timespec commandStart;
+    struct timespec commandEnd;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    // one command per line, empty lines and lines starting with '#' are skipped
+    while (getline(script, line))
+    {
+        ++lineNumber;
+
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == string::npos || line[first] == '#')
+        {
+            continue;
+        }
+
+        size_t last = line.find_last_not_of(" \t\r");
+        ++commandCount;
+
+        clock_gettime(CLOCK_MONOTONIC, &commandStart);
+        CommandResult lineResult = interpretCommand(line.substr(first, last - first + 1));
+        clock_gettime(CLOCK_MONOTONIC, &commandEnd);
+
+        double commandMs = (commandEnd.tv_sec - commandStart.tv_sec) * 1000.0 +
+                           (commandEnd.tv_nsec - commandStart.tv_nsec) / 1000000.0;
+        cerr << "line " << lineNumber << ": " << commandMs << " ms" << endl;
+
+        if (CommandSuccess != lineResult)
+        {
+            cerr << "line " << lineNumber << ": " << getLastError() << endl;
+            result = lineResult;
+        }
+    }
+
+    setCommitsDeferred(ILM_FALSE);
+    if (singleCommit)
+    {
+        ilmErrorTypes commitResult = ilm_commitChanges();
+        if (ILM_SUCCESS != commitResult)
+        {
+            cerr << "commit failed: " << ILM_ERROR_STRING(commitResult) << endl;
+            result = CommandExecutionFailed;
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    disconnect();
+
+    double totalMs = (end.tv_sec - start.tv_sec) * 1000.0 + (end.tv_nsec - start.tv_nsec) / 1000000.0;
+    cerr << commandCount << " commands in " << totalMs << " ms";
+    if (commandCount > 0)
+    {
+        cerr << ", " << totalMs / commandCount << " ms per command";
+    }
+    cerr << endl;
+
+    if (CommandSuccess != result)
+    {
+        mErrorText = "script failed.";
+    }
+
+    return result;
+}
+
 void ExpressionInterpreter::printExpressionTree()
 {
     mpRoot->printTree();
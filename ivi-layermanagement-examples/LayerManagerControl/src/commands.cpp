@@ -83,7 +83,7 @@ COMMAND("get scene|screens|layers|surfaces")
         ilmErrorTypes callResult = ilm_getScreenIDs(&count, &array);
         if (ILM_SUCCESS != callResult)
         {
-            cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+            printIlmError(callResult);
             cout << "Failed to get screen IDs\n";
             return;
         }
@@ -100,7 +100,7 @@ COMMAND("get scene|screens|layers|surfaces")
         ilmErrorTypes callResult = ilm_getLayerIDs(&count, &array);
         if (ILM_SUCCESS != callResult)
         {
-            cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+            printIlmError(callResult);
             cout << "Failed to get layer IDs\n";
             return;
         }
@@ -117,7 +117,7 @@ COMMAND("get scene|screens|layers|surfaces")
         ilmErrorTypes callResult = ilm_getSurfaceIDs(&count, &array);
         if (ILM_SUCCESS != callResult)
         {
-            cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+            printIlmError(callResult);
             cout << "Failed to get surface IDs\n";
             return;
         }
@@ -145,6 +145,30 @@ COMMAND("get screen|layer|surface <id>")
     }
 }
 
+//=============================================================================
+COMMAND("get stats")
+//=============================================================================
+{
+    (void)input;
+    t_ilm_int length = 0;
+    struct ilmCompositorStat* stats = NULL;
+
+    ilmErrorTypes callResult = ilm_getCompositorStats(&length, &stats);
+    if (ILM_SUCCESS != callResult)
+    {
+        printIlmError(callResult);
+        cout << "Failed to get compositor stats\n";
+        return;
+    }
+
+    for (t_ilm_int i = 0; i < length; ++i)
+    {
+        cout << stats[i].name << " " << stats[i].value << "\n";
+    }
+
+    free(stats);
+}
+
 //=============================================================================
 COMMAND("dump screen|surface <id> to <file>")
 //=============================================================================
@@ -155,7 +179,7 @@ COMMAND("dump screen|surface <id> to <file>")
                                                         input->getString("file").c_str());
         if (ILM_SUCCESS != callResult)
         {
-            cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+            printIlmError(callResult);
             cout << "Failed to take screenshot of screen with ID " << input->getUint("id") << "\n";
             return;
         }
@@ -166,7 +190,7 @@ COMMAND("dump screen|surface <id> to <file>")
                                                                 input->getUint("id"));
         if (ILM_SUCCESS != callResult)
         {
-            cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+            printIlmError(callResult);
             cout << "Failed to take screenshot of surface with ID " << input->getUint("id") << "\n";
             return;
         }
@@ -188,24 +212,24 @@ COMMAND("set layer|surface <id> source region <x> <y> <w> <h>")
         ilmErrorTypes callResult = ilm_layerSetSourceRectangle(id, x, y, w, h);
         if (ILM_SUCCESS != callResult)
         {
-            cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+            printIlmError(callResult);
             cout << "Failed to set source rectangle (" << x << "," << y << ", " << w << ", " << h << ") for layer with ID " << id << "\n";
             return;
         }
 
-        ilm_commitChanges();
+        commitChanges();
     }
     else if (input->contains("surface"))
     {
         ilmErrorTypes callResult = ilm_surfaceSetSourceRectangle(id, x, y, w, h);
         if (ILM_SUCCESS != callResult)
         {
-            cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+            printIlmError(callResult);
             cout << "Failed to set source rectangle (" << x << ", " << y << ", " << w << ", " << h << ") for surface with ID " << id << "\n";
             return;
         }
 
-        ilm_commitChanges();
+        commitChanges();
     }
 }
 
@@ -224,24 +248,24 @@ COMMAND("set layer|surface <id> destination region <x> <y> <w> <h>")
         ilmErrorTypes callResult = ilm_layerSetDestinationRectangle(id, x, y, w, h);
         if (ILM_SUCCESS != callResult)
         {
-            cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+            printIlmError(callResult);
             cout << "Failed to set destination rectangle (" << x << ", " << y << ", " << w << ", " << h << ") for layer with ID " << id << "\n";
             return;
         }
 
-        ilm_commitChanges();
+        commitChanges();
     }
     else if (input->contains("surface"))
     {
         ilmErrorTypes callResult = ilm_surfaceSetDestinationRectangle(id, x, y, w, h);
         if (ILM_SUCCESS != callResult)
         {
-            cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+            printIlmError(callResult);
             cout << "Failed to set destination rectangle (" << x << ", " << y << ", " << w << ", " << h << ") for surface with ID " << id << "\n";
             return;
         }
 
-        ilm_commitChanges();
+        commitChanges();
     }
 }
 
@@ -257,24 +281,24 @@ COMMAND("set layer|surface <id> opacity <opacity>")
         ilmErrorTypes callResult = ilm_layerSetOpacity(id, opacity);
         if (ILM_SUCCESS != callResult)
         {
-            cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+            printIlmError(callResult);
             cout << "Failed to set opacity " << opacity << " for layer with ID " << id << "\n";
             return;
         }
 
-        ilm_commitChanges();
+        commitChanges();
     }
     else if (input->contains("surface"))
     {
         ilmErrorTypes callResult = ilm_surfaceSetOpacity(id, opacity);
         if (ILM_SUCCESS != callResult)
         {
-            cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+            printIlmError(callResult);
             cout << "Failed to set opacity " << opacity << " for surface with ID " << id << "\n";
             return;
         }
 
-        ilm_commitChanges();
+        commitChanges();
     }
 }
 
@@ -290,24 +314,24 @@ COMMAND("set layer|surface <id> visibility <visibility>")
         ilmErrorTypes callResult = ilm_layerSetVisibility(id, visibility);
         if (ILM_SUCCESS != callResult)
         {
-            cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+            printIlmError(callResult);
             cout << "Failed to set visibility " << visibility << " for layer with ID " << id << "\n";
             return;
         }
 
-        ilm_commitChanges();
+        commitChanges();
     }
     else if (input->contains("surface"))
     {
         ilmErrorTypes callResult = ilm_surfaceSetVisibility(id, visibility);
         if (ILM_SUCCESS != callResult)
         {
-            cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+            printIlmError(callResult);
             cout << "Failed to set visibility " << visibility << " for surface with ID " << id << "\n";
             return;
         }
 
-        ilm_commitChanges();
+        commitChanges();
     }
 }
 
@@ -322,12 +346,12 @@ COMMAND("set surface <surfaceid> type <type>")
     ilmErrorTypes callResult = ilm_surfaceSetType(id, type);
     if (ILM_SUCCESS != callResult)
     {
-        cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+        printIlmError(callResult);
         cout << "Failed to set type " << type << " for surface with ID " << id << "\n";
         return;
     }
 
-    ilm_commitChanges();
+    commitChanges();
 }
 
 //=============================================================================
@@ -346,12 +370,12 @@ COMMAND("set screen|layer <id> render order [<idarray>]")
             ilmErrorTypes callResult = ilm_displaySetRenderOrder(screenid, array, count);
             if (ILM_SUCCESS != callResult)
             {
-                cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+                printIlmError(callResult);
                 cout << "Failed to set render order for screen with ID " << screenid << "\n";
                 return;
             }
 
-            ilm_commitChanges();
+            commitChanges();
             delete[] array;
         }
         else
@@ -361,12 +385,12 @@ COMMAND("set screen|layer <id> render order [<idarray>]")
             ilmErrorTypes callResult = ilm_displaySetRenderOrder(screenid, NULL, 0);
             if (ILM_SUCCESS != callResult)
             {
-                cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+                printIlmError(callResult);
                 cout << "Failed to set render order for screen with ID " << screenid << "\n";
                 return;
             }
 
-            ilm_commitChanges();
+            commitChanges();
         }
     }
     else if (input->contains("layer"))
@@ -381,12 +405,12 @@ COMMAND("set screen|layer <id> render order [<idarray>]")
             ilmErrorTypes callResult = ilm_layerSetRenderOrder(layerid, array, count);
             if (ILM_SUCCESS != callResult)
             {
-                cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+                printIlmError(callResult);
                 cout << "Failed to set render order for layer with ID " << layerid << "\n";
                 return;
             }
 
-            ilm_commitChanges();
+            commitChanges();
             delete[] array;
         }
         else
@@ -396,12 +420,12 @@ COMMAND("set screen|layer <id> render order [<idarray>]")
             ilmErrorTypes callResult = ilm_layerSetRenderOrder(layerid, NULL, 0);
             if (ILM_SUCCESS != callResult)
             {
-                cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+                printIlmError(callResult);
                 cout << "Failed to set render order for layer with ID " << layerid << "\n";
                 return;
             }
 
-            ilm_commitChanges();
+            commitChanges();
         }
     }
 }
@@ -417,7 +441,7 @@ COMMAND("create layer <layerid> <width> <height>")
     ilmErrorTypes callResult = ilm_layerCreateWithDimension(&layerid, width, height);
     if (ILM_SUCCESS != callResult)
     {
-        cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+        printIlmError(callResult);
         cout << "Failed to create layer with ID " << layerid << "\n";
         return;
     }
@@ -432,12 +456,12 @@ COMMAND("destroy layer <id>")
     ilmErrorTypes callResult = ilm_layerRemove(layerid);
     if (ILM_SUCCESS != callResult)
     {
-        cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+        printIlmError(callResult);
         cout << "Failed to remove layer with ID " << layerid << "\n";
         return;
     }
 
-    ilm_commitChanges();
+    commitChanges();
 }
 
 //=============================================================================
@@ -450,12 +474,12 @@ COMMAND("add surface <sid> to layer <lid>")
     ilmErrorTypes callResult = ilm_layerAddSurface(lid, sid);
     if (ILM_SUCCESS != callResult)
     {
-        cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+        printIlmError(callResult);
         cout << "Failed to add surface (" << sid << " ) to layer (" << lid << " ) " << "\n";
         return;
     }
 
-    ilm_commitChanges();
+    commitChanges();
 }
 
 //=============================================================================
@@ -468,12 +492,12 @@ COMMAND("remove surface <sid> from layer <lid>")
     ilmErrorTypes callResult = ilm_layerRemoveSurface(lid, sid);
     if (ILM_SUCCESS != callResult)
     {
-        cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+        printIlmError(callResult);
         cout << "Failed to remove surface (" << sid << " ) from layer (" << lid << " ) " << "\n";
         return;
     }
 
-    ilm_commitChanges();
+    commitChanges();
 }
 
 //=============================================================================
@@ -509,6 +533,14 @@ COMMAND("watch layer|surface <idarray>")
     }
 }
 
+//=============================================================================
+COMMAND("watch scene")
+//=============================================================================
+{
+    (void)input;
+    watchScene();
+}
+
 //=============================================================================
 COMMAND("analyze surface <surfaceid>")
 //=============================================================================
@@ -43,6 +43,39 @@ using std::vector;
 #include <sys/types.h>
 #include <unistd.h>
 
+namespace
+{
+t_ilm_bool commitsDeferred = ILM_FALSE;
+bool commandFailed = false;
+}
+
+void printIlmError(ilmErrorTypes result)
+{
+    commandFailed = true;
+    cout << "LayerManagerService returned: " << ILM_ERROR_STRING(result) << "\n";
+}
+
+bool takeCommandFailed()
+{
+    bool failed = commandFailed;
+    commandFailed = false;
+    return failed;
+}
+
+ilmErrorTypes commitChanges()
+{
+    if (commitsDeferred)
+    {
+        return ILM_SUCCESS;
+    }
+
+    return ilm_commitChanges();
+}
+
+void setCommitsDeferred(t_ilm_bool deferred)
+{
+    commitsDeferred = deferred;
+}
 
 tuple4 getSurfaceScreenCoordinates(ilmSurfaceProperties targetSurfaceProperties, ilmLayerProperties targetLayerProperties)
 {
@@ -138,7 +171,7 @@ void captureSceneData(t_scene_data* pScene)
     ilmErrorTypes callResult = ilm_getScreenResolution(0, &screenWidth, &screenHeight);
     if (ILM_SUCCESS != callResult)
     {
-        cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+        printIlmError(callResult);
         cout << "Failed to get screen resolution for screen with ID " << 0 << "\n";
         return;
     }
@@ -156,7 +189,7 @@ void captureSceneData(t_scene_data* pScene)
     callResult = ilm_getScreenIDs(&screenCount, &screenArray);
     if (ILM_SUCCESS != callResult)
     {
-        cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+        printIlmError(callResult);
         cout << "Failed to get available screen IDs\n";
         return;
     }
@@ -174,7 +207,7 @@ void captureSceneData(t_scene_data* pScene)
         callResult = ilm_getLayerIDsOnScreen(screenId, &layerCount, &layerArray);
         if (ILM_SUCCESS != callResult)
         {
-            cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+            printIlmError(callResult);
             cout << "Failed to get layers on screen with ID " << screenId << "\n";
             return;
         }
@@ -206,7 +239,7 @@ void captureSceneData(t_scene_data* pScene)
         callResult = ilm_getPropertiesOfLayer(layerId, &lp);
         if (ILM_SUCCESS != callResult)
         {
-            cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+            printIlmError(callResult);
             cout << "Failed to get properties of layer with ID " << layerId << "\n";
             return;
         }
@@ -226,7 +259,7 @@ void captureSceneData(t_scene_data* pScene)
         callResult = ilm_getSurfaceIDsOnLayer(layerId, &surfaceCount, &surfaceArray);
         if (ILM_SUCCESS != callResult)
         {
-            cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+            printIlmError(callResult);
             cout << "Failed to get surfaces on layer with ID " << layerId << "\n";
             return;
         }
@@ -249,7 +282,7 @@ void captureSceneData(t_scene_data* pScene)
     callResult = ilm_getSurfaceIDs(&surfaceCount, &surfaceArray);
     if (ILM_SUCCESS != callResult)
     {
-        cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+        printIlmError(callResult);
         cout << "Failed to get available surfaces\n";
         return;
     }
@@ -266,7 +299,7 @@ void captureSceneData(t_scene_data* pScene)
         callResult = ilm_getPropertiesOfSurface(surfaceId, &sp);
         if (ILM_SUCCESS != callResult)
         {
-            cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+            printIlmError(callResult);
             cout << "Failed to get properties of surface with ID " << surfaceId << "\n";
             return;
         }
@@ -33,8 +33,26 @@ using std::endl;
 using std::dec;
 using std::hex;
 
+#include <map>
+using std::map;
+
+#include <sstream>
+using std::ostringstream;
+
+#include <vector>
+using std::vector;
+
+#include <utility>
+using std::make_pair;
+using std::pair;
+
+#include <cmath>
+#include <cstdio>
+#include <time.h>
+
 
 #include <pthread.h>
+#include <semaphore.h>
 #include <signal.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -79,7 +97,7 @@ void testNotificationLayer(t_ilm_layer layerid)
     ilmErrorTypes callResult = ilm_layerAddNotification(layerid, layerNotificationCallback);
     if (ILM_SUCCESS != callResult)
     {
-        cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+        printIlmError(callResult);
         cout << "Failed to add notification callback to layer with ID " << layerid << "\n";
         return;
     }
@@ -118,7 +136,7 @@ void watchLayer(unsigned int* layerids, unsigned int layeridCount)
         ilmErrorTypes callResult = ilm_layerAddNotification(layerid, layerNotificationCallback);
         if (ILM_SUCCESS != callResult)
         {
-            cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+            printIlmError(callResult);
             cout << "Failed to add notification callback to layer with ID " << layerid << "\n";
             return;
         }
@@ -136,7 +154,7 @@ void watchLayer(unsigned int* layerids, unsigned int layeridCount)
         ilmErrorTypes callResult = ilm_layerRemoveNotification(layerid);
         if (ILM_SUCCESS != callResult)
         {
-            cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+            printIlmError(callResult);
             cout << "Failed to remove notification callback of layer with ID " << layerid << "\n";
             return;
         }
@@ -191,7 +209,7 @@ void watchSurface(unsigned int* surfaceids, unsigned int surfaceidCount)
         ilmErrorTypes callResult = ilm_surfaceAddNotification(surfaceid, surfaceNotificationCallback);
         if (ILM_SUCCESS != callResult)
         {
-            cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+            printIlmError(callResult);
             cout << "Failed to add notification callback to surface with ID " << surfaceid << "\n";
             return;
         }
@@ -209,7 +227,7 @@ void watchSurface(unsigned int* surfaceids, unsigned int surfaceidCount)
         ilmErrorTypes callResult = ilm_surfaceRemoveNotification(surfaceid);
         if (ILM_SUCCESS != callResult)
         {
-            cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+            printIlmError(callResult);
             cout << "Failed to remove notification callback of surface with ID " << surfaceid << "\n";
             return;
         }
@@ -220,3 +238,252 @@ void watchSurface(unsigned int* surfaceids, unsigned int surfaceidCount)
         delete[] surfaceids;
     }
 }
+
+namespace
+{
+
+/*
+ * Per object statistics of "watch scene", the rates and gaps are of the
+ * property changes only
+ */
+struct WatchStats
+{
+    unsigned long events;
+    unsigned long long lastUs;
+    unsigned long long minGapUs;
+    unsigned long long maxGapUs;
+    unsigned long long sumGapUs;
+};
+
+pthread_mutex_t watchMutex = PTHREAD_MUTEX_INITIALIZER;
+map<pair<ilmObjectType, t_ilm_uint>, WatchStats> watchStats;
+volatile sig_atomic_t watchRunning = 0;
+// posted by the signal handler, which may run on any thread
+sem_t watchStopped;
+
+unsigned long long monotonicUs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+const char* objectTypeName(ilmObjectType object)
+{
+    return ILM_SURFACE == object ? "surface" : "layer";
+}
+
+void stopWatch(int sig)
+{
+    (void)sig;
+    watchRunning = 0;
+    sem_post(&watchStopped);
+}
+
+/*
+ * Writes an event as one JSON line and updates the statistics of the object,
+ * the properties are written for the bits of the mask only
+ */
+void writeWatchEvent(ilmObjectType object, t_ilm_uint id, const char* event,
+                     unsigned int mask, t_ilm_int* src, t_ilm_int* dst,
+                     t_ilm_bool visibility, t_ilm_float opacity)
+{
+    unsigned long long now = monotonicUs();
+    bool changed = (0 == strcmp(event, "changed"));
+    ostringstream line;
+
+    line << "{\"t_us\":" << now << ",\"type\":\"" << objectTypeName(object)
+         << "\",\"id\":" << id << ",\"event\":\"" << event << "\"";
+
+    if (mask)
+    {
+        line << ",\"mask\":" << mask;
+    }
+
+    // without properties, only the mask is known
+    if (!src)
+    {
+        mask &= ~(ILM_NOTIFICATION_VISIBILITY | ILM_NOTIFICATION_OPACITY |
+                  ILM_NOTIFICATION_SOURCE_RECT | ILM_NOTIFICATION_DEST_RECT);
+    }
+
+    if (ILM_NOTIFICATION_VISIBILITY & mask)
+    {
+        line << ",\"visibility\":" << (visibility ? 1 : 0);
+    }
+
+    // JSON has no NaN or infinity
+    if (ILM_NOTIFICATION_OPACITY & mask)
+    {
+        line << ",\"opacity\":";
+        if (std::isfinite(opacity))
+        {
+            line << opacity;
+        }
+        else
+        {
+            line << "null";
+        }
+    }
+
+    if (ILM_NOTIFICATION_SOURCE_RECT & mask)
+    {
+        line << ",\"src\":[" << src[0] << "," << src[1] << "," << src[2] << "," << src[3] << "]";
+    }
+
+    if (ILM_NOTIFICATION_DEST_RECT & mask)
+    {
+        line << ",\"dst\":[" << dst[0] << "," << dst[1] << "," << dst[2] << "," << dst[3] << "]";
+    }
+
+    line << "}\n";
+
+    pthread_mutex_lock(&watchMutex);
+
+    cout << line.str() << std::flush;
+
+    WatchStats& stats = watchStats[make_pair(object, id)];
+    if (changed)
+    {
+        if (stats.events > 0)
+        {
+            unsigned long long gap = now - stats.lastUs;
+            stats.minGapUs = (stats.events == 1 || gap < stats.minGapUs) ? gap : stats.minGapUs;
+            stats.maxGapUs = gap > stats.maxGapUs ? gap : stats.maxGapUs;
+            stats.sumGapUs += gap;
+        }
+        stats.events++;
+        stats.lastUs = now;
+    }
+
+    pthread_mutex_unlock(&watchMutex);
+}
+
+void watchLayerCallback(t_ilm_layer layer, struct ilmLayerProperties* properties, t_ilm_notification_mask mask)
+{
+    if (!properties)
+    {
+        writeWatchEvent(ILM_LAYER, layer, "changed", mask, NULL, NULL, ILM_FALSE, 0.0);
+        return;
+    }
+
+    t_ilm_int src[4] = { (t_ilm_int)properties->sourceX, (t_ilm_int)properties->sourceY,
+                         (t_ilm_int)properties->sourceWidth, (t_ilm_int)properties->sourceHeight };
+    t_ilm_int dst[4] = { (t_ilm_int)properties->destX, (t_ilm_int)properties->destY,
+                         (t_ilm_int)properties->destWidth, (t_ilm_int)properties->destHeight };
+
+    writeWatchEvent(ILM_LAYER, layer, "changed", mask, src, dst,
+                    properties->visibility, properties->opacity);
+}
+
+void watchSurfaceCallback(t_ilm_surface surface, struct ilmSurfaceProperties* properties, t_ilm_notification_mask mask)
+{
+    if (!properties)
+    {
+        writeWatchEvent(ILM_SURFACE, surface, "changed", mask, NULL, NULL, ILM_FALSE, 0.0);
+        return;
+    }
+
+    t_ilm_int src[4] = { (t_ilm_int)properties->sourceX, (t_ilm_int)properties->sourceY,
+                         (t_ilm_int)properties->sourceWidth, (t_ilm_int)properties->sourceHeight };
+    t_ilm_int dst[4] = { (t_ilm_int)properties->destX, (t_ilm_int)properties->destY,
+                         (t_ilm_int)properties->destWidth, (t_ilm_int)properties->destHeight };
+
+    writeWatchEvent(ILM_SURFACE, surface, "changed", mask, src, dst,
+                    properties->visibility, properties->opacity);
+}
+
+void watchObjectCallback(ilmObjectType object, t_ilm_uint id, t_ilm_bool created, void* user_data)
+{
+    (void)user_data;
+
+    writeWatchEvent(object, id, created ? "created" : "destroyed", 0, NULL, NULL, ILM_FALSE, 0.0);
+}
+
+} // namespace
+
+void watchScene()
+{
+    struct sigaction action;
+    struct sigaction oldIntAction;
+    struct sigaction oldTermAction;
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = stopWatch;
+    sigaction(SIGINT, &action, &oldIntAction);
+    sigaction(SIGTERM, &action, &oldTermAction);
+
+    watchStats.clear();
+    sem_init(&watchStopped, 0, 0);
+    watchRunning = 1;
+    unsigned long long start = monotonicUs();
+
+    // one subscription for the properties of all objects, it covers new
+    // objects from their creation on
+    ilmErrorTypes callResult = ilm_surfaceAddNotificationAll(watchSurfaceCallback, ILM_NOTIFICATION_ALL);
+    if (ILM_SUCCESS == callResult)
+    {
+        callResult = ilm_layerAddNotificationAll(watchLayerCallback, ILM_NOTIFICATION_ALL);
+    }
+
+    // reports the existing objects as created, and every object created later
+    if (ILM_SUCCESS == callResult)
+    {
+        callResult = ilm_registerNotification(watchObjectCallback, NULL);
+    }
+
+    if (ILM_SUCCESS != callResult)
+    {
+        printIlmError(callResult);
+        cout << "Failed to register for notifications\n";
+        watchRunning = 0;
+    }
+
+    // the lines are written from the notification thread
+    while (watchRunning)
+    {
+        sem_wait(&watchStopped);
+    }
+
+    ilm_unregisterNotification();
+    ilm_surfaceRemoveNotificationAll();
+    ilm_layerRemoveNotificationAll();
+    sem_destroy(&watchStopped);
+
+    pthread_mutex_lock(&watchMutex);
+    map<pair<ilmObjectType, t_ilm_uint>, WatchStats> stats = watchStats;
+    pthread_mutex_unlock(&watchMutex);
+
+    // rates over the whole watch, gaps between the events of an object
+    double seconds = (monotonicUs() - start) / 1000000.0;
+
+    pthread_mutex_lock(&watchMutex);
+    map<pair<ilmObjectType, t_ilm_uint>, WatchStats>::const_iterator iter = stats.begin();
+    for (; iter != stats.end(); ++iter)
+    {
+        const WatchStats& objectStats = iter->second;
+        unsigned long gaps = objectStats.events - 1;
+
+        cout << "{\"type\":\"" << objectTypeName(iter->first.first)
+             << "\",\"id\":" << iter->first.second
+             << ",\"event\":\"stats\",\"events\":" << objectStats.events
+             << ",\"rate_hz\":" << std::fixed << std::setprecision(3)
+             << (seconds > 0.0 ? objectStats.events / seconds : 0.0);
+        cout.unsetf(std::ios_base::floatfield);
+        cout << std::setprecision(6);
+
+        if (objectStats.events > 1)
+        {
+            cout << ",\"gap_min_us\":" << objectStats.minGapUs
+                 << ",\"gap_avg_us\":" << objectStats.sumGapUs / gaps
+                 << ",\"gap_max_us\":" << objectStats.maxGapUs;
+        }
+
+        cout << "}\n";
+    }
+    cout.flush();
+    pthread_mutex_unlock(&watchMutex);
+
+    sigaction(SIGINT, &oldIntAction, NULL);
+    sigaction(SIGTERM, &oldTermAction, NULL);
+}
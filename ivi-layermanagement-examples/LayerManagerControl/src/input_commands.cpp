@@ -65,7 +65,7 @@ COMMAND3(50,"get input devices with pointer|keyboard|touch|all")
     ilmErrorTypes callResult = ilm_getInputDevices(mask, &num_seats, &seats);
     if (ILM_SUCCESS != callResult)
     {
-        cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+        printIlmError(callResult);
         cout << "Failed to get input devices for mask " << input->getUint("mask") << "\n";
         return;
     }
@@ -108,7 +108,7 @@ COMMAND3(51,"set|unset surfaces [<idarray>] input focus pointer|keyboard|touch|a
         ilm_setInputFocus(surfaceIDs, num_surfaces, bitmask, is_set);
     if (ILM_SUCCESS != callResult)
     {
-        cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << endl;
+        printIlmError(callResult);
         cout << "Failed to set input focus" << endl;
     }
     else
@@ -130,7 +130,7 @@ COMMAND3(52,"get input focus")
     ilmErrorTypes callResult = ilm_getInputFocus(&surfaceIDs, &bitmasks, &num_ids);
     if (ILM_SUCCESS != callResult)
     {
-        cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << endl;
+        printIlmError(callResult);
         cout << "Failed to get input focus" << endl;
     }
     else
@@ -157,7 +157,7 @@ COMMAND3(53,"get input device <name> capabilities")
         ilm_getInputDeviceCapabilities((char*)input->getString("name").c_str(), &bitmask);
     if (ILM_SUCCESS != callResult)
     {
-        cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+        printIlmError(callResult);
         cout << "Failed to get capabilities for device " << input->getString("name") << "\n";
         return;
     }
@@ -220,8 +220,7 @@ COMMAND3(54,"set surface <surfaceid> input acceptance to [<namearray>]")
 
     if (ILM_SUCCESS != callResult)
     {
-        cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult)
-             << endl;
+        printIlmError(callResult);
         cout << "Failed to set acceptance for surface " << surfaceid << endl;
     }
 }
@@ -238,8 +237,7 @@ COMMAND3(55,"get surface <surfaceid> input acceptance")
                                                         &array);
     if (ILM_SUCCESS != callResult)
     {
-        cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult)
-             << endl;
+        printIlmError(callResult);
         cout << "Failed to get acceptance for surface " << surfaceid << endl;
         return;
     }
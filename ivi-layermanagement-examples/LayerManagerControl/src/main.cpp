@@ -17,13 +17,109 @@
  *
  ****************************************************************************/
 #include "ExpressionInterpreter.h"
+#include "LMControl.h"
 #include <iostream>
+#include <fstream>
+#include <cstring>
 using namespace std;
 
+/*
+ * LayerManagerControl --server <socket>
+ *
+ * keeps one connection and runs the commands sent over the unix domain socket.
+ * The watch commands are not supported by the server.
+ *
+ * LayerManagerControl --connect <socket> [<command>]
+ *
+ * runs the command, or the commands of stdin, on the server of the socket.
+ *
+ * LayerManagerControl --batch <file|-> [--single-commit]
+ *
+ * runs the commands of the file, or of stdin for '-', one per line over one
+ * connection. With --single-commit, the changes of all commands are committed
+ * at once after the last command.
+ */
+static int runBatch(ExpressionInterpreter& interpreter, int argc, char* argv[])
+{
+    const char* fileName = NULL;
+    bool singleCommit = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (0 == strcmp(argv[i], "--batch") && i + 1 < argc)
+        {
+            fileName = argv[++i];
+        }
+        else if (0 == strcmp(argv[i], "--single-commit"))
+        {
+            singleCommit = true;
+        }
+        else
+        {
+            cerr << "usage: " << argv[0] << " --batch <file|-> [--single-commit]" << endl;
+            return 1;
+        }
+    }
+
+    if (!fileName)
+    {
+        cerr << "usage: " << argv[0] << " --batch <file|-> [--single-commit]" << endl;
+        return 1;
+    }
+
+    CommandResult result;
+
+    if (0 == strcmp(fileName, "-"))
+    {
+        result = interpreter.interpretScript(cin, singleCommit);
+    }
+    else
+    {
+        ifstream script(fileName);
+        if (!script)
+        {
+            cerr << "Failed to open " << fileName << endl;
+            return 1;
+        }
+
+        result = interpreter.interpretScript(script, singleCommit);
+    }
+
+    if (CommandSuccess != result)
+    {
+        cerr << "Interpreter error: " << interpreter.getLastError() << endl;
+        return 1;
+    }
+
+    return 0;
+}
+
 int main(int argc, char* argv[])
 {
     ExpressionInterpreter interpreter;
 
+    if (argc == 3 && 0 == strcmp(argv[1], "--server"))
+    {
+        return runServer(argv[2]);
+    }
+
+    if (argc > 2 && 0 == strcmp(argv[1], "--connect"))
+    {
+        string command;
+        for (int i = 3; i < argc; ++i)
+        {
+            command += (i > 3 ? " " : "");
+            command += argv[i];
+        }
+
+        return runClient(argv[2], command);
+    }
+
+    if (argc > 1 && 0 == strncmp(argv[1], "--", 2))
+    {
+        return runBatch(interpreter, argc, argv);
+    }
+
     // create full string of arguments
     string userCommand;
 
@@ -89,7 +89,7 @@ void printScreenProperties(unsigned int screenid, const char* prefix)
     ilmErrorTypes callResult = ilm_getPropertiesOfScreen(screenid, &screenProperties);
     if (ILM_SUCCESS != callResult)
     {
-        cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+        printIlmError(callResult);
         cout << "Failed to get properties of screen with ID " << screenid << " found\n";
         return;
     }
@@ -122,7 +122,7 @@ void printLayerProperties(unsigned int layerid, const char* prefix)
     ilmErrorTypes callResult = ilm_getPropertiesOfLayer(layerid, &p);
     if (ILM_SUCCESS != callResult)
     {
-        cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+        printIlmError(callResult);
         cout << "Failed to get properties of layer with ID " << layerid << " found\n";
         return;
     }
@@ -145,7 +145,7 @@ void printLayerProperties(unsigned int layerid, const char* prefix)
     callResult = ilm_getSurfaceIDsOnLayer(layerid, &surfaceCount, &surfaceArray);
     if (ILM_SUCCESS != callResult)
     {
-        cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+        printIlmError(callResult);
         cout << "Failed to get surfaces on layer with ID " << layerid << " \n";
         return;
     }
@@ -166,7 +166,7 @@ void printLayerProperties(unsigned int layerid, const char* prefix)
     callResult = ilm_getScreenIDs(&screenCount, &screenArray);
     if (ILM_SUCCESS != callResult)
     {
-        cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+        printIlmError(callResult);
         cout << "Failed to get available screens\n";
         return;
     }
@@ -181,7 +181,7 @@ void printLayerProperties(unsigned int layerid, const char* prefix)
         callResult = ilm_getLayerIDsOnScreen(screenid, &layerCount, &layerArray);
         if (ILM_SUCCESS != callResult)
         {
-            cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+            printIlmError(callResult);
             cout << "Failed to get available layers on screen with ID" << screenid << "\n";
             return;
         }
@@ -213,7 +213,7 @@ void printSurfaceProperties(unsigned int surfaceid, const char* prefix)
     ilmErrorTypes callResult = ilm_getPropertiesOfSurface(surfaceid, &p);
     if (ILM_SUCCESS != callResult)
     {
-        cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+        printIlmError(callResult);
         cout << "No surface with ID " << surfaceid << " found\n";
         return;
     }
@@ -240,7 +240,7 @@ void printSurfaceProperties(unsigned int surfaceid, const char* prefix)
     callResult = ilm_getLayerIDs(&layerCount, &layerArray);
     if (ILM_SUCCESS != callResult)
     {
-        cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+        printIlmError(callResult);
         cout << "Failed to get available layer IDs\n";
         return;
     }
@@ -254,7 +254,7 @@ void printSurfaceProperties(unsigned int surfaceid, const char* prefix)
         callResult = ilm_getSurfaceIDsOnLayer(layerid, &surfaceCount, &surfaceArray);
         if (ILM_SUCCESS != callResult)
         {
-            cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+            printIlmError(callResult);
             cout << "Failed to get surface IDs on layer" << layerid << "\n";
             return;
         }
@@ -284,7 +284,7 @@ void printScene()
     ilmErrorTypes callResult = ilm_getScreenIDs(&screenCount, &screenArray);
     if (ILM_SUCCESS != callResult)
     {
-        cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+        printIlmError(callResult);
         cout << "Failed to get available screen IDs\n";
         return;
     }
@@ -301,7 +301,7 @@ void printScene()
         callResult = ilm_getLayerIDsOnScreen(screenid, &layerCount, &layerArray);
         if (ILM_SUCCESS != callResult)
         {
-            cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+            printIlmError(callResult);
             cout << "Failed to get available layers on screen with ID" << screenid << "\n";
             return;
         }
@@ -318,7 +318,7 @@ void printScene()
             callResult = ilm_getSurfaceIDsOnLayer(layerid, &surfaceCount, &surfaceArray);
             if (ILM_SUCCESS != callResult)
             {
-                cout << "LayerManagerService returned: " << ILM_ERROR_STRING(callResult) << "\n";
+                printIlmError(callResult);
                 cout << "Failed to get available surfaces on layer with ID" << layerid << "\n";
                 return;
             }
@@ -0,0 +1,458 @@
+/***************************************************************************
+ *
+ * Copyright 2026 agent <agent@local>
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ****************************************************************************/
+#include "ExpressionInterpreter.h"
+#include "LMControl.h"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+/*
+ * Protocol: the client sends one command per line. For every command, the
+ * server sends the output of the command followed by a status line, which
+ * is ".ok" or ".error <text>". Output lines starting with '.' are sent with
+ * an additional leading '.'.
+ *
+ * The client sockets are non-blocking. The output of a client is buffered
+ * and written, when poll reports the socket as writable. While output is
+ * pending, no further commands of the client are run.
+ */
+
+namespace
+{
+
+volatile sig_atomic_t serverRunning = 1;
+
+void stopServer(int sig)
+{
+    (void)sig;
+    serverRunning = 0;
+}
+
+struct Client
+{
+    int fd;
+    string input;
+    string output;
+};
+
+bool fillSocketAddress(struct sockaddr_un* addr, const char* socketPath)
+{
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+
+    if (strlen(socketPath) >= sizeof(addr->sun_path))
+    {
+        cerr << "Socket path too long: " << socketPath << endl;
+        return false;
+    }
+
+    strcpy(addr->sun_path, socketPath);
+    return true;
+}
+
+bool writeAll(int fd, const string& data)
+{
+    size_t written = 0;
+
+    while (written < data.size())
+    {
+        ssize_t ret = write(fd, data.data() + written, data.size() - written);
+        if (ret < 0 && errno == EINTR)
+        {
+            continue;
+        }
+
+        if (ret <= 0)
+        {
+            return false;
+        }
+
+        written += ret;
+    }
+
+    return true;
+}
+
+// returns false, if the client is gone
+bool flushOutput(Client& client)
+{
+    while (!client.output.empty())
+    {
+        ssize_t ret = write(client.fd, client.output.data(), client.output.size());
+        if (ret < 0 && errno == EINTR)
+        {
+            continue;
+        }
+
+        if (ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            return true;
+        }
+
+        if (ret <= 0)
+        {
+            return false;
+        }
+
+        client.output.erase(0, ret);
+    }
+
+    return true;
+}
+
+// the watch commands read stdin or run until SIGINT, which would block
+// the server and all of its clients
+bool isServerCommand(const string& command)
+{
+    istringstream words(command);
+    string word;
+    words >> word;
+    return word != "watch";
+}
+
+string runCommand(ExpressionInterpreter& interpreter, const string& command)
+{
+    if (!isServerCommand(command))
+    {
+        return ".error '" + command + "' is not supported by the server.\n";
+    }
+
+    ostringstream output;
+
+    // the commands print their results to cout
+    streambuf* coutBuffer = cout.rdbuf(output.rdbuf());
+    CommandResult result = interpreter.interpretCommand(command);
+    cout.rdbuf(coutBuffer);
+
+    string response;
+    istringstream lines(output.str());
+    string line;
+
+    while (getline(lines, line))
+    {
+        if (!line.empty() && line[0] == '.')
+        {
+            response += '.';
+        }
+
+        response += line + "\n";
+    }
+
+    if (CommandSuccess == result)
+    {
+        response += ".ok\n";
+    }
+    else
+    {
+        response += ".error " + interpreter.getLastError() + "\n";
+    }
+
+    return response;
+}
+
+// runs the buffered commands of the client up to the first one, whose
+// output cannot be written completely, returns false, if the client is gone
+bool runCommands(ExpressionInterpreter& interpreter, Client& client)
+{
+    size_t end;
+    while (client.output.empty() &&
+           (end = client.input.find('\n')) != string::npos)
+    {
+        string command = client.input.substr(0, end);
+        client.input.erase(0, end + 1);
+
+        if (!command.empty() && command[command.size() - 1] == '\r')
+        {
+            command.erase(command.size() - 1);
+        }
+
+        if (command.find_first_not_of(" \t") == string::npos)
+        {
+            continue;
+        }
+
+        client.output = runCommand(interpreter, command);
+        if (!flushOutput(client))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// returns false, if the client is gone
+bool serveClient(ExpressionInterpreter& interpreter, Client& client, short revents)
+{
+    if ((revents & POLLOUT) && !flushOutput(client))
+    {
+        return false;
+    }
+
+    if (revents & (POLLIN | POLLHUP | POLLERR))
+    {
+        char buffer[4096];
+        ssize_t ret = read(client.fd, buffer, sizeof(buffer));
+
+        if (ret < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            return true;
+        }
+
+        if (ret <= 0)
+        {
+            return false;
+        }
+
+        client.input.append(buffer, ret);
+    }
+
+    return runCommands(interpreter, client);
+}
+
+} // namespace
+
+int runServer(const char* socketPath)
+{
+    struct sockaddr_un addr;
+    if (!fillSocketAddress(&addr, socketPath))
+    {
+        return 1;
+    }
+
+    int listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listenFd < 0)
+    {
+        cerr << "Failed to create socket: " << strerror(errno) << endl;
+        return 1;
+    }
+
+    // a socket left over by a previous server, any other file is kept
+    struct stat st;
+    if (lstat(socketPath, &st) == 0)
+    {
+        if (!S_ISSOCK(st.st_mode))
+        {
+            cerr << socketPath << " exists and is not a socket" << endl;
+            close(listenFd);
+            return 1;
+        }
+
+        unlink(socketPath);
+    }
+
+    if (bind(listenFd, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+        listen(listenFd, 16) < 0)
+    {
+        cerr << "Failed to listen on " << socketPath << ": " << strerror(errno) << endl;
+        close(listenFd);
+        return 1;
+    }
+
+    ExpressionInterpreter interpreter;
+    if (CommandSuccess != interpreter.connect())
+    {
+        cerr << "Interpreter error: " << interpreter.getLastError() << endl;
+        close(listenFd);
+        unlink(socketPath);
+        return 1;
+    }
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = stopServer;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    vector<Client> clients;
+
+    // the commands of all clients are run one after the other on the
+    // connection and scene of the server
+    while (serverRunning)
+    {
+        vector<struct pollfd> fds(clients.size() + 1);
+        fds[0].fd = listenFd;
+        fds[0].events = POLLIN;
+        for (size_t i = 0; i < clients.size(); ++i)
+        {
+            fds[i + 1].fd = clients[i].fd;
+            fds[i + 1].events = clients[i].output.empty() ? POLLIN : POLLOUT;
+        }
+
+        if (poll(&fds[0], fds.size(), -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            cerr << "poll failed: " << strerror(errno) << endl;
+            break;
+        }
+
+        for (size_t i = clients.size(); i > 0; --i)
+        {
+            if (fds[i].revents && !serveClient(interpreter, clients[i - 1], fds[i].revents))
+            {
+                close(clients[i - 1].fd);
+                clients.erase(clients.begin() + (i - 1));
+            }
+        }
+
+        if (fds[0].revents & POLLIN)
+        {
+            Client client;
+            client.fd = accept4(listenFd, NULL, NULL, SOCK_CLOEXEC | SOCK_NONBLOCK);
+            if (client.fd >= 0)
+            {
+                clients.push_back(client);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < clients.size(); ++i)
+    {
+        close(clients[i].fd);
+    }
+
+    interpreter.disconnect();
+    close(listenFd);
+    unlink(socketPath);
+
+    return 0;
+}
+
+int runClient(const char* socketPath, const string& command)
+{
+    struct sockaddr_un addr;
+    if (!fillSocketAddress(&addr, socketPath))
+    {
+        return 1;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0)
+    {
+        cerr << "Failed to connect to " << socketPath << ": " << strerror(errno) << endl;
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        return 1;
+    }
+
+    // the command of the arguments, or the commands of stdin
+    bool fromStdin = command.empty();
+    int result = 0;
+    string input;
+    string line = command;
+    char buffer[4096];
+
+    for (;;)
+    {
+        if (fromStdin)
+        {
+            if (!getline(cin, line))
+            {
+                break;
+            }
+
+            if (line.find_first_not_of(" \t\r") == string::npos)
+            {
+                continue;
+            }
+        }
+
+        if (!writeAll(fd, line + "\n"))
+        {
+            cerr << "Connection to server lost" << endl;
+            result = 1;
+            break;
+        }
+
+        // print the output up to the status line
+        bool done = false;
+        while (!done)
+        {
+            size_t end;
+            while (!done && (end = input.find('\n')) != string::npos)
+            {
+                string response = input.substr(0, end);
+                input.erase(0, end + 1);
+
+                if (response == ".ok")
+                {
+                    done = true;
+                }
+                else if (response.compare(0, 7, ".error ") == 0)
+                {
+                    cerr << "Interpreter error: " << response.substr(7) << endl;
+                    result = 1;
+                    done = true;
+                }
+                else
+                {
+                    cout << (response.compare(0, 2, "..") == 0 ? response.substr(1) : response) << "\n";
+                }
+            }
+
+            if (done)
+            {
+                break;
+            }
+
+            ssize_t ret = read(fd, buffer, sizeof(buffer));
+            if (ret < 0 && errno == EINTR)
+            {
+                continue;
+            }
+
+            if (ret <= 0)
+            {
+                cerr << "Connection to server lost" << endl;
+                close(fd);
+                return 1;
+            }
+
+            input.append(buffer, ret);
+        }
+
+        cout.flush();
+
+        if (!fromStdin)
+        {
+            break;
+        }
+    }
+
+    close(fd);
+    return result;
+}
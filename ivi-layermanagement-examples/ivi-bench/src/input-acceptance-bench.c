@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and
+ * its documentation for any purpose is hereby granted without fee, provided
+ * that the above copyright notice appear in all copies and that both that
+ * copyright notice and this permission notice appear in supporting
+ * documentation, and that the name of the copyright holders not be used in
+ * advertising or publicity pertaining to distribution of the software
+ * without specific, written prior permission.  The copyright holders make
+ * no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS
+ * SOFTWARE, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS, IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER
+ * RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+ * CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+
+/*
+ * Benchmark of the input acceptance requests of ilmInput: the default seat
+ * is accepted and removed again on a number of surfaces of this client,
+ * with one ilm_setInputAcceptanceOn per surface, which sends
+ * set_input_acceptance_handle, and with one ilm_setInputConfig for all
+ * surfaces, which sends set_input_batch. Both wait for the compositor, so
+ * the result is the time per surface including the round trips.
+ *
+ * usage: input-acceptance-bench [<surfaces>] [<iterations>]
+ *
+ * Needs a compositor with ivi-controller and ivi-input-controller.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <wayland-client.h>
+#include "ivi-application-client-protocol.h"
+#include "ilm_control.h"
+#include "ilm_input.h"
+
+#define BENCH_SURFACE 0xb2000
+
+struct bench {
+    struct wl_display *display;
+    struct wl_compositor *compositor;
+    struct ivi_application *ivi_application;
+    int num_surfaces;
+};
+
+static double
+now_usec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000.0 + ts.tv_nsec / 1000.0;
+}
+
+static void
+registry_handle_global(void *data, struct wl_registry *registry,
+                       uint32_t name, const char *interface, uint32_t version)
+{
+    struct bench *bench = data;
+
+    if (!strcmp(interface, "wl_compositor")) {
+        bench->compositor = wl_registry_bind(registry, name,
+                                             &wl_compositor_interface, 1);
+    } else if (!strcmp(interface, "ivi_application")) {
+        bench->ivi_application = wl_registry_bind(registry, name,
+                                                  &ivi_application_interface, 1);
+    }
+}
+
+static void
+registry_handle_global_remove(void *data, struct wl_registry *registry,
+                              uint32_t name)
+{
+}
+
+static const struct wl_registry_listener registry_listener = {
+    registry_handle_global,
+    registry_handle_global_remove
+};
+
+static int
+create_surfaces(struct bench *bench)
+{
+    struct wl_surface *surface;
+    int i;
+
+    for (i = 0; i < bench->num_surfaces; i++) {
+        surface = wl_compositor_create_surface(bench->compositor);
+        ivi_application_surface_create(bench->ivi_application,
+                                       BENCH_SURFACE + i, surface);
+    }
+
+    return wl_display_roundtrip(bench->display) < 0 ? -1 : 0;
+}
+
+static int
+toggle_each(struct bench *bench, t_ilm_string *seat, int iterations)
+{
+    int i, j;
+
+    for (i = 0; i < iterations; i++) {
+        for (j = 0; j < bench->num_surfaces; j++) {
+            if (ilm_setInputAcceptanceOn(BENCH_SURFACE + j, (i + 1) % 2,
+                                         seat) != ILM_SUCCESS)
+                return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int
+toggle_batch(struct bench *bench, t_ilm_string *seat, int iterations)
+{
+    struct ilmInputConfig *configs;
+    int i, j;
+
+    configs = calloc(bench->num_surfaces, sizeof *configs);
+    if (configs == NULL)
+        return -1;
+
+    for (j = 0; j < bench->num_surfaces; j++) {
+        configs[j].surfaceID = BENCH_SURFACE + j;
+        configs[j].setAcceptance = ILM_TRUE;
+        configs[j].seats = seat;
+    }
+
+    for (i = 0; i < iterations; i++) {
+        for (j = 0; j < bench->num_surfaces; j++)
+            configs[j].numSeats = (i + 1) % 2;
+
+        if (ilm_setInputConfig(bench->num_surfaces, configs) != ILM_SUCCESS) {
+            free(configs);
+            return -1;
+        }
+    }
+
+    free(configs);
+    return 0;
+}
+
+int
+main(int argc, char **argv)
+{
+    struct bench bench = { 0 };
+    struct wl_registry *registry;
+    t_ilm_string seat = NULL;
+    int iterations;
+    double start, each_usec, batch_usec;
+
+    bench.num_surfaces = argc > 1 ? atoi(argv[1]) : 64;
+    iterations = argc > 2 ? atoi(argv[2]) : 100;
+    if (bench.num_surfaces <= 0 || iterations <= 0) {
+        fprintf(stderr, "usage: %s [<surfaces>] [<iterations>]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    bench.display = wl_display_connect(NULL);
+    if (bench.display == NULL) {
+        fprintf(stderr, "failed to connect to the compositor: %m\n");
+        return EXIT_FAILURE;
+    }
+
+    registry = wl_display_get_registry(bench.display);
+    wl_registry_add_listener(registry, &registry_listener, &bench);
+    wl_display_roundtrip(bench.display);
+
+    if (!bench.compositor || !bench.ivi_application) {
+        fprintf(stderr, "wl_compositor or ivi_application is missing\n");
+        return EXIT_FAILURE;
+    }
+
+    if (create_surfaces(&bench) < 0 || ilm_init() != ILM_SUCCESS ||
+        ilm_getDefaultSeat(&seat) != ILM_SUCCESS) {
+        fprintf(stderr, "failed to create the surfaces or to get the "
+                "default seat\n");
+        return EXIT_FAILURE;
+    }
+
+    start = now_usec();
+    if (toggle_each(&bench, &seat, iterations) < 0) {
+        fprintf(stderr, "failed to set the input acceptance\n");
+        return EXIT_FAILURE;
+    }
+    each_usec = now_usec() - start;
+
+    start = now_usec();
+    if (toggle_batch(&bench, &seat, iterations) < 0) {
+        fprintf(stderr, "failed to set the input config\n");
+        return EXIT_FAILURE;
+    }
+    batch_usec = now_usec() - start;
+
+    printf("surfaces: %d, iterations: %d, per surface: "
+           "ilm_setInputAcceptanceOn %.2f usec, ilm_setInputConfig %.2f usec\n",
+           bench.num_surfaces, iterations,
+           each_usec / iterations / bench.num_surfaces,
+           batch_usec / iterations / bench.num_surfaces);
+
+    free(seat);
+    ilm_destroy();
+    wl_display_disconnect(bench.display);
+
+    return EXIT_SUCCESS;
+}
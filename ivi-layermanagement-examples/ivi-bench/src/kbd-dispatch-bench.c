@@ -0,0 +1,428 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and
+ * its documentation for any purpose is hereby granted without fee, provided
+ * that the above copyright notice appear in all copies and that both that
+ * copyright notice and this permission notice appear in supporting
+ * documentation, and that the name of the copyright holders not be used in
+ * advertising or publicity pertaining to distribution of the software
+ * without specific, written prior permission.  The copyright holders make
+ * no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS
+ * SOFTWARE, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS, IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER
+ * RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+ * CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+
+/*
+ * Benchmark of the keyboard event fan-out of ivi-input-controller: the keys
+ * of a virtual uinput keyboard are sent to a number of surfaces of this
+ * client, which all have the keyboard focus, and to a number of wl_keyboard
+ * resources of the client. Every key is pressed and released, and the next
+ * key is only sent when all wl_keyboard.key events of the previous one
+ * arrived, so the result is the time from the input event to the client per
+ * key, including the dispatch in the compositor.
+ *
+ * usage: kbd-dispatch-bench [<surfaces>] [<keyboards>] [<keys>]
+ *
+ * Needs write access to /dev/uinput and a compositor with ivi-controller
+ * and ivi-input-controller on a backend which reads libinput devices, e.g.
+ * the drm backend.
+ */
+
+#include <fcntl.h>
+#include <linux/uinput.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <wayland-client.h>
+#include "ivi-application-client-protocol.h"
+#include "ilm_control.h"
+#include "ilm_input.h"
+
+#define BENCH_LAYER 0xb0001
+#define BENCH_SURFACE 0xb1000
+#define WIDTH 64
+#define HEIGHT 64
+#define MAX_KEYBOARDS 64
+
+struct bench {
+    struct wl_display *display;
+    struct wl_compositor *compositor;
+    struct wl_shm *shm;
+    struct wl_seat *seat;
+    struct ivi_application *ivi_application;
+    struct wl_keyboard *keyboards[MAX_KEYBOARDS];
+    int num_surfaces;
+    int num_keyboards;
+    bool has_keyboard;
+    unsigned int keys_received;
+};
+
+static double
+now_usec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000.0 + ts.tv_nsec / 1000.0;
+}
+
+static void
+keyboard_handle_keymap(void *data, struct wl_keyboard *keyboard,
+                       uint32_t format, int32_t fd, uint32_t size)
+{
+    close(fd);
+}
+
+static void
+keyboard_handle_enter(void *data, struct wl_keyboard *keyboard,
+                      uint32_t serial, struct wl_surface *surface,
+                      struct wl_array *keys)
+{
+}
+
+static void
+keyboard_handle_leave(void *data, struct wl_keyboard *keyboard,
+                      uint32_t serial, struct wl_surface *surface)
+{
+}
+
+static void
+keyboard_handle_key(void *data, struct wl_keyboard *keyboard,
+                    uint32_t serial, uint32_t time, uint32_t key,
+                    uint32_t state)
+{
+    struct bench *bench = data;
+
+    bench->keys_received++;
+}
+
+static void
+keyboard_handle_modifiers(void *data, struct wl_keyboard *keyboard,
+                          uint32_t serial, uint32_t mods_depressed,
+                          uint32_t mods_latched, uint32_t mods_locked,
+                          uint32_t group)
+{
+}
+
+static const struct wl_keyboard_listener keyboard_listener = {
+    keyboard_handle_keymap,
+    keyboard_handle_enter,
+    keyboard_handle_leave,
+    keyboard_handle_key,
+    keyboard_handle_modifiers
+};
+
+static void
+seat_handle_capabilities(void *data, struct wl_seat *seat, uint32_t caps)
+{
+    struct bench *bench = data;
+
+    bench->has_keyboard = caps & WL_SEAT_CAPABILITY_KEYBOARD;
+}
+
+static const struct wl_seat_listener seat_listener = {
+    seat_handle_capabilities
+};
+
+static void
+registry_handle_global(void *data, struct wl_registry *registry,
+                       uint32_t name, const char *interface, uint32_t version)
+{
+    struct bench *bench = data;
+
+    if (!strcmp(interface, "wl_compositor")) {
+        bench->compositor = wl_registry_bind(registry, name,
+                                             &wl_compositor_interface, 1);
+    } else if (!strcmp(interface, "wl_shm")) {
+        bench->shm = wl_registry_bind(registry, name, &wl_shm_interface, 1);
+    } else if (!strcmp(interface, "ivi_application")) {
+        bench->ivi_application = wl_registry_bind(registry, name,
+                                                  &ivi_application_interface, 1);
+    } else if (!strcmp(interface, "wl_seat") && !bench->seat) {
+        /* the first seat is the default seat */
+        bench->seat = wl_registry_bind(registry, name, &wl_seat_interface, 1);
+        wl_seat_add_listener(bench->seat, &seat_listener, bench);
+    }
+}
+
+static void
+registry_handle_global_remove(void *data, struct wl_registry *registry,
+                              uint32_t name)
+{
+}
+
+static const struct wl_registry_listener registry_listener = {
+    registry_handle_global,
+    registry_handle_global_remove
+};
+
+static struct wl_buffer *
+create_buffer(struct bench *bench)
+{
+    char name[] = "/tmp/kbd-dispatch-bench-XXXXXX";
+    struct wl_shm_pool *pool;
+    struct wl_buffer *buffer;
+    int fd;
+
+    fd = mkstemp(name);
+    if (fd < 0)
+        return NULL;
+
+    unlink(name);
+    if (ftruncate(fd, WIDTH * HEIGHT * 4) < 0) {
+        close(fd);
+        return NULL;
+    }
+
+    pool = wl_shm_create_pool(bench->shm, fd, WIDTH * HEIGHT * 4);
+    buffer = wl_shm_pool_create_buffer(pool, 0, WIDTH, HEIGHT, WIDTH * 4,
+                                       WL_SHM_FORMAT_XRGB8888);
+    wl_shm_pool_destroy(pool);
+    close(fd);
+
+    return buffer;
+}
+
+static int
+create_surfaces(struct bench *bench)
+{
+    struct wl_buffer *buffer = create_buffer(bench);
+    struct wl_surface *surface;
+    int i;
+
+    if (buffer == NULL)
+        return -1;
+
+    for (i = 0; i < bench->num_surfaces; i++) {
+        surface = wl_compositor_create_surface(bench->compositor);
+        ivi_application_surface_create(bench->ivi_application,
+                                       BENCH_SURFACE + i, surface);
+        wl_surface_attach(surface, buffer, 0, 0);
+        wl_surface_damage(surface, 0, 0, WIDTH, HEIGHT);
+        wl_surface_commit(surface);
+    }
+
+    return wl_display_roundtrip(bench->display) < 0 ? -1 : 0;
+}
+
+/* puts the surfaces on a layer of the first screen and focuses all of them */
+static int
+focus_surfaces(struct bench *bench)
+{
+    t_ilm_surface *surface_ids;
+    t_ilm_layer layer = BENCH_LAYER;
+    t_ilm_uint num_screens = 0, *screen_ids = NULL;
+    ilmErrorTypes result;
+    int i;
+
+    surface_ids = calloc(bench->num_surfaces, sizeof *surface_ids);
+    if (surface_ids == NULL ||
+        ilm_getScreenIDs(&num_screens, &screen_ids) != ILM_SUCCESS ||
+        num_screens == 0 ||
+        ilm_layerCreateWithDimension(&layer, WIDTH, HEIGHT) != ILM_SUCCESS) {
+        free(surface_ids);
+        free(screen_ids);
+        return -1;
+    }
+
+    for (i = 0; i < bench->num_surfaces; i++) {
+        surface_ids[i] = BENCH_SURFACE + i;
+        ilm_layerAddSurface(layer, surface_ids[i]);
+        ilm_surfaceSetVisibility(surface_ids[i], ILM_TRUE);
+    }
+
+    ilm_layerSetVisibility(layer, ILM_TRUE);
+    ilm_displaySetRenderOrder(screen_ids[0], &layer, 1);
+    free(screen_ids);
+
+    result = ilm_commitChanges();
+    if (result == ILM_SUCCESS)
+        result = ilm_setInputFocus(surface_ids, bench->num_surfaces,
+                                   ILM_INPUT_DEVICE_KEYBOARD, ILM_TRUE);
+
+    free(surface_ids);
+    return result == ILM_SUCCESS ? 0 : -1;
+}
+
+static int
+create_uinput_keyboard(void)
+{
+    struct uinput_user_dev dev;
+    int fd;
+
+    fd = open("/dev/uinput", O_WRONLY | O_CLOEXEC);
+    if (fd < 0)
+        return -1;
+
+    memset(&dev, 0, sizeof dev);
+    snprintf(dev.name, sizeof dev.name, "kbd-dispatch-bench");
+    dev.id.bustype = BUS_VIRTUAL;
+
+    if (ioctl(fd, UI_SET_EVBIT, EV_KEY) < 0 ||
+        ioctl(fd, UI_SET_KEYBIT, KEY_A) < 0 ||
+        write(fd, &dev, sizeof dev) != sizeof dev ||
+        ioctl(fd, UI_DEV_CREATE) < 0) {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+static int
+emit(int fd, uint16_t type, uint16_t code, int32_t value)
+{
+    struct input_event event;
+
+    memset(&event, 0, sizeof event);
+    event.type = type;
+    event.code = code;
+    event.value = value;
+
+    return write(fd, &event, sizeof event) == sizeof event ? 0 : -1;
+}
+
+static int
+send_key(int fd, int32_t value)
+{
+    if (emit(fd, EV_KEY, KEY_A, value) < 0 ||
+        emit(fd, EV_SYN, SYN_REPORT, 0) < 0)
+        return -1;
+
+    return 0;
+}
+
+/* waits for the key events of every focused surface on every wl_keyboard */
+static int
+wait_for_keys(struct bench *bench, unsigned int count)
+{
+    while (bench->keys_received < count) {
+        if (wl_display_dispatch(bench->display) < 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+int
+main(int argc, char **argv)
+{
+    struct bench bench = { 0 };
+    struct wl_registry *registry;
+    unsigned int per_key, expected = 0;
+    int num_keys, uinput, i;
+    double start, elapsed;
+
+    bench.num_surfaces = argc > 1 ? atoi(argv[1]) : 8;
+    bench.num_keyboards = argc > 2 ? atoi(argv[2]) : 4;
+    num_keys = argc > 3 ? atoi(argv[3]) : 1000;
+    if (bench.num_surfaces <= 0 || bench.num_keyboards <= 0 ||
+        bench.num_keyboards > MAX_KEYBOARDS || num_keys <= 0) {
+        fprintf(stderr, "usage: %s [<surfaces>] [<keyboards> (1..%d)] "
+                "[<keys>]\n", argv[0], MAX_KEYBOARDS);
+        return EXIT_FAILURE;
+    }
+
+    uinput = create_uinput_keyboard();
+    if (uinput < 0) {
+        fprintf(stderr, "failed to create a uinput keyboard: %m\n");
+        return EXIT_FAILURE;
+    }
+
+    bench.display = wl_display_connect(NULL);
+    if (bench.display == NULL) {
+        fprintf(stderr, "failed to connect to the compositor: %m\n");
+        return EXIT_FAILURE;
+    }
+
+    registry = wl_display_get_registry(bench.display);
+    wl_registry_add_listener(registry, &registry_listener, &bench);
+    wl_display_roundtrip(bench.display);
+
+    if (!bench.compositor || !bench.shm || !bench.ivi_application ||
+        !bench.seat) {
+        fprintf(stderr, "wl_compositor, wl_shm, ivi_application or wl_seat "
+                "is missing\n");
+        return EXIT_FAILURE;
+    }
+
+    /* the compositor adds the uinput keyboard to the seat */
+    for (i = 0; i < 50 && !bench.has_keyboard; i++) {
+        usleep(100000);
+        wl_display_roundtrip(bench.display);
+    }
+
+    if (!bench.has_keyboard) {
+        fprintf(stderr, "the seat got no keyboard\n");
+        return EXIT_FAILURE;
+    }
+
+    for (i = 0; i < bench.num_keyboards; i++) {
+        bench.keyboards[i] = wl_seat_get_keyboard(bench.seat);
+        wl_keyboard_add_listener(bench.keyboards[i], &keyboard_listener,
+                                 &bench);
+    }
+
+    if (create_surfaces(&bench) < 0 || ilm_init() != ILM_SUCCESS ||
+        focus_surfaces(&bench) < 0) {
+        fprintf(stderr, "failed to create and focus the surfaces\n");
+        return EXIT_FAILURE;
+    }
+
+    wl_display_roundtrip(bench.display);
+
+    /* one key to count the wl_keyboard.key events of a key */
+    bench.keys_received = 0;
+    if (send_key(uinput, 1) < 0 || send_key(uinput, 0) < 0) {
+        fprintf(stderr, "failed to write to the uinput keyboard: %m\n");
+        return EXIT_FAILURE;
+    }
+
+    usleep(200000);
+    wl_display_roundtrip(bench.display);
+    per_key = bench.keys_received;
+    if (per_key == 0) {
+        fprintf(stderr, "the surfaces got no key events\n");
+        return EXIT_FAILURE;
+    }
+
+    bench.keys_received = 0;
+    start = now_usec();
+
+    for (i = 0; i < num_keys; i++) {
+        expected += per_key;
+        if (send_key(uinput, 1) < 0 || send_key(uinput, 0) < 0 ||
+            wait_for_keys(&bench, expected) < 0) {
+            fprintf(stderr, "failed to send key %d\n", i);
+            return EXIT_FAILURE;
+        }
+    }
+
+    elapsed = now_usec() - start;
+    printf("surfaces: %d, keyboards: %d, keys: %d, key events per key: %u, "
+           "%.1f usec/key\n", bench.num_surfaces, bench.num_keyboards,
+           num_keys, per_key, elapsed / num_keys);
+
+    ilm_layerRemove(BENCH_LAYER);
+    ilm_commitChanges();
+    ilm_destroy();
+    wl_display_disconnect(bench.display);
+    ioctl(uinput, UI_DEV_DESTROY);
+    close(uinput);
+
+    return EXIT_SUCCESS;
+}
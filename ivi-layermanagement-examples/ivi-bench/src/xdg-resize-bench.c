@@ -0,0 +1,424 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and
+ * its documentation for any purpose is hereby granted without fee, provided
+ * that the above copyright notice appear in all copies and that both that
+ * copyright notice and this permission notice appear in supporting
+ * documentation, and that the name of the copyright holders not be used in
+ * advertising or publicity pertaining to distribution of the software
+ * without specific, written prior permission.  The copyright holders make
+ * no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS
+ * SOFTWARE, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS, IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER
+ * RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+ * CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+
+/*
+ * Benchmark of the configure handling of desktop surfaces in ivi-controller:
+ * a number of xdg toplevels change their size at the same time, like at
+ * startup or on a resolution change. Every round attaches buffers of the
+ * other size to all surfaces and waits for their frame callbacks. The
+ * configure_commits counter of the compositor tells how many layout commits
+ * the round cost.
+ *
+ * usage: xdg-resize-bench [<surfaces>] [<rounds>]
+ *
+ * Needs a compositor with ivi-controller and ivi-id-agent with a
+ * [desktop-app-default] section, e.g. weston --backend=headless.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <wayland-client.h>
+#include "xdg-shell-client-protocol.h"
+#include "ilm_control.h"
+
+#define BENCH_LAYER 0xb0000
+#define SMALL_WIDTH 200
+#define SMALL_HEIGHT 150
+#define LARGE_WIDTH 320
+#define LARGE_HEIGHT 240
+
+struct bench_surface {
+    struct wl_surface *surface;
+    struct xdg_surface *xdg_surface;
+    struct xdg_toplevel *toplevel;
+    struct wl_buffer *buffers[2];
+    bool configured;
+    bool frame_done;
+};
+
+struct bench {
+    struct wl_display *display;
+    struct wl_compositor *compositor;
+    struct wl_shm *shm;
+    struct xdg_wm_base *wm_base;
+    struct bench_surface *surfaces;
+    int num_surfaces;
+};
+
+static double
+now_usec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000.0 + ts.tv_nsec / 1000.0;
+}
+
+static void
+wm_base_ping(void *data, struct xdg_wm_base *wm_base, uint32_t serial)
+{
+    xdg_wm_base_pong(wm_base, serial);
+}
+
+static const struct xdg_wm_base_listener wm_base_listener = {
+    wm_base_ping
+};
+
+static void
+registry_handle_global(void *data, struct wl_registry *registry,
+                       uint32_t name, const char *interface, uint32_t version)
+{
+    struct bench *bench = data;
+
+    if (!strcmp(interface, "wl_compositor")) {
+        bench->compositor = wl_registry_bind(registry, name,
+                                             &wl_compositor_interface, 1);
+    } else if (!strcmp(interface, "wl_shm")) {
+        bench->shm = wl_registry_bind(registry, name, &wl_shm_interface, 1);
+    } else if (!strcmp(interface, "xdg_wm_base")) {
+        bench->wm_base = wl_registry_bind(registry, name,
+                                          &xdg_wm_base_interface, 1);
+        xdg_wm_base_add_listener(bench->wm_base, &wm_base_listener, bench);
+    }
+}
+
+static void
+registry_handle_global_remove(void *data, struct wl_registry *registry,
+                              uint32_t name)
+{
+}
+
+static const struct wl_registry_listener registry_listener = {
+    registry_handle_global,
+    registry_handle_global_remove
+};
+
+static void
+xdg_surface_handle_configure(void *data, struct xdg_surface *xdg_surface,
+                             uint32_t serial)
+{
+    struct bench_surface *surf = data;
+
+    xdg_surface_ack_configure(xdg_surface, serial);
+    surf->configured = true;
+}
+
+static const struct xdg_surface_listener xdg_surface_listener = {
+    xdg_surface_handle_configure
+};
+
+static void
+toplevel_handle_configure(void *data, struct xdg_toplevel *toplevel,
+                          int32_t width, int32_t height,
+                          struct wl_array *states)
+{
+}
+
+static void
+toplevel_handle_close(void *data, struct xdg_toplevel *toplevel)
+{
+}
+
+static const struct xdg_toplevel_listener toplevel_listener = {
+    toplevel_handle_configure,
+    toplevel_handle_close
+};
+
+static void
+frame_handle_done(void *data, struct wl_callback *callback, uint32_t time)
+{
+    struct bench_surface *surf = data;
+
+    surf->frame_done = true;
+    wl_callback_destroy(callback);
+}
+
+static const struct wl_callback_listener frame_listener = {
+    frame_handle_done
+};
+
+/* two buffers of every surface, the small ones first, in one pool */
+static int
+create_buffers(struct bench *bench)
+{
+    const int small_size = SMALL_WIDTH * SMALL_HEIGHT * 4;
+    const int large_size = LARGE_WIDTH * LARGE_HEIGHT * 4;
+    const int size = bench->num_surfaces * (small_size + large_size);
+    char name[] = "/tmp/xdg-resize-bench-XXXXXX";
+    struct wl_shm_pool *pool;
+    int fd, i, offset = 0;
+
+    fd = mkstemp(name);
+    if (fd < 0)
+        return -1;
+
+    unlink(name);
+    if (ftruncate(fd, size) < 0) {
+        close(fd);
+        return -1;
+    }
+
+    pool = wl_shm_create_pool(bench->shm, fd, size);
+    for (i = 0; i < bench->num_surfaces; i++) {
+        bench->surfaces[i].buffers[0] =
+                wl_shm_pool_create_buffer(pool, offset,
+                                          SMALL_WIDTH, SMALL_HEIGHT,
+                                          SMALL_WIDTH * 4,
+                                          WL_SHM_FORMAT_XRGB8888);
+        offset += small_size;
+        bench->surfaces[i].buffers[1] =
+                wl_shm_pool_create_buffer(pool, offset,
+                                          LARGE_WIDTH, LARGE_HEIGHT,
+                                          LARGE_WIDTH * 4,
+                                          WL_SHM_FORMAT_XRGB8888);
+        offset += large_size;
+    }
+
+    wl_shm_pool_destroy(pool);
+    close(fd);
+    return 0;
+}
+
+static void
+attach_all(struct bench *bench, int size)
+{
+    struct bench_surface *surf;
+    struct wl_callback *callback;
+    int i;
+
+    for (i = 0; i < bench->num_surfaces; i++) {
+        surf = &bench->surfaces[i];
+        surf->frame_done = false;
+
+        callback = wl_surface_frame(surf->surface);
+        wl_callback_add_listener(callback, &frame_listener, surf);
+        wl_surface_attach(surf->surface, surf->buffers[size], 0, 0);
+        wl_surface_damage(surf->surface, 0, 0, LARGE_WIDTH, LARGE_HEIGHT);
+        wl_surface_commit(surf->surface);
+    }
+}
+
+static int
+wait_for_frames(struct bench *bench)
+{
+    int i;
+
+    for (i = 0; i < bench->num_surfaces; i++) {
+        while (!bench->surfaces[i].frame_done) {
+            if (wl_display_dispatch(bench->display) < 0)
+                return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int
+create_surfaces(struct bench *bench)
+{
+    struct bench_surface *surf;
+    char app_id[64];
+    int i;
+
+    for (i = 0; i < bench->num_surfaces; i++) {
+        surf = &bench->surfaces[i];
+        surf->surface = wl_compositor_create_surface(bench->compositor);
+        surf->xdg_surface = xdg_wm_base_get_xdg_surface(bench->wm_base,
+                                                        surf->surface);
+        xdg_surface_add_listener(surf->xdg_surface, &xdg_surface_listener,
+                                 surf);
+        surf->toplevel = xdg_surface_get_toplevel(surf->xdg_surface);
+        xdg_toplevel_add_listener(surf->toplevel, &toplevel_listener, surf);
+
+        snprintf(app_id, sizeof app_id, "xdg-resize-bench-%d", i);
+        xdg_toplevel_set_app_id(surf->toplevel, app_id);
+        wl_surface_commit(surf->surface);
+    }
+
+    for (i = 0; i < bench->num_surfaces; i++) {
+        while (!bench->surfaces[i].configured) {
+            if (wl_display_dispatch(bench->display) < 0)
+                return -1;
+        }
+    }
+
+    attach_all(bench, 0);
+    return wl_display_roundtrip(bench->display) < 0 ? -1 : 0;
+}
+
+/* puts the surfaces of this process on a layer on top of the first screen */
+static int
+show_surfaces(struct bench *bench)
+{
+    struct ilmSurfaceProperties props;
+    t_ilm_surface *surface_ids = NULL;
+    t_ilm_layer *layer_ids = NULL, *order;
+    t_ilm_uint num_screens = 0, *screen_ids = NULL;
+    t_ilm_layer layer = BENCH_LAYER;
+    t_ilm_int num_ids = 0, num_layers = 0, found = 0, i;
+
+    if (ilm_getScreenIDs(&num_screens, &screen_ids) != ILM_SUCCESS ||
+        num_screens == 0 ||
+        ilm_getLayerIDsOnScreen(screen_ids[0], &num_layers,
+                                &layer_ids) != ILM_SUCCESS ||
+        ilm_layerCreateWithDimension(&layer, 1920, 1080) != ILM_SUCCESS ||
+        ilm_getSurfaceIDs(&num_ids, &surface_ids) != ILM_SUCCESS)
+        goto failed;
+
+    for (i = 0; i < num_ids; i++) {
+        if (ilm_getPropertiesOfSurface(surface_ids[i], &props) != ILM_SUCCESS ||
+            props.creatorPid != getpid())
+            continue;
+
+        ilm_layerAddSurface(layer, surface_ids[i]);
+        ilm_surfaceSetVisibility(surface_ids[i], ILM_TRUE);
+        found++;
+    }
+
+    order = calloc(num_layers + 1, sizeof *order);
+    if (order == NULL)
+        goto failed;
+
+    memcpy(order, layer_ids, num_layers * sizeof *order);
+    order[num_layers] = layer;
+    ilm_layerSetVisibility(layer, ILM_TRUE);
+    ilm_displaySetRenderOrder(screen_ids[0], order, num_layers + 1);
+    free(order);
+
+    if (ilm_commitChanges() != ILM_SUCCESS)
+        goto failed;
+
+    free(surface_ids);
+    free(layer_ids);
+    free(screen_ids);
+    return found == bench->num_surfaces ? 0 : -1;
+
+failed:
+    free(surface_ids);
+    free(layer_ids);
+    free(screen_ids);
+    return -1;
+}
+
+static uint64_t
+get_stat(const char *name)
+{
+    struct ilmCompositorStat *stats = NULL;
+    t_ilm_int length = 0, i;
+    uint64_t value = 0;
+
+    if (ilm_getCompositorStats(&length, &stats) != ILM_SUCCESS)
+        return 0;
+
+    /* counters which are still 0 may be left out */
+    for (i = 0; i < length; i++) {
+        if (!strcmp(stats[i].name, name))
+            value = stats[i].value;
+    }
+
+    free(stats);
+    return value;
+}
+
+int
+main(int argc, char **argv)
+{
+    struct bench bench = { 0 };
+    struct wl_registry *registry;
+    int rounds, i;
+    uint64_t commits, surfaces;
+    double start, elapsed;
+
+    bench.num_surfaces = argc > 1 ? atoi(argv[1]) : 20;
+    rounds = argc > 2 ? atoi(argv[2]) : 100;
+    if (bench.num_surfaces <= 0 || rounds <= 0) {
+        fprintf(stderr, "usage: %s [<surfaces>] [<rounds>]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    bench.display = wl_display_connect(NULL);
+    if (bench.display == NULL) {
+        fprintf(stderr, "failed to connect to the compositor: %m\n");
+        return EXIT_FAILURE;
+    }
+
+    registry = wl_display_get_registry(bench.display);
+    wl_registry_add_listener(registry, &registry_listener, &bench);
+    wl_display_roundtrip(bench.display);
+
+    if (!bench.compositor || !bench.shm || !bench.wm_base) {
+        fprintf(stderr, "wl_compositor, wl_shm or xdg_wm_base is missing\n");
+        return EXIT_FAILURE;
+    }
+
+    bench.surfaces = calloc(bench.num_surfaces, sizeof *bench.surfaces);
+    if (bench.surfaces == NULL || create_buffers(&bench) < 0 ||
+        create_surfaces(&bench) < 0) {
+        fprintf(stderr, "failed to create the surfaces\n");
+        return EXIT_FAILURE;
+    }
+
+    if (ilm_init() != ILM_SUCCESS || show_surfaces(&bench) < 0) {
+        fprintf(stderr, "failed to put the surfaces on a layer, are they "
+                "given ids by ivi-id-agent?\n");
+        return EXIT_FAILURE;
+    }
+
+    /* the first frame after the surfaces became visible */
+    attach_all(&bench, 1);
+    if (wait_for_frames(&bench) < 0)
+        return EXIT_FAILURE;
+
+    commits = get_stat("configure_commits");
+    surfaces = get_stat("configure_surfaces");
+    start = now_usec();
+
+    for (i = 0; i < rounds; i++) {
+        attach_all(&bench, i % 2);
+        if (wait_for_frames(&bench) < 0) {
+            fprintf(stderr, "lost the connection to the compositor\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    elapsed = now_usec() - start;
+    commits = get_stat("configure_commits") - commits;
+    surfaces = get_stat("configure_surfaces") - surfaces;
+
+    printf("surfaces: %d, rounds: %d, %.1f usec/round\n",
+           bench.num_surfaces, rounds, elapsed / rounds);
+    printf("layout commits: %.2f/round, configured surfaces: %.2f/round\n",
+           (double)commits / rounds, (double)surfaces / rounds);
+
+    ilm_layerRemove(BENCH_LAYER);
+    ilm_commitChanges();
+    ilm_destroy();
+    wl_display_disconnect(bench.display);
+
+    return EXIT_SUCCESS;
+}
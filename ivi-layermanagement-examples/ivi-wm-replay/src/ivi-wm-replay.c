@@ -0,0 +1,786 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and
+ * its documentation for any purpose is hereby granted without fee, provided
+ * that the above copyright notice appear in all copies and that both that
+ * copyright notice and this permission notice appear in supporting
+ * documentation, and that the name of the copyright holders not be used in
+ * advertising or publicity pertaining to distribution of the software
+ * without specific, written prior permission.  The copyright holders make
+ * no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS
+ * SOFTWARE, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS, IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER
+ * RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+ * CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+
+/*
+ * Replays a trace of the ivi-wm-recorder debug scope of ivi-controller
+ * against a running compositor, e.g. a headless weston with ivi-shell.
+ * Every client of the trace gets its own connection. Requests with file
+ * descriptors, or with objects which are not known to the replay, like the
+ * buffers of screenshots, are skipped.
+ *
+ * The surfaces of the recorded applications are replaced by stand-ins of
+ * one more connection: ivi-application surfaces with the recorded ids and
+ * a single-colored shm buffer of the size the surface had when it was
+ * created, or 64x64 if it had no content yet. Later size changes and the
+ * content of the applications are not recorded, so checksums and
+ * screenshots differ from the recorded ones.
+ */
+
+#include <errno.h>
+#include <getopt.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <wayland-client.h>
+#include "ivi-wm-client-protocol.h"
+#include "ivi-input-client-protocol.h"
+#include "ivi-application-client-protocol.h"
+#include "ivi-wm-recorder.h"
+
+#define MAX_ARGS 20
+/* requests after which the events of a client are read */
+#define ROUNDTRIP_INTERVAL 256
+/* size of stand-in surfaces without a recorded size, and the largest one */
+#define STAND_IN_SIZE 64
+#define STAND_IN_MAX_SIZE 4096
+
+struct replay_object {
+    uint32_t recorded_id;
+    struct wl_proxy *proxy;
+};
+
+struct replay_client {
+    uint32_t index;
+    struct wl_display *display;
+    struct wl_registry *registry;
+    struct wl_proxy *ivi_wm;
+    struct wl_proxy *ivi_input;
+    struct wl_proxy *output;
+    struct wl_array objects;
+    uint32_t requests;
+    /* the connection failed, its requests are skipped */
+    bool failed;
+    struct wl_list link;
+};
+
+struct stand_in {
+    uint32_t id;
+    struct wl_surface *surface;
+    struct ivi_surface *ivi_surface;
+    struct wl_buffer *buffer;
+    struct wl_list link;
+};
+
+/* the connection of the stand-ins of the recorded application surfaces */
+struct stand_in_client {
+    struct wl_display *display;
+    struct wl_registry *registry;
+    struct wl_compositor *compositor;
+    struct wl_shm *shm;
+    struct ivi_application *ivi_application;
+    struct wl_list surfaces;
+    bool failed;
+};
+
+struct replay {
+    const char *display_name;
+    struct wl_list clients;
+    struct stand_in_client stand_ins;
+    uint32_t replayed;
+    uint32_t skipped;
+};
+
+static const struct wl_interface *record_interfaces[] = {
+    [IVI_WM_RECORD_IVI_WM] = &ivi_wm_interface,
+    [IVI_WM_RECORD_IVI_WM_SCREEN] = &ivi_wm_screen_interface,
+    [IVI_WM_RECORD_IVI_INPUT] = &ivi_input_interface,
+};
+
+static uint64_t
+now_usec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void
+registry_handle_global(void *data, struct wl_registry *registry,
+                       uint32_t name, const char *interface, uint32_t version)
+{
+    struct replay_client *client = data;
+
+    if (!strcmp(interface, "ivi_wm") && !client->ivi_wm) {
+        client->ivi_wm = wl_registry_bind(registry, name, &ivi_wm_interface,
+                                          version < 3 ? version : 3);
+    } else if (!strcmp(interface, "ivi_input") && !client->ivi_input) {
+        client->ivi_input = wl_registry_bind(registry, name,
+                                             &ivi_input_interface,
+                                             version < 3 ? version : 3);
+    } else if (!strcmp(interface, "wl_output") && !client->output) {
+        client->output = wl_registry_bind(registry, name,
+                                          &wl_output_interface, 1);
+    }
+}
+
+static void
+registry_handle_global_remove(void *data, struct wl_registry *registry,
+                              uint32_t name)
+{
+    (void)data;
+    (void)registry;
+    (void)name;
+}
+
+static const struct wl_registry_listener registry_listener = {
+    registry_handle_global,
+    registry_handle_global_remove
+};
+
+/* Reports why a connection failed, returns true if it did */
+static bool
+check_display_error(struct wl_display *display, const char *name,
+                    uint32_t index)
+{
+    const struct wl_interface *interface;
+    uint32_t id, code;
+    int error = wl_display_get_error(display);
+
+    if (error == 0)
+        return false;
+
+    if (error == EPROTO) {
+        code = wl_display_get_protocol_error(display, &interface, &id);
+        fprintf(stderr, "%s %u: protocol error %u on %s@%u\n", name, index,
+                code, interface ? interface->name : "unknown", id);
+    } else {
+        fprintf(stderr, "%s %u: %s\n", name, index, strerror(error));
+    }
+
+    return true;
+}
+
+static void
+stand_in_registry_handle_global(void *data, struct wl_registry *registry,
+                                uint32_t name, const char *interface,
+                                uint32_t version)
+{
+    struct stand_in_client *stand_ins = data;
+    (void)version;
+
+    if (!strcmp(interface, "wl_compositor")) {
+        stand_ins->compositor = wl_registry_bind(registry, name,
+                                                 &wl_compositor_interface, 1);
+    } else if (!strcmp(interface, "wl_shm")) {
+        stand_ins->shm = wl_registry_bind(registry, name,
+                                          &wl_shm_interface, 1);
+    } else if (!strcmp(interface, "ivi_application")) {
+        stand_ins->ivi_application = wl_registry_bind(registry, name,
+                &ivi_application_interface, 1);
+    }
+}
+
+static const struct wl_registry_listener stand_in_registry_listener = {
+    stand_in_registry_handle_global,
+    registry_handle_global_remove
+};
+
+static struct stand_in_client *
+get_stand_in_client(struct replay *replay)
+{
+    struct stand_in_client *stand_ins = &replay->stand_ins;
+
+    if (stand_ins->failed)
+        return NULL;
+
+    if (stand_ins->display)
+        return stand_ins;
+
+    stand_ins->display = wl_display_connect(replay->display_name);
+    if (!stand_ins->display) {
+        fprintf(stderr, "failed to connect the stand-in surfaces: %s\n",
+                strerror(errno));
+        stand_ins->failed = true;
+        return NULL;
+    }
+
+    stand_ins->registry = wl_display_get_registry(stand_ins->display);
+    wl_registry_add_listener(stand_ins->registry,
+                             &stand_in_registry_listener, stand_ins);
+    wl_display_roundtrip(stand_ins->display);
+
+    if (!stand_ins->compositor || !stand_ins->shm ||
+        !stand_ins->ivi_application) {
+        fprintf(stderr, "wl_compositor, wl_shm or ivi_application is "
+                "missing, no stand-in surfaces are created\n");
+        stand_ins->failed = true;
+        return NULL;
+    }
+
+    return stand_ins;
+}
+
+static struct wl_buffer *
+create_stand_in_buffer(struct stand_in_client *stand_ins, uint32_t width,
+                       uint32_t height)
+{
+    char name[] = "/tmp/ivi-wm-replay-XXXXXX";
+    struct wl_shm_pool *pool;
+    struct wl_buffer *buffer;
+    size_t size = (size_t)width * height * 4;
+    uint32_t *pixels;
+    size_t i;
+    int fd;
+
+    fd = mkstemp(name);
+    if (fd < 0)
+        return NULL;
+
+    unlink(name);
+    if (ftruncate(fd, size) < 0) {
+        close(fd);
+        return NULL;
+    }
+
+    pixels = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (pixels == MAP_FAILED) {
+        close(fd);
+        return NULL;
+    }
+
+    for (i = 0; i < size / 4; i++)
+        pixels[i] = 0xff406080;
+    munmap(pixels, size);
+
+    pool = wl_shm_create_pool(stand_ins->shm, fd, size);
+    buffer = wl_shm_pool_create_buffer(pool, 0, width, height, width * 4,
+                                       WL_SHM_FORMAT_XRGB8888);
+    wl_shm_pool_destroy(pool);
+    close(fd);
+
+    return buffer;
+}
+
+static void
+destroy_stand_in(struct stand_in *stand_in)
+{
+    ivi_surface_destroy(stand_in->ivi_surface);
+    wl_surface_destroy(stand_in->surface);
+    if (stand_in->buffer)
+        wl_buffer_destroy(stand_in->buffer);
+    wl_list_remove(&stand_in->link);
+    free(stand_in);
+}
+
+/* Creates or removes the stand-in of an application surface, the requests
+ * of the controllers which follow may use it right away */
+static bool
+replay_surface(struct replay *replay, const struct ivi_wm_record *record,
+               const uint8_t *data)
+{
+    struct stand_in_client *stand_ins = get_stand_in_client(replay);
+    struct stand_in *stand_in, *found = NULL;
+    uint32_t size[2];
+
+    if (!stand_ins)
+        return false;
+
+    wl_list_for_each(stand_in, &stand_ins->surfaces, link) {
+        if (stand_in->id == record->object)
+            found = stand_in;
+    }
+
+    switch (record->opcode) {
+    case IVI_WM_RECORD_SURFACE_CREATED:
+        /* a new subscription records the existing surfaces again */
+        if (found)
+            return true;
+
+        if (record->size < sizeof size)
+            return false;
+
+        memcpy(size, data, sizeof size);
+        if (size[0] == 0 || size[1] == 0) {
+            size[0] = STAND_IN_SIZE;
+            size[1] = STAND_IN_SIZE;
+        }
+        if (size[0] > STAND_IN_MAX_SIZE)
+            size[0] = STAND_IN_MAX_SIZE;
+        if (size[1] > STAND_IN_MAX_SIZE)
+            size[1] = STAND_IN_MAX_SIZE;
+
+        found = calloc(1, sizeof *found);
+        if (!found)
+            return false;
+
+        found->id = record->object;
+        found->surface = wl_compositor_create_surface(stand_ins->compositor);
+        found->ivi_surface = ivi_application_surface_create(
+                stand_ins->ivi_application, found->id, found->surface);
+        found->buffer = create_stand_in_buffer(stand_ins, size[0], size[1]);
+        wl_list_insert(&stand_ins->surfaces, &found->link);
+
+        if (found->buffer) {
+            wl_surface_attach(found->surface, found->buffer, 0, 0);
+            wl_surface_damage(found->surface, 0, 0, size[0], size[1]);
+        }
+        wl_surface_commit(found->surface);
+        break;
+    case IVI_WM_RECORD_SURFACE_REMOVED:
+        if (!found)
+            return false;
+
+        destroy_stand_in(found);
+        break;
+    default:
+        return false;
+    }
+
+    if (wl_display_roundtrip(stand_ins->display) < 0) {
+        check_display_error(stand_ins->display, "stand-in client", 0);
+        stand_ins->failed = true;
+        return false;
+    }
+
+    return true;
+}
+
+static struct replay_client *
+get_client(struct replay *replay, uint32_t index)
+{
+    struct replay_client *client;
+
+    wl_list_for_each(client, &replay->clients, link) {
+        if (client->index == index)
+            return (client->display && !client->failed) ? client : NULL;
+    }
+
+    client = calloc(1, sizeof *client);
+    if (!client)
+        return NULL;
+
+    client->index = index;
+    wl_array_init(&client->objects);
+    wl_list_insert(replay->clients.prev, &client->link);
+
+    client->display = wl_display_connect(replay->display_name);
+    if (!client->display) {
+        fprintf(stderr, "failed to connect client %u: %s\n", index,
+                strerror(errno));
+        return NULL;
+    }
+
+    client->registry = wl_display_get_registry(client->display);
+    wl_registry_add_listener(client->registry, &registry_listener, client);
+    wl_display_roundtrip(client->display);
+
+    return client;
+}
+
+static struct replay_object *
+find_object(struct replay_client *client, uint32_t recorded_id)
+{
+    struct replay_object *object;
+
+    wl_array_for_each(object, &client->objects) {
+        if (object->recorded_id == recorded_id)
+            return object;
+    }
+
+    return NULL;
+}
+
+static void
+add_object(struct replay_client *client, uint32_t recorded_id,
+           struct wl_proxy *proxy)
+{
+    struct replay_object *object = find_object(client, recorded_id);
+
+    if (!object)
+        object = wl_array_add(&client->objects, sizeof *object);
+
+    if (object) {
+        object->recorded_id = recorded_id;
+        object->proxy = proxy;
+    }
+}
+
+/* The proxy of the object of a record, the globals are bound once */
+static struct wl_proxy *
+get_proxy(struct replay_client *client, const struct ivi_wm_record *record)
+{
+    struct replay_object *object = find_object(client, record->object);
+
+    if (object)
+        return object->proxy;
+
+    if (record->interface == IVI_WM_RECORD_IVI_WM && client->ivi_wm) {
+        add_object(client, record->object, client->ivi_wm);
+        return client->ivi_wm;
+    }
+
+    if (record->interface == IVI_WM_RECORD_IVI_INPUT && client->ivi_input) {
+        add_object(client, record->object, client->ivi_input);
+        return client->ivi_input;
+    }
+
+    return NULL;
+}
+
+static bool
+read_uint(const uint8_t **data, const uint8_t *end, uint32_t *value)
+{
+    if (end - *data < 4)
+        return false;
+
+    memcpy(value, *data, 4);
+    *data += 4;
+    return true;
+}
+
+static bool
+read_data(const uint8_t **data, const uint8_t *end, const void **ptr,
+          uint32_t *size)
+{
+    uint32_t padded;
+
+    if (!read_uint(data, end, size))
+        return false;
+
+    if (*size == IVI_WM_RECORDER_NULL) {
+        *ptr = NULL;
+        *size = 0;
+        return true;
+    }
+
+    padded = (*size + 3) & ~3u;
+    if ((uint32_t)(end - *data) < padded)
+        return false;
+
+    *ptr = *data;
+    *data += padded;
+    return true;
+}
+
+static bool
+replay_record(struct replay *replay, const struct ivi_wm_record *record,
+              const uint8_t *data)
+{
+    const uint8_t *end = data + record->size;
+    const struct wl_interface *interface;
+    const struct wl_message *message;
+    const struct wl_interface *new_interface = NULL;
+    union wl_argument args[MAX_ARGS];
+    struct wl_array arrays[MAX_ARGS];
+    struct replay_client *client;
+    struct wl_proxy *proxy, *new_proxy = NULL;
+    uint32_t new_id = 0, since = 0, value;
+    const char *signature;
+    const void *ptr;
+    int i = 0;
+
+    if (record->interface == IVI_WM_RECORD_SURFACE)
+        return replay_surface(replay, record, data);
+
+    if (record->interface >= sizeof record_interfaces /
+                             sizeof record_interfaces[0])
+        return false;
+
+    interface = record_interfaces[record->interface];
+    if (record->opcode >= interface->method_count)
+        return false;
+
+    message = &interface->methods[record->opcode];
+
+    client = get_client(replay, record->client);
+    if (!client)
+        return false;
+
+    proxy = get_proxy(client, record);
+    if (!proxy)
+        return false;
+
+    for (signature = message->signature; *signature; signature++) {
+        if (*signature >= '0' && *signature <= '9') {
+            since = since * 10 + (*signature - '0');
+            continue;
+        }
+
+        if (*signature == '?')
+            continue;
+
+        if (i == MAX_ARGS)
+            return false;
+
+        switch (*signature) {
+        case 'i':
+        case 'u':
+        case 'f':
+            if (!read_uint(&data, end, &value))
+                return false;
+            args[i].u = value;
+            break;
+        case 'n':
+            if (!read_uint(&data, end, &new_id))
+                return false;
+            new_interface = message->types[i];
+            args[i].o = NULL;
+            break;
+        case 'o':
+            if (!read_uint(&data, end, &value))
+                return false;
+            if (value == 0) {
+                args[i].o = NULL;
+            } else if (message->types[i] == &wl_output_interface &&
+                       client->output) {
+                args[i].o = (struct wl_object *)client->output;
+            } else if (find_object(client, value)) {
+                args[i].o = (struct wl_object *)
+                        find_object(client, value)->proxy;
+            } else {
+                return false;
+            }
+            break;
+        case 's':
+            if (!read_data(&data, end, &ptr, &value))
+                return false;
+            args[i].s = ptr;
+            break;
+        case 'a':
+            if (!read_data(&data, end, &ptr, &value))
+                return false;
+            arrays[i].data = (void *)ptr;
+            arrays[i].size = value;
+            arrays[i].alloc = value;
+            args[i].a = ptr ? &arrays[i] : NULL;
+            break;
+        case 'h':
+        default:
+            return false;
+        }
+
+        i++;
+    }
+
+    if (since > wl_proxy_get_version(proxy))
+        return false;
+
+    if (new_interface) {
+        new_proxy = wl_proxy_marshal_array_constructor_versioned(proxy,
+                record->opcode, args, new_interface,
+                wl_proxy_get_version(proxy));
+        if (new_proxy)
+            add_object(client, new_id, new_proxy);
+    } else {
+        wl_proxy_marshal_array(proxy, record->opcode, args);
+    }
+
+    if (!strcmp(message->name, "destroy")) {
+        find_object(client, record->object)->proxy = NULL;
+        if (proxy == client->ivi_wm)
+            client->ivi_wm = NULL;
+        if (proxy == client->ivi_input)
+            client->ivi_input = NULL;
+        wl_proxy_destroy(proxy);
+    }
+
+    /* the roundtrip dispatches the events, which have no listeners */
+    if (++client->requests % ROUNDTRIP_INTERVAL == 0) {
+        if (wl_display_roundtrip(client->display) < 0) {
+            check_display_error(client->display, "client", client->index);
+            client->failed = true;
+        }
+    } else {
+        wl_display_flush(client->display);
+    }
+
+    return true;
+}
+
+/* Returns the number of connections which failed */
+static int
+destroy_clients(struct replay *replay)
+{
+    struct replay_client *client, *next;
+    struct stand_in_client *stand_ins = &replay->stand_ins;
+    struct stand_in *stand_in, *next_stand_in;
+    int failed = 0;
+
+    wl_list_for_each_safe(client, next, &replay->clients, link) {
+        if (client->display) {
+            if (client->failed ||
+                (wl_display_roundtrip(client->display) < 0 &&
+                 check_display_error(client->display, "client",
+                                     client->index)))
+                failed++;
+            wl_display_disconnect(client->display);
+        }
+
+        wl_array_release(&client->objects);
+        free(client);
+    }
+
+    wl_list_for_each_safe(stand_in, next_stand_in, &stand_ins->surfaces,
+                          link) {
+        destroy_stand_in(stand_in);
+    }
+
+    if (stand_ins->display) {
+        if (stand_ins->failed ||
+            (wl_display_roundtrip(stand_ins->display) < 0 &&
+             check_display_error(stand_ins->display, "stand-in client", 0)))
+            failed++;
+        wl_display_disconnect(stand_ins->display);
+    }
+
+    return failed;
+}
+
+static uint8_t *
+read_trace(const char *path, size_t *size)
+{
+    FILE *file = fopen(path, "rb");
+    uint8_t *trace = NULL;
+    long length;
+
+    if (!file)
+        return NULL;
+
+    if (fseek(file, 0, SEEK_END) == 0 && (length = ftell(file)) >= 0 &&
+        fseek(file, 0, SEEK_SET) == 0) {
+        trace = malloc(length ? length : 1);
+        if (trace && fread(trace, 1, length, file) != (size_t)length) {
+            free(trace);
+            trace = NULL;
+        }
+        *size = length;
+    }
+
+    fclose(file);
+    return trace;
+}
+
+static int
+usage(int ret)
+{
+    fprintf(stderr, "usage: ivi-wm-replay [options] <trace>\n"
+                    "    -h,  --help                  display this help and exit.\n"
+                    "    -m,  --max-speed             replay as fast as possible instead\n"
+                    "                                 of at the recorded speed.\n"
+                    "    -d,  --display <name>        wayland display to connect to.\n");
+    return ret;
+}
+
+int
+main(int argc, char *argv[])
+{
+    static const struct option options[] = {
+        { "help",      no_argument,       NULL, 'h' },
+        { "max-speed", no_argument,       NULL, 'm' },
+        { "display",   required_argument, NULL, 'd' },
+        { 0,           0,                 NULL, 0 }
+    };
+    struct replay replay;
+    struct ivi_wm_record record;
+    bool max_speed = false;
+    uint64_t start, first_time = 0, duration;
+    struct timespec wait;
+    uint8_t *trace;
+    size_t size, offset;
+    int opt, failed;
+
+    memset(&replay, 0, sizeof replay);
+    wl_list_init(&replay.clients);
+    wl_list_init(&replay.stand_ins.surfaces);
+
+    while ((opt = getopt_long(argc, argv, "hmd:", options, NULL)) != -1) {
+        switch (opt) {
+        case 'm':
+            max_speed = true;
+            break;
+        case 'd':
+            replay.display_name = optarg;
+            break;
+        case 'h':
+            return usage(0);
+        default:
+            return usage(1);
+        }
+    }
+
+    if (optind + 1 != argc)
+        return usage(1);
+
+    trace = read_trace(argv[optind], &size);
+    if (!trace) {
+        fprintf(stderr, "failed to read %s\n", argv[optind]);
+        return 1;
+    }
+
+    if (size < IVI_WM_RECORDER_MAGIC_SIZE ||
+        memcmp(trace, IVI_WM_RECORDER_MAGIC, IVI_WM_RECORDER_MAGIC_SIZE)) {
+        fprintf(stderr, "%s is not an ivi-wm-recorder trace\n", argv[optind]);
+        free(trace);
+        return 1;
+    }
+
+    start = now_usec();
+
+    for (offset = IVI_WM_RECORDER_MAGIC_SIZE;
+         size - offset >= sizeof record;
+         offset += sizeof record + record.size) {
+        memcpy(&record, trace + offset, sizeof record);
+        if (record.size > size - offset - sizeof record) {
+            fprintf(stderr, "trace truncated\n");
+            break;
+        }
+
+        if (first_time == 0)
+            first_time = record.time_usec;
+
+        /* keep the recorded distance of the requests */
+        if (!max_speed) {
+            uint64_t due = start + (record.time_usec - first_time);
+            uint64_t now = now_usec();
+
+            if (due > now) {
+                wait.tv_sec = (due - now) / 1000000;
+                wait.tv_nsec = (due - now) % 1000000 * 1000;
+                nanosleep(&wait, NULL);
+            }
+        }
+
+        if (replay_record(&replay, &record, trace + offset + sizeof record))
+            replay.replayed++;
+        else
+            replay.skipped++;
+    }
+
+    failed = destroy_clients(&replay);
+    duration = now_usec() - start;
+
+    printf("replayed %u requests, skipped %u, in %.3f ms, %.0f requests/s\n",
+           replay.replayed, replay.skipped, duration / 1000.0,
+           duration ? replay.replayed * 1000000.0 / duration : 0.0);
+    if (failed)
+        printf("%d connections failed\n", failed);
+
+    free(trace);
+    return failed ? 1 : 0;
+}
@@ -902,7 +902,9 @@ int main (int argc, const char * argv[])
         goto ErrorContext;
     }
 
-    if (create_bkgnd_surface(wlcontext)) {
+    /* without a surface id, ivi-controller draws the background itself */
+    if ((bkgnd_settings->surface_id != 0xffffffff) &&
+            create_bkgnd_surface(wlcontext)) {
         fprintf(stderr, "create_bkgnd_surface failed\n");
         goto Error;
     }
@@ -920,7 +922,8 @@ int main (int argc, const char * argv[])
 #endif
 
     /*draw the bkgnd display*/
-    draw_bkgnd_surface(wlcontext);
+    if (wlcontext->wlBkgndSurface)
+        draw_bkgnd_surface(wlcontext);
 
     while (running && (ret != -1))
         ret = display_dispatch(wlcontext);
@@ -29,25 +29,45 @@
 #include "config.h"
 
 #include <errno.h>
+#include <stddef.h>
 #include <fcntl.h>
+#include <inttypes.h>
 #include <unistd.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include <sys/ioctl.h>
 #include <sys/mman.h>
+#include <sys/socket.h>
+#include <linux/sockios.h>
 
 #include <weston.h>
 #include <libweston/desktop.h>
 #include "ivi-wm-server-protocol.h"
 #include "ivi-controller.h"
+#include "ivi-wm-recorder.h"
+#include "ivi-trace.h"
 
 #include "wayland-util.h"
 
+/* exported by libweston for its renderer and backend modules, which
+ * include the uninstalled pixel-formats.h */
+const struct pixel_format_info *
+pixel_format_get_info_shm(uint32_t format);
+
 #define IVI_CLIENT_SURFACE_ID_ENV_NAME "IVI_CLIENT_SURFACE_ID"
 #define IVI_CLIENT_BKGND_COLOR_ENV_NAME "IVI_CLIENT_BKGND_COLOR"
 #define IVI_CLIENT_DEBUG_SCOPES_ENV_NAME "IVI_CLIENT_DEBUG_STREAM_NAMES"
 #define IVI_CLIENT_ENABLE_CURSOR_ENV_NAME "IVI_CLIENT_ENABLE_CURSOR"
 
+/* interval in ms to check whether a congested controller has drained
+ * its socket */
+#define CONTROLLER_DRAIN_INTERVAL 16
+/* events sent to a controller before its send queue is sampled again
+ * within one dispatch */
+#define CONTROLLER_SAMPLE_EVENTS 64
+#define DIRTY_HASH_SIZE 64
+
 struct ivilayer;
 struct iviscreen;
 
@@ -55,6 +75,19 @@ struct notification {
     struct wl_list link;
     struct wl_resource *resource;
     struct wl_list layout_link;
+    struct ivisurface *ivisurf;
+    struct ivilayer *ivilayer;
+
+    /* ivi_layout_notification_mask of the properties the controller
+     * subscribed to */
+    uint32_t mask;
+
+    /* minimum time in ms between two batches of property events,
+     * 0 means every change is sent immediately */
+    uint32_t min_interval;
+    uint32_t pending_mask;
+    int64_t last_sent;
+    struct wl_event_source *rate_timer;
 };
 
 struct ivilayer {
@@ -72,6 +105,8 @@ struct iviscreen {
     uint32_t id_screen;
     struct weston_output *output;
     struct wl_list resource_list;
+    struct wl_listener frame_listener;
+    uint64_t first_frame_us;
 };
 
 struct ivicontroller {
@@ -83,11 +118,48 @@ struct ivicontroller {
 
     struct wl_list layer_notifications;
     struct wl_list surface_notifications;
+
+    /* ivi_layout_notification_mask of the properties sent for every
+     * surface or layer, 0 if the controller has no wildcard subscription */
+    uint32_t surface_sync_all_mask;
+    uint32_t layer_sync_all_mask;
+
+    /* When the client stops reading its socket, property events are not
+     * sent anymore. Only the latest dirty state of every object is kept
+     * in dirty_list and sent, once the client has drained its socket.
+     * The send queue is sampled at the first event of a dispatch and
+     * again every CONTROLLER_SAMPLE_EVENTS events, sample_events is the
+     * count of events at the last sample. The idle callback clears
+     * sampled after the dispatch. */
+    bool congested;
+    bool sampled;
+    uint64_t sample_events;
+    int sndbuf;
+    struct wl_list dirty_list;
+    struct wl_list dirty_hash[DIRTY_HASH_SIZE];
+    struct wl_event_source *drain_timer;
+    struct wl_event_source *sample_idle;
+    uint32_t events_merged;
+    uint32_t events_dropped;
+
+    /* events sent to the controller, see count_wm_event() */
+    atomic_uint_fast64_t events;
+};
+
+struct dirty_state {
+    struct wl_list link;
+    struct wl_list hash_link;
+    uint32_t id;
+    bool is_layer;
+    uint32_t mask;
 };
 
 struct ivi_screenshooter {
+    struct ivishell *shell;
     struct wl_resource *screenshot;
     struct weston_output *output;
+    /* from the request until the screenshooter is done */
+    struct ivi_trace_span span;
 };
 
 struct screen_id_info {
@@ -95,18 +167,80 @@ struct screen_id_info {
     uint32_t screen_id;
 };
 
+/* Readback of an output region after the next repaint. The pixels are
+ * either hashed and sent to the ivi_wm_screen resource, or scaled into
+ * the buffer of the ivi_screenshot resource. */
+struct screen_readback {
+    struct ivishell *shell;
+    struct wl_resource *resource;
+    struct weston_output *output;
+    struct weston_buffer *buffer;
+    struct wl_listener frame_listener;
+    struct wl_listener output_destroy_listener;
+    struct wl_listener resource_destroy_listener;
+    int32_t x;
+    int32_t y;
+    int32_t width;
+    int32_t height;
+};
+
+static void
+destroy_notification(struct notification *noti)
+{
+    if (noti->rate_timer)
+        wl_event_source_remove(noti->rate_timer);
+
+    wl_list_remove(&noti->layout_link);
+    wl_list_remove(&noti->link);
+    free(noti);
+}
+
 static void
 clear_notification_list(struct wl_list* notification_list)
 {
     struct notification *noti, *next;
 
     wl_list_for_each_safe(noti, next, notification_list, link) {
-         wl_list_remove(&noti->layout_link);
-         wl_list_remove(&noti->link);
-         free(noti);
+         destroy_notification(noti);
     }
 }
 
+/** Read the current time from the Presentation clock
+ *
+ * \param compositor
+ * \param[out] ts The current time.
+ *
+ * \note Reading the current time in user space is always imprecise to some
+ * degree.
+ *
+ * This function is never meant to fail. If reading the clock does fail,
+ * an error message is logged and a zero time is returned. Callers are not
+ * supposed to detect or react to failures.
+ *
+ * \ingroup compositor
+ */
+static void
+ivi_weston_compositor_read_presentation_clock(
+			const struct weston_compositor *compositor,
+			struct timespec *ts)
+{
+	static bool warned;
+	int ret;
+
+	ret = clock_gettime(compositor->presentation_clock, ts);
+	if (ret < 0) {
+		ts->tv_sec = 0;
+		ts->tv_nsec = 0;
+
+		if (!warned)
+			weston_log("Error: failure to read "
+				   "the presentation clock %#x: '%s' (%d)\n",
+				   compositor->presentation_clock,
+				   strerror(errno), errno);
+		warned = true;
+	}
+}
+
 static void
 destroy_ivicontroller_screen(struct wl_resource *resource)
 {
@@ -117,9 +251,24 @@ static void
 unbind_resource_controller(struct wl_resource *resource)
 {
     struct ivicontroller *controller = wl_resource_get_user_data(resource);
+    struct dirty_state *dirty, *next;
 
     wl_list_remove(&controller->link);
 
+    /* keep the events of the controller in the total */
+    ivi_stats_add(&controller->shell->stats.counters[IVI_STAT_EVENTS],
+                  ivi_stats_get(&controller->events));
+
+    if (controller->drain_timer)
+        wl_event_source_remove(controller->drain_timer);
+    if (controller->sample_idle)
+        wl_event_source_remove(controller->sample_idle);
+
+    wl_list_for_each_safe(dirty, next, &controller->dirty_list, link) {
+        wl_list_remove(&dirty->link);
+        free(dirty);
+    }
+
     clear_notification_list(&controller->layer_notifications);
     clear_notification_list(&controller->surface_notifications);
 
@@ -155,6 +304,56 @@ get_layer(struct wl_list *list_layer, struct ivi_layout_layer *layout_layer)
     return NULL;
 }
 
+/* The requests to ivi_wm and ivi_wm_screen are counted in their handlers,
+ * the opcode of a request is the index of its handler in the interface.
+ * Requests and events of a screen, whose output is destroyed, are not
+ * counted, the screen resource has no shell anymore. */
+#define IVI_WM_REQUEST(name) \
+    (offsetof(struct ivi_wm_interface, name) / sizeof(void (*)(void)))
+#define IVI_WM_SCREEN_REQUEST(name) \
+    (offsetof(struct ivi_wm_screen_interface, name) / sizeof(void (*)(void)))
+
+_Static_assert(sizeof(struct ivi_wm_interface) / sizeof(void (*)(void)) <=
+               IVI_STATS_MAX_OPCODES, "too many ivi_wm requests");
+_Static_assert(sizeof(struct ivi_wm_screen_interface) / sizeof(void (*)(void)) <=
+               IVI_STATS_MAX_OPCODES, "too many ivi_wm_screen requests");
+
+static void
+count_wm_request(struct wl_resource *resource, size_t opcode)
+{
+    struct ivicontroller *ctrl = wl_resource_get_user_data(resource);
+
+    ivi_stats_add(&ctrl->shell->stats.ivi_wm_requests[opcode], 1);
+}
+
+static void
+count_wm_screen_request(struct wl_resource *resource, size_t opcode)
+{
+    struct iviscreen *iviscrn = wl_resource_get_user_data(resource);
+
+    if (iviscrn)
+        ivi_stats_add(&iviscrn->shell->stats.ivi_wm_screen_requests[opcode], 1);
+}
+
+/* Called before every event sent to a controller, the total is summed up
+ * when the counters are read */
+static void
+count_wm_event(struct wl_resource *resource)
+{
+    struct ivicontroller *ctrl = wl_resource_get_user_data(resource);
+
+    ivi_stats_add(&ctrl->events, 1);
+}
+
+static void
+count_wm_screen_event(struct wl_resource *resource)
+{
+    struct iviscreen *iviscrn = wl_resource_get_user_data(resource);
+
+    if (iviscrn)
+        ivi_stats_add(&iviscrn->shell->stats.counters[IVI_STAT_EVENTS], 1);
+}
+
 static void
 send_surface_configure_event(struct ivicontroller * ctrl,
                              struct ivi_layout_surface *layout_surface,
@@ -172,6 +371,7 @@ send_surface_configure_event(struct ivicontroller * ctrl,
     if ((surface->width == 0) || (surface->height == 0))
         return;
 
+    count_wm_event(ctrl->resource);
     ivi_wm_send_surface_size(ctrl->resource, surface_id,
                              surface->width, surface->height);
 }
@@ -184,19 +384,23 @@ send_surface_event(struct ivicontroller * ctrl,
                    uint32_t mask)
 {
     if (mask & IVI_NOTIFICATION_OPACITY) {
+        count_wm_event(ctrl->resource);
         ivi_wm_send_surface_opacity(ctrl->resource, surface_id, prop->opacity);
     }
     if (mask & IVI_NOTIFICATION_SOURCE_RECT) {
+        count_wm_event(ctrl->resource);
         ivi_wm_send_surface_source_rectangle(ctrl->resource, surface_id,
             prop->source_x, prop->source_y,
             prop->source_width, prop->source_height);
     }
     if (mask & IVI_NOTIFICATION_DEST_RECT) {
+        count_wm_event(ctrl->resource);
         ivi_wm_send_surface_destination_rectangle(ctrl->resource, surface_id,
             prop->dest_x, prop->dest_y,
             prop->dest_width, prop->dest_height);
     }
     if (mask & IVI_NOTIFICATION_VISIBILITY) {
+        count_wm_event(ctrl->resource);
         ivi_wm_send_surface_visibility(ctrl->resource, surface_id, prop->visibility);
     }
     if (mask & IVI_NOTIFICATION_CONFIGURE) {
@@ -204,29 +408,6 @@ send_surface_event(struct ivicontroller * ctrl,
     }
 }
 
-static void
-send_surface_prop(struct wl_listener *listener, void *data)
-{
-    struct ivisurface *ivisurf =
-             wl_container_of(listener, ivisurf,
-                    property_changed);
-    (void)data;
-    enum ivi_layout_notification_mask mask;
-    struct ivicontroller *ctrl;
-    const struct ivi_layout_interface *lyt = ivisurf->shell->interface;
-    struct notification *noti;
-    uint32_t surface_id;
-
-    mask = ivisurf->prop->event_mask;
-
-    surface_id = lyt->get_id_of_surface(ivisurf->layout_surface);
-
-    wl_list_for_each(noti, &ivisurf->notification_list, layout_link) {
-        ctrl = wl_resource_get_user_data(noti->resource);
-        send_surface_event(ctrl, ivisurf->layout_surface, surface_id, ivisurf->prop, mask);
-    }
-}
-
 static void
 send_layer_event(struct ivicontroller * ctrl,
                  struct ivi_layout_layer *layout_layer,
@@ -235,23 +416,375 @@ send_layer_event(struct ivicontroller * ctrl,
                  uint32_t mask)
 {
     if (mask & IVI_NOTIFICATION_OPACITY) {
+        count_wm_event(ctrl->resource);
         ivi_wm_send_layer_opacity(ctrl->resource, layer_id, prop->opacity);
     }
     if (mask & IVI_NOTIFICATION_SOURCE_RECT) {
+        count_wm_event(ctrl->resource);
         ivi_wm_send_layer_source_rectangle(ctrl->resource, layer_id,
                                            prop->source_x, prop->source_y,
                                            prop->source_width, prop->source_height);
     }
     if (mask & IVI_NOTIFICATION_DEST_RECT) {
+        count_wm_event(ctrl->resource);
         ivi_wm_send_layer_destination_rectangle(ctrl->resource, layer_id,
                                                 prop->dest_x, prop->dest_y,
                                                 prop->dest_width, prop->dest_height);
     }
     if (mask & IVI_NOTIFICATION_VISIBILITY) {
+        count_wm_event(ctrl->resource);
         ivi_wm_send_layer_visibility(ctrl->resource, layer_id, prop->visibility);
     }
 }
 
+static int
+get_controller_queued_bytes(struct ivicontroller *ctrl)
+{
+    int queued = 0;
+
+    if (ioctl(wl_client_get_fd(ctrl->client), SIOCOUTQ, &queued) < 0)
+        return 0;
+
+    return queued;
+}
+
+static void
+flush_dirty_states(struct ivicontroller *ctrl)
+{
+    const struct ivi_layout_interface *lyt = ctrl->shell->interface;
+    struct ivi_layout_surface *layout_surface;
+    struct ivi_layout_layer *layout_layer;
+    struct dirty_state *dirty, *next;
+
+    wl_list_for_each_safe(dirty, next, &ctrl->dirty_list, link) {
+        if (dirty->is_layer) {
+            layout_layer = lyt->get_layer_from_id(dirty->id);
+            if (layout_layer)
+                send_layer_event(ctrl, layout_layer, dirty->id,
+                                 lyt->get_properties_of_layer(layout_layer),
+                                 dirty->mask);
+            else
+                ctrl->events_dropped++;
+        } else {
+            layout_surface = lyt->get_surface_from_id(dirty->id);
+            if (layout_surface)
+                send_surface_event(ctrl, layout_surface, dirty->id,
+                                   lyt->get_properties_of_surface(layout_surface),
+                                   dirty->mask);
+            else
+                ctrl->events_dropped++;
+        }
+
+        wl_list_remove(&dirty->link);
+        wl_list_remove(&dirty->hash_link);
+        free(dirty);
+    }
+}
+
+static struct wl_list *
+dirty_bucket(struct ivicontroller *ctrl, uint32_t id, bool is_layer)
+{
+    return &ctrl->dirty_hash[(id * 2654435761u + is_layer) % DIRTY_HASH_SIZE];
+}
+
+static void
+controller_sample_reset(void *data)
+{
+    struct ivicontroller *ctrl = data;
+
+    ctrl->sampled = false;
+    ctrl->sample_idle = NULL;
+}
+
+static int
+controller_drain_timer_handler(void *data)
+{
+    struct ivicontroller *ctrl = data;
+
+    /* client is still not reading, keep merging the events */
+    if (get_controller_queued_bytes(ctrl) > ctrl->sndbuf / 8) {
+        wl_event_source_timer_update(ctrl->drain_timer,
+                                     CONTROLLER_DRAIN_INTERVAL);
+        return 0;
+    }
+
+    ctrl->congested = false;
+    flush_dirty_states(ctrl);
+
+    weston_log("ivi-controller: controller %u drained its events, "
+               "merged: %u, dropped: %u\n",
+               ctrl->id, ctrl->events_merged, ctrl->events_dropped);
+    return 0;
+}
+
+static bool
+is_controller_congested(struct ivicontroller *ctrl)
+{
+    struct wl_event_loop *loop;
+
+    if (ctrl->congested)
+        return true;
+
+    if (ctrl->sndbuf <= 0)
+        return false;
+
+    /* a burst within one dispatch is sampled again once it has sent
+     * enough events to fill the queue meanwhile */
+    if (ctrl->sampled && ivi_stats_get(&ctrl->events) - ctrl->sample_events <
+                         CONTROLLER_SAMPLE_EVENTS)
+        return false;
+
+    loop = wl_display_get_event_loop(ctrl->shell->compositor->wl_display);
+    if (!ctrl->sampled) {
+        ctrl->sample_idle = wl_event_loop_add_idle(loop,
+                                controller_sample_reset, ctrl);
+        ctrl->sampled = ctrl->sample_idle != NULL;
+    }
+    ctrl->sample_events = ivi_stats_get(&ctrl->events);
+
+    if (get_controller_queued_bytes(ctrl) < ctrl->sndbuf / 2)
+        return false;
+
+    if (!ctrl->drain_timer) {
+        ctrl->drain_timer = wl_event_loop_add_timer(loop,
+                                controller_drain_timer_handler, ctrl);
+        if (!ctrl->drain_timer)
+            return false;
+    }
+
+    weston_log("ivi-controller: controller %u does not read its events, "
+               "switching to state sync\n", ctrl->id);
+
+    ctrl->congested = true;
+    wl_event_source_timer_update(ctrl->drain_timer, CONTROLLER_DRAIN_INTERVAL);
+    return true;
+}
+
+/* Returns true, if the event is merged into the dirty state of the object
+ * instead of being sent to the congested controller. */
+static bool
+defer_event(struct ivicontroller *ctrl, uint32_t id, bool is_layer,
+            uint32_t mask)
+{
+    struct wl_list *bucket;
+    struct dirty_state *dirty;
+
+    if (!is_controller_congested(ctrl))
+        return false;
+
+    bucket = dirty_bucket(ctrl, id, is_layer);
+    wl_list_for_each(dirty, bucket, hash_link) {
+        if (dirty->id == id && dirty->is_layer == is_layer) {
+            dirty->mask |= mask;
+            ctrl->events_merged++;
+            return true;
+        }
+    }
+
+    dirty = calloc(1, sizeof *dirty);
+    if (dirty == NULL) {
+        ctrl->events_dropped++;
+        return true;
+    }
+
+    dirty->id = id;
+    dirty->is_layer = is_layer;
+    dirty->mask = mask;
+    wl_list_insert(ctrl->dirty_list.prev, &dirty->link);
+    wl_list_insert(bucket, &dirty->hash_link);
+    return true;
+}
+
+static void
+send_notification(struct notification *noti, uint32_t mask)
+{
+    struct ivicontroller *ctrl = wl_resource_get_user_data(noti->resource);
+    const struct ivi_layout_interface *lyt = ctrl->shell->interface;
+    uint32_t id;
+
+    if (noti->ivisurf) {
+        id = lyt->get_id_of_surface(noti->ivisurf->layout_surface);
+        if (defer_event(ctrl, id, false, mask))
+            return;
+
+        send_surface_event(ctrl, noti->ivisurf->layout_surface, id,
+                           noti->ivisurf->prop, mask);
+    } else if (noti->ivilayer) {
+        id = lyt->get_id_of_layer(noti->ivilayer->layout_layer);
+        if (defer_event(ctrl, id, true, mask))
+            return;
+
+        send_layer_event(ctrl, noti->ivilayer->layout_layer, id,
+                         noti->ivilayer->prop, mask);
+    }
+}
+
+static int64_t
+notification_get_time(struct notification *noti)
+{
+    struct ivicontroller *ctrl = wl_resource_get_user_data(noti->resource);
+    struct timespec now;
+
+    ivi_weston_compositor_read_presentation_clock(ctrl->shell->compositor, &now);
+    return timespec_to_msec(&now);
+}
+
+static int
+notification_rate_timer_handler(void *data)
+{
+    struct notification *noti = data;
+    uint32_t mask = noti->pending_mask;
+
+    /* the properties are read when the timer fires, so the controller
+     * gets the latest values of everything that changed meanwhile */
+    noti->pending_mask = 0;
+    noti->last_sent = notification_get_time(noti);
+    send_notification(noti, mask);
+
+    return 0;
+}
+
+static void
+dispatch_notification(struct notification *noti, uint32_t mask)
+{
+    struct ivicontroller *ctrl;
+    struct wl_event_loop *loop;
+    int64_t now, elapsed;
+
+    mask &= noti->mask;
+    if (!mask)
+        return;
+
+    if (noti->min_interval == 0) {
+        send_notification(noti, mask);
+        return;
+    }
+
+    /* timer is already armed, the change goes out with the next batch */
+    if (noti->pending_mask) {
+        noti->pending_mask |= mask;
+        return;
+    }
+
+    now = notification_get_time(noti);
+    elapsed = now - noti->last_sent;
+    if (elapsed < 0 || elapsed >= noti->min_interval) {
+        noti->last_sent = now;
+        send_notification(noti, mask);
+        return;
+    }
+
+    if (!noti->rate_timer) {
+        ctrl = wl_resource_get_user_data(noti->resource);
+        loop = wl_display_get_event_loop(ctrl->shell->compositor->wl_display);
+        noti->rate_timer = wl_event_loop_add_timer(loop,
+                                notification_rate_timer_handler, noti);
+        if (!noti->rate_timer) {
+            send_notification(noti, mask);
+            return;
+        }
+    }
+
+    noti->pending_mask = mask;
+    wl_event_source_timer_update(noti->rate_timer,
+                                 noti->min_interval - elapsed);
+}
+
+static bool
+has_notification(struct wl_list *notification_list,
+                 struct wl_resource *resource)
+{
+    struct notification *noti;
+
+    wl_list_for_each(noti, notification_list, layout_link) {
+        if (noti->resource == resource)
+            return true;
+    }
+
+    return false;
+}
+
+static void
+send_surface_sync_all(struct ivisurface *ivisurf, uint32_t mask)
+{
+    const struct ivi_layout_interface *lyt = ivisurf->shell->interface;
+    struct ivicontroller *ctrl;
+    uint32_t surface_id = 0;
+
+    wl_list_for_each(ctrl, &ivisurf->shell->list_controller, link) {
+        if (!(mask & ctrl->surface_sync_all_mask))
+            continue;
+
+        /* an explicit subscription to the surface takes precedence */
+        if (has_notification(&ivisurf->notification_list, ctrl->resource))
+            continue;
+
+        if (!surface_id)
+            surface_id = lyt->get_id_of_surface(ivisurf->layout_surface);
+
+        if (defer_event(ctrl, surface_id, false,
+                        mask & ctrl->surface_sync_all_mask))
+            continue;
+
+        send_surface_event(ctrl, ivisurf->layout_surface, surface_id,
+                           ivisurf->prop, mask & ctrl->surface_sync_all_mask);
+    }
+}
+
+static void
+send_layer_sync_all(struct ivilayer *ivilayer, uint32_t mask)
+{
+    const struct ivi_layout_interface *lyt = ivilayer->shell->interface;
+    struct ivicontroller *ctrl;
+    uint32_t layer_id = 0;
+
+    wl_list_for_each(ctrl, &ivilayer->shell->list_controller, link) {
+        if (!(mask & ctrl->layer_sync_all_mask))
+            continue;
+
+        /* an explicit subscription to the layer takes precedence */
+        if (has_notification(&ivilayer->notification_list, ctrl->resource))
+            continue;
+
+        if (!layer_id)
+            layer_id = lyt->get_id_of_layer(ivilayer->layout_layer);
+
+        if (defer_event(ctrl, layer_id, true,
+                        mask & ctrl->layer_sync_all_mask))
+            continue;
+
+        send_layer_event(ctrl, ivilayer->layout_layer, layer_id,
+                         ivilayer->prop, mask & ctrl->layer_sync_all_mask);
+    }
+}
+
+static void
+send_surface_prop(struct wl_listener *listener, void *data)
+{
+    struct ivisurface *ivisurf =
+             wl_container_of(listener, ivisurf,
+                    property_changed);
+    (void)data;
+    enum ivi_layout_notification_mask mask;
+    struct notification *noti;
+    struct ivi_trace_span span;
+    uint32_t count = 0;
+
+    mask = ivisurf->prop->event_mask;
+    ivi_trace_begin(&span, ivisurf->shell->trace, "send_surface_prop");
+
+    wl_list_for_each(noti, &ivisurf->notification_list, layout_link) {
+        dispatch_notification(noti, mask);
+        count++;
+    }
+
+    send_surface_sync_all(ivisurf, mask);
+
+    ivi_trace_end(&span, "\"id\":%u,\"mask\":%u,\"notifications\":%u",
+                  ivisurf->shell->interface->get_id_of_surface(ivisurf->layout_surface),
+                  mask, count);
+}
+
 static void
 send_layer_prop(struct wl_listener *listener, void *data)
 {
@@ -259,19 +792,23 @@ send_layer_prop(struct wl_listener *listener, void *data)
            wl_container_of(listener, ivilayer, property_changed);
     (void)data;
     enum ivi_layout_notification_mask mask;
-    struct ivicontroller *ctrl;
-    const struct ivi_layout_interface *lyt = ivilayer->shell->interface;
     struct notification *noti;
-    uint32_t layer_id;
+    struct ivi_trace_span span;
+    uint32_t count = 0;
 
     mask = ivilayer->prop->event_mask;
-
-    layer_id = lyt->get_id_of_layer(ivilayer->layout_layer);
+    ivi_trace_begin(&span, ivilayer->shell->trace, "send_layer_prop");
 
     wl_list_for_each(noti, &ivilayer->notification_list, layout_link) {
-        ctrl = wl_resource_get_user_data(noti->resource);
-        send_layer_event(ctrl, ivilayer->layout_layer, layer_id, ivilayer->prop, mask);
+        dispatch_notification(noti, mask);
+        count++;
     }
+
+    send_layer_sync_all(ivilayer, mask);
+
+    ivi_trace_end(&span, "\"id\":%u,\"mask\":%u,\"notifications\":%u",
+                  ivilayer->shell->interface->get_id_of_layer(ivilayer->layout_layer),
+                  mask, count);
 }
 
 static void
@@ -285,8 +822,11 @@ controller_set_surface_opacity(struct wl_client *client,
     (void)client;
     struct ivi_layout_surface *layout_surface;
 
+    count_wm_request(resource, IVI_WM_REQUEST(set_surface_opacity));
+
     layout_surface = lyt->get_surface_from_id(surface_id);
     if (!layout_surface) {
+        count_wm_event(resource);
         ivi_wm_send_surface_error(resource, surface_id,
                                   IVI_WM_SURFACE_ERROR_NO_SURFACE,
                                   "surface_set_opacity: the surface with given id does not exist");
@@ -311,8 +851,11 @@ controller_set_surface_source_rectangle(struct wl_client *client,
     struct ivi_layout_surface *layout_surface;
     const struct ivi_layout_surface_properties *prop;
 
+    count_wm_request(resource, IVI_WM_REQUEST(set_surface_source_rectangle));
+
     layout_surface = lyt->get_surface_from_id(surface_id);
     if (!layout_surface) {
+        count_wm_event(resource);
         ivi_wm_send_surface_error(resource, surface_id,
                                   IVI_WM_SURFACE_ERROR_NO_SURFACE,
                                   "surface_set_source_rectangle: the surface with given id does not exist");
@@ -349,8 +892,11 @@ controller_set_surface_destination_rectangle(struct wl_client *client,
     struct ivi_layout_surface *layout_surface;
     const struct ivi_layout_surface_properties *prop;
 
+    count_wm_request(resource, IVI_WM_REQUEST(set_surface_destination_rectangle));
+
     layout_surface = lyt->get_surface_from_id(surface_id);
     if (!layout_surface) {
+        count_wm_event(resource);
         ivi_wm_send_surface_error(resource, surface_id,
                                   IVI_WM_SURFACE_ERROR_NO_SURFACE,
                                   "surface_set_destination_rectangle: the surface with given id does not exist");
@@ -389,8 +935,11 @@ controller_set_surface_visibility(struct wl_client *client,
     (void)client;
     struct ivi_layout_surface *layout_surface;
 
+    count_wm_request(resource, IVI_WM_REQUEST(set_surface_visibility));
+
     layout_surface = lyt->get_surface_from_id(surface_id);
     if (!layout_surface) {
+        count_wm_event(resource);
         ivi_wm_send_surface_error(resource, surface_id,
                                   IVI_WM_SURFACE_ERROR_NO_SURFACE,
                                   "surface_set_visibility: the surface with given id does not exist");
@@ -400,42 +949,6 @@ controller_set_surface_visibility(struct wl_client *client,
     lyt->surface_set_visibility(layout_surface, visibility);
 }
 
-/** Read the current time from the Presentation clock
- *
- * \param compositor
- * \param[out] ts The current time.
- *
- * \note Reading the current time in user space is always imprecise to some
- * degree.
- *
- * This function is never meant to fail. If reading the clock does fail,
- * an error message is logged and a zero time is returned. Callers are not
- * supposed to detect or react to failures.
- *
- * \ingroup compositor
- */
-static void
-ivi_weston_compositor_read_presentation_clock(
-			const struct weston_compositor *compositor,
-			struct timespec *ts)
-{
-	static bool warned;
-	int ret;
-
-	ret = clock_gettime(compositor->presentation_clock, ts);
-	if (ret < 0) {
-		ts->tv_sec = 0;
-		ts->tv_nsec = 0;
-
-		if (!warned)
-			weston_log("Error: failure to read "
-				   "the presentation clock %#x: '%s' (%d)\n",
-				   compositor->presentation_clock,
-				   strerror(errno), errno);
-		warned = true;
-	}
-}
-
 static void
 controller_surface_screenshot(struct wl_client *client,
                               struct wl_resource *resource,
@@ -455,6 +968,9 @@ controller_surface_screenshot(struct wl_client *client,
     uint32_t stamp_ms;
     void *shm_buff_data = NULL;
     struct weston_buffer *weston_buffer = NULL;
+    struct ivi_trace_span span;
+
+    count_wm_request(resource, IVI_WM_REQUEST(surface_screenshot));
 
     screenshot = wl_resource_create(client,
             &ivi_screenshot_interface, 2, screenshot_id);
@@ -499,8 +1015,11 @@ controller_surface_screenshot(struct wl_client *client,
     size = stride * height;
     weston_surface = lyt->surface_get_weston_surface(layout_surface);
 
+    ivi_trace_begin(&span, ctrl->shell->trace, "surface_dump");
     result = lyt->surface_dump(weston_surface, shm_buff_data, size, 0, 0,
             width, height);
+    ivi_trace_end(&span, "\"id\":%u,\"width\":%d,\"height\":%d",
+                  surface_id, width, height);
 
     if (result != IVI_SUCCEEDED) {
         ivi_screenshot_send_error(screenshot, IVI_SCREENSHOT_ERROR_NOT_SUPPORTED,
@@ -508,6 +1027,10 @@ controller_surface_screenshot(struct wl_client *client,
         goto err;
     }
 
+    ivi_stats_add(&ctrl->shell->stats.counters[IVI_STAT_SCREENSHOTS], 1);
+    ivi_stats_add(&ctrl->shell->stats.counters[IVI_STAT_SCREENSHOT_BYTES],
+                  size);
+
     /* get current timestamp */
     ivi_weston_compositor_read_presentation_clock(compositor, &stamp);
     stamp_ms = stamp.tv_sec * 1000 + stamp.tv_nsec / 1000000;
@@ -517,6 +1040,456 @@ err:
     wl_resource_destroy(screenshot);
 }
 
+/* the sums of the four channels of a pixel */
+typedef uint32_t pixel_sum __attribute__((vector_size(16)));
+
+static inline uint32_t
+swap_red_blue(uint32_t pixel)
+{
+    return (pixel & 0xff00ff00u) | ((pixel >> 16) & 0xffu) |
+           ((pixel & 0xffu) << 16);
+}
+
+/* Scales 32 bit pixels with a box filter, every destination pixel is the
+ * average of the source pixels it covers. Equal sizes are copied row by
+ * row. A negative source stride reads the rows bottom up. The source is in
+ * the byte order of WL_SHM_FORMAT_ABGR8888, swap_rb writes the byte order
+ * of WL_SHM_FORMAT_ARGB8888.
+ *
+ * The column spans are computed once, and the four channels of a pixel are
+ * summed as one vector. */
+static int
+scale_pixels(const uint8_t *src, int32_t src_width, int32_t src_height,
+             int32_t src_stride, uint8_t *dst, int32_t dst_width,
+             int32_t dst_height, int32_t dst_stride, bool swap_rb)
+{
+    const int r = swap_rb ? 2 : 0, b = swap_rb ? 0 : 2;
+    int32_t *span;
+    pixel_sum *acc, sum;
+    int32_t dx, dy, sx, sy, x0, x1, y0, y1;
+    const uint8_t *row, *in;
+    uint32_t pixel, count;
+    uint8_t *out;
+
+    if (src_width == dst_width && src_height == dst_height) {
+        for (sy = 0; sy < src_height; sy++) {
+            const uint8_t *from = src + (ptrdiff_t)sy * src_stride;
+            uint8_t *to = dst + (size_t)sy * dst_stride;
+
+            if (!swap_rb) {
+                memcpy(to, from, (size_t)src_width * 4);
+                continue;
+            }
+
+            for (sx = 0; sx < src_width; sx++) {
+                memcpy(&pixel, from + sx * 4, 4);
+                pixel = swap_red_blue(pixel);
+                memcpy(to + sx * 4, &pixel, 4);
+            }
+        }
+        return 0;
+    }
+
+    /* first source column and number of columns of every destination
+     * column */
+    span = malloc((size_t)dst_width * 2 * sizeof *span);
+    acc = malloc((size_t)dst_width * sizeof *acc);
+    if (!span || !acc) {
+        free(span);
+        free(acc);
+        return -1;
+    }
+
+    for (dx = 0; dx < dst_width; dx++) {
+        x0 = (int64_t)dx * src_width / dst_width;
+        x1 = (int64_t)(dx + 1) * src_width / dst_width;
+        span[dx * 2] = x0;
+        span[dx * 2 + 1] = x1 > x0 ? x1 - x0 : 1;
+    }
+
+    for (dy = 0; dy < dst_height; dy++) {
+        y0 = (int64_t)dy * src_height / dst_height;
+        y1 = (int64_t)(dy + 1) * src_height / dst_height;
+        if (y1 <= y0)
+            y1 = y0 + 1;
+
+        memset(acc, 0, (size_t)dst_width * sizeof *acc);
+        for (sy = y0; sy < y1; sy++) {
+            row = src + (ptrdiff_t)sy * src_stride;
+
+            for (dx = 0; dx < dst_width; dx++) {
+                in = row + span[dx * 2] * 4;
+                sum = acc[dx];
+                for (sx = 0; sx < span[dx * 2 + 1]; sx++, in += 4) {
+                    pixel_sum p = { in[0], in[1], in[2], in[3] };
+                    sum += p;
+                }
+                acc[dx] = sum;
+            }
+        }
+
+        out = dst + (size_t)dy * dst_stride;
+        for (dx = 0; dx < dst_width; dx++, out += 4) {
+            count = (uint32_t)span[dx * 2 + 1] * (uint32_t)(y1 - y0);
+            sum = (acc[dx] + count / 2) / count;
+            out[0] = sum[r];
+            out[1] = sum[1];
+            out[2] = sum[b];
+            out[3] = sum[3];
+        }
+    }
+
+    free(span);
+    free(acc);
+    return 0;
+}
+
+/* Returns the shm buffer a capture is written to, the capture has the
+ * format of the buffer */
+static struct weston_buffer *
+get_capture_buffer(struct weston_compositor *compositor,
+                   struct wl_resource *buffer_resource)
+{
+    struct weston_buffer *buffer;
+    int32_t width;
+
+    buffer = weston_buffer_from_resource(compositor, buffer_resource);
+    if (buffer == NULL || buffer->type != WESTON_BUFFER_SHM)
+        return NULL;
+
+    switch (wl_shm_buffer_get_format(buffer->shm_buffer)) {
+    case WL_SHM_FORMAT_ARGB8888:
+    case WL_SHM_FORMAT_XRGB8888:
+    case WL_SHM_FORMAT_ABGR8888:
+    case WL_SHM_FORMAT_XBGR8888:
+        break;
+    default:
+        return NULL;
+    }
+
+    width = wl_shm_buffer_get_width(buffer->shm_buffer);
+    if (width <= 0 || wl_shm_buffer_get_height(buffer->shm_buffer) <= 0 ||
+        wl_shm_buffer_get_stride(buffer->shm_buffer) < width * 4)
+        return NULL;
+
+    return buffer;
+}
+
+/* Scales a capture in the byte order of WL_SHM_FORMAT_ABGR8888 into the
+ * capture buffer, returns -1 without memory */
+static int
+write_capture(struct weston_buffer *buffer, const uint8_t *pixels,
+              int32_t width, int32_t height, int32_t stride)
+{
+    struct wl_shm_buffer *shm_buffer = buffer->shm_buffer;
+    uint32_t format = wl_shm_buffer_get_format(shm_buffer);
+    int ret;
+
+    wl_shm_buffer_begin_access(shm_buffer);
+    ret = scale_pixels(pixels, width, height, stride,
+                       wl_shm_buffer_get_data(shm_buffer),
+                       wl_shm_buffer_get_width(shm_buffer),
+                       wl_shm_buffer_get_height(shm_buffer),
+                       wl_shm_buffer_get_stride(shm_buffer),
+                       format == WL_SHM_FORMAT_ARGB8888 ||
+                       format == WL_SHM_FORMAT_XRGB8888);
+    wl_shm_buffer_end_access(shm_buffer);
+
+    return ret;
+}
+
+/* Dumps the given region of the surface into the capture buffer, the region
+ * is scaled to the size of the buffer */
+static void
+capture_surface(struct ivicontroller *ctrl, struct wl_resource *screenshot,
+                struct wl_resource *buffer_resource, uint32_t surface_id,
+                int32_t x, int32_t y, int32_t width, int32_t height)
+{
+    const struct ivi_layout_interface *lyt = ctrl->shell->interface;
+    struct ivi_layout_surface *layout_surface;
+    struct weston_surface *weston_surface;
+    struct wl_shm_buffer *shm_buffer;
+    struct weston_buffer *buffer;
+    int32_t surface_width = 0, surface_height = 0, stride = 0;
+    struct timespec stamp;
+    size_t size;
+    uint8_t *pixels;
+    int32_t result;
+    struct ivi_trace_span span;
+
+    ivi_trace_begin(&span, ctrl->shell->trace, "capture_surface");
+    layout_surface = lyt->get_surface_from_id(surface_id);
+    if (!layout_surface) {
+        ivi_screenshot_send_error(screenshot, IVI_SCREENSHOT_ERROR_NO_SURFACE,
+                "surface_screenshot: the surface with given id does not exist");
+        return;
+    }
+
+    lyt->surface_get_size(layout_surface, &surface_width, &surface_height,
+                          &stride);
+    if (!surface_width || !surface_height || !stride) {
+        ivi_screenshot_send_error(screenshot, IVI_SCREENSHOT_ERROR_NO_CONTENT,
+                "surface_screenshot: surface does not have content");
+        return;
+    }
+
+    if (width == 0 && height == 0) {
+        width = surface_width - x;
+        height = surface_height - y;
+    }
+
+    buffer = get_capture_buffer(ctrl->shell->compositor, buffer_resource);
+    if (!buffer || x < 0 || y < 0 || width <= 0 || height <= 0 ||
+        x + width > surface_width || y + height > surface_height) {
+        ivi_screenshot_send_error(screenshot, IVI_SCREENSHOT_ERROR_BAD_BUFFER,
+                "bad buffer input");
+        return;
+    }
+
+    size = (size_t)width * height * 4;
+    pixels = malloc(size);
+    if (!pixels) {
+        ivi_screenshot_send_error(screenshot, IVI_SCREENSHOT_ERROR_NO_MEMORY,
+                "internal allocate failed");
+        return;
+    }
+
+    weston_surface = lyt->surface_get_weston_surface(layout_surface);
+    result = lyt->surface_dump(weston_surface, pixels, size, x, y,
+                               width, height);
+    if (result != IVI_SUCCEEDED) {
+        ivi_screenshot_send_error(screenshot, IVI_SCREENSHOT_ERROR_NOT_SUPPORTED,
+                "surface_screenshot: surface dumping is not supported by renderer");
+        free(pixels);
+        return;
+    }
+
+    /* surface_dump writes the byte order of WL_SHM_FORMAT_ABGR8888 */
+    result = write_capture(buffer, pixels, width, height, width * 4);
+    free(pixels);
+    if (result < 0) {
+        ivi_screenshot_send_error(screenshot, IVI_SCREENSHOT_ERROR_NO_MEMORY,
+                "internal allocate failed");
+        return;
+    }
+
+    shm_buffer = buffer->shm_buffer;
+    ivi_stats_add(&ctrl->shell->stats.counters[IVI_STAT_SCREENSHOTS], 1);
+    ivi_stats_add(&ctrl->shell->stats.counters[IVI_STAT_SCREENSHOT_BYTES],
+                  (uint64_t)wl_shm_buffer_get_stride(shm_buffer) *
+                  wl_shm_buffer_get_height(shm_buffer));
+
+    ivi_weston_compositor_read_presentation_clock(ctrl->shell->compositor,
+                                                  &stamp);
+    ivi_screenshot_send_done(screenshot, timespec_to_msec(&stamp));
+    ivi_trace_end(&span, "\"id\":%u,\"width\":%d,\"height\":%d",
+                  surface_id, width, height);
+}
+
+static void
+controller_surface_thumbnail(struct wl_client *client,
+                             struct wl_resource *resource,
+                             struct wl_resource *buffer_resource,
+                             uint32_t screenshot_id,
+                             uint32_t surface_id)
+{
+    struct ivicontroller *ctrl = wl_resource_get_user_data(resource);
+    struct wl_resource *screenshot;
+
+    count_wm_request(resource, IVI_WM_REQUEST(surface_thumbnail));
+
+    screenshot = wl_resource_create(client, &ivi_screenshot_interface,
+                                    wl_resource_get_version(resource),
+                                    screenshot_id);
+    if (screenshot == NULL) {
+        wl_client_post_no_memory(client);
+        return;
+    }
+
+    capture_surface(ctrl, screenshot, buffer_resource, surface_id, 0, 0, 0, 0);
+    wl_resource_destroy(screenshot);
+}
+
+static void
+controller_surface_screenshot_region(struct wl_client *client,
+                                     struct wl_resource *resource,
+                                     struct wl_resource *buffer_resource,
+                                     uint32_t screenshot_id,
+                                     uint32_t surface_id,
+                                     int32_t x, int32_t y,
+                                     int32_t width, int32_t height)
+{
+    struct ivicontroller *ctrl = wl_resource_get_user_data(resource);
+    struct wl_resource *screenshot;
+
+    count_wm_request(resource, IVI_WM_REQUEST(surface_screenshot_region));
+
+    screenshot = wl_resource_create(client, &ivi_screenshot_interface,
+                                    wl_resource_get_version(resource),
+                                    screenshot_id);
+    if (screenshot == NULL) {
+        wl_client_post_no_memory(client);
+        return;
+    }
+
+    capture_surface(ctrl, screenshot, buffer_resource, surface_id,
+                    x, y, width, height);
+    wl_resource_destroy(screenshot);
+}
+
+#define XXH_PRIME32_1 0x9E3779B1U
+#define XXH_PRIME32_2 0x85EBCA77U
+#define XXH_PRIME32_3 0xC2B2AE3DU
+#define XXH_PRIME32_4 0x27D4EB2FU
+#define XXH_PRIME32_5 0x165667B1U
+
+static inline uint32_t
+xxh32_rotl(uint32_t x, int r)
+{
+    return (x << r) | (x >> (32 - r));
+}
+
+static inline uint32_t
+xxh32_read(const uint8_t *p)
+{
+    uint32_t v;
+
+    memcpy(&v, p, sizeof v);
+    return v;
+}
+
+static inline uint32_t
+xxh32_round(uint32_t acc, uint32_t input)
+{
+    acc += input * XXH_PRIME32_2;
+    acc = xxh32_rotl(acc, 13);
+    return acc * XXH_PRIME32_1;
+}
+
+/* xxHash32 with seed 0, the four independent lanes of the main loop
+ * let the compiler keep the content hashing close to memory bandwidth.
+ * The lanes stay scalar: packed into one SSE/NEON vector they form a
+ * single chain of vector multiplies, whose latency made the loop about
+ * a third slower. */
+static uint32_t
+content_hash(const void *data, size_t len)
+{
+    const uint8_t *p = data;
+    const uint8_t *end = p + len;
+    uint32_t v1 = XXH_PRIME32_1 + XXH_PRIME32_2;
+    uint32_t v2 = XXH_PRIME32_2;
+    uint32_t v3 = 0;
+    uint32_t v4 = 0 - XXH_PRIME32_1;
+    uint32_t h;
+
+    if (len >= 16) {
+        const uint8_t *limit = end - 16;
+
+        do {
+            v1 = xxh32_round(v1, xxh32_read(p));
+            v2 = xxh32_round(v2, xxh32_read(p + 4));
+            v3 = xxh32_round(v3, xxh32_read(p + 8));
+            v4 = xxh32_round(v4, xxh32_read(p + 12));
+            p += 16;
+        } while (p <= limit);
+
+        h = xxh32_rotl(v1, 1) + xxh32_rotl(v2, 7) +
+            xxh32_rotl(v3, 12) + xxh32_rotl(v4, 18);
+    } else {
+        h = XXH_PRIME32_5;
+    }
+
+    h += (uint32_t)len;
+
+    for (; p + 4 <= end; p += 4) {
+        h += xxh32_read(p) * XXH_PRIME32_3;
+        h = xxh32_rotl(h, 17) * XXH_PRIME32_4;
+    }
+
+    for (; p < end; p++) {
+        h += (*p) * XXH_PRIME32_5;
+        h = xxh32_rotl(h, 11) * XXH_PRIME32_1;
+    }
+
+    h ^= h >> 15;
+    h *= XXH_PRIME32_2;
+    h ^= h >> 13;
+    h *= XXH_PRIME32_3;
+    h ^= h >> 16;
+
+    return h;
+}
+
+static void
+controller_surface_checksum(struct wl_client *client,
+                            struct wl_resource *resource,
+                            uint32_t surface_id)
+{
+    struct ivicontroller *ctrl = wl_resource_get_user_data(resource);
+    const struct ivi_layout_interface *lyt = ctrl->shell->interface;
+    struct ivi_layout_surface *layout_surface;
+    struct weston_surface *weston_surface;
+    struct ivisurface *ivisurf;
+    int32_t width = 0, height = 0, stride = 0, size;
+    void *data;
+    (void)client;
+
+    count_wm_request(resource, IVI_WM_REQUEST(surface_checksum));
+
+    layout_surface = lyt->get_surface_from_id(surface_id);
+    ivisurf = get_surface(&ctrl->shell->list_surface, layout_surface);
+    if (!layout_surface || !ivisurf) {
+        count_wm_event(resource);
+        ivi_wm_send_surface_error(resource, surface_id,
+                                  IVI_WM_SURFACE_ERROR_NO_SURFACE,
+                                  "surface_checksum: the surface with given id does not exist");
+        return;
+    }
+
+    /* the content only changes with a commit of the surface, the hash
+     * is computed at the first request after it rather than on every
+     * commit, which would read back every surface nobody watches */
+    if (ivisurf->checksum_valid) {
+        count_wm_event(resource);
+        ivi_wm_send_surface_checksum(resource, surface_id, ivisurf->checksum);
+        return;
+    }
+
+    lyt->surface_get_size(layout_surface, &width, &height, &stride);
+    if (!width || !height || !stride) {
+        count_wm_event(resource);
+        ivi_wm_send_surface_error(resource, surface_id,
+                                  IVI_WM_SURFACE_ERROR_NO_CONTENT,
+                                  "surface_checksum: surface does not have content");
+        return;
+    }
+
+    size = stride * height;
+    data = malloc(size);
+    if (!data) {
+        wl_resource_post_no_memory(resource);
+        return;
+    }
+
+    weston_surface = lyt->surface_get_weston_surface(layout_surface);
+    if (lyt->surface_dump(weston_surface, data, size, 0, 0,
+                          width, height) != IVI_SUCCEEDED) {
+        count_wm_event(resource);
+        ivi_wm_send_surface_error(resource, surface_id,
+                                  IVI_WM_SURFACE_ERROR_NOT_SUPPORTED,
+                                  "surface_checksum: surface dumping is not supported by renderer");
+        free(data);
+        return;
+    }
+
+    ivisurf->checksum = content_hash(data, size);
+    ivisurf->checksum_valid = true;
+    free(data);
+
+    count_wm_event(resource);
+    ivi_wm_send_surface_checksum(resource, surface_id, ivisurf->checksum);
+}
+
 static void
 send_surface_stats(struct ivicontroller *ctrl,
                    struct ivi_layout_surface *layout_surface,
@@ -539,24 +1512,23 @@ send_surface_stats(struct ivicontroller *ctrl,
 
     wl_client_get_credentials(target_client, &pid, &uid, &gid);
 
+    count_wm_event(ctrl->resource);
     ivi_wm_send_surface_stats(ctrl->resource, surface_id, ivisurf->frame_count, pid);
 }
-
-static void
-controller_surface_sync(struct wl_client *client,
-                              struct wl_resource *resource,
-                              uint32_t surface_id,
-                              int32_t sync_state)
+
+static void
+surface_sync(struct wl_resource *resource, uint32_t surface_id,
+             int32_t sync_state, uint32_t mask, uint32_t max_rate)
 {
     struct ivicontroller *ctrl = wl_resource_get_user_data(resource);
     const struct ivi_layout_interface *lyt = ctrl->shell->interface;
     struct ivi_layout_surface *layout_surface;
     struct ivisurface *ivisurf;
-    (void)client;
     struct notification *noti;
 
     layout_surface = lyt->get_surface_from_id(surface_id);
     if (!layout_surface) {
+        count_wm_event(resource);
         ivi_wm_send_surface_error(resource, surface_id,
                                   IVI_WM_SURFACE_ERROR_NO_SURFACE,
                                   "surface_sync: the surface with given id does not exist");
@@ -568,34 +1540,57 @@ controller_surface_sync(struct wl_client *client,
     switch (sync_state) {
     case IVI_WM_SYNC_ADD:
         /*Check if a notification for the surface is already initialized*/
-        noti= calloc(1, sizeof *noti);
-        if (noti == NULL) {
-            wl_resource_post_no_memory(resource);
-            return;
+        wl_list_for_each(noti, &ivisurf->notification_list, layout_link) {
+            if (noti->resource == resource)
+                break;
+        }
+
+        if (&noti->layout_link == &ivisurf->notification_list) {
+            noti = calloc(1, sizeof *noti);
+            if (noti == NULL) {
+                wl_resource_post_no_memory(resource);
+                return;
+            }
+
+            wl_list_insert(&ctrl->surface_notifications, &noti->link);
+            wl_list_insert(&ivisurf->notification_list, &noti->layout_link);
+            noti->resource = resource;
+            noti->ivisurf = ivisurf;
         }
 
-        wl_list_insert(&ctrl->surface_notifications, &noti->link);
-        wl_list_insert(&ivisurf->notification_list, &noti->layout_link);
-        noti->resource = resource;
+        noti->mask = mask;
+        noti->min_interval = max_rate ? (1000 + max_rate - 1) / max_rate : 0;
         break;
     case IVI_WM_SYNC_REMOVE:
         wl_list_for_each(noti, &ivisurf->notification_list, layout_link)
         {
             if (noti->resource == resource) {
-                wl_list_remove(&noti->link);
-                wl_list_remove(&noti->layout_link);
-                free(noti);
+                destroy_notification(noti);
                 break;
             }
         }
         break;
     default:
+        count_wm_event(resource);
         ivi_wm_send_surface_error(resource, surface_id,
                                   IVI_WM_SURFACE_ERROR_BAD_PARAM,
                                   "surface_sync: invalid sync_state parameter");
     }
 }
 
+static void
+controller_surface_sync(struct wl_client *client,
+                              struct wl_resource *resource,
+                              uint32_t surface_id,
+                              int32_t sync_state)
+{
+    (void)client;
+
+    count_wm_request(resource, IVI_WM_REQUEST(surface_sync));
+
+    surface_sync(resource, surface_id, sync_state, IVI_NOTIFICATION_ALL, 0);
+}
+
 static void
 controller_set_surface_type(struct wl_client *client, struct wl_resource *resource,
                             uint32_t surface_id, int32_t type)
@@ -606,8 +1601,11 @@ controller_set_surface_type(struct wl_client *client, struct wl_resource *resour
     struct ivi_layout_surface *layout_surface;
     struct ivisurface *ivisurf;
 
+    count_wm_request(resource, IVI_WM_REQUEST(set_surface_type));
+
     layout_surface = lyt->get_surface_from_id(surface_id);
     if (!layout_surface) {
+        count_wm_event(resource);
         ivi_wm_send_surface_error(resource, surface_id,
                                   IVI_WM_SURFACE_ERROR_NO_SURFACE,
                                   "surface_set_type: the surface with given id does not exist");
@@ -635,6 +1633,15 @@ convert_protocol_enum(int32_t param)
         mask |= IVI_NOTIFICATION_CONFIGURE;
     }
 
+    if (param & IVI_WM_PARAM_SOURCE_RECTANGLE)
+        mask |= IVI_NOTIFICATION_SOURCE_RECT;
+
+    if (param & IVI_WM_PARAM_DESTINATION_RECTANGLE)
+        mask |= IVI_NOTIFICATION_DEST_RECT;
+
+    if (param & IVI_WM_PARAM_CONFIGURE)
+        mask |= IVI_NOTIFICATION_CONFIGURE;
+
     return mask;
 }
 
@@ -649,10 +1656,13 @@ controller_surface_get(struct wl_client *client, struct wl_resource *resource,
     enum ivi_layout_notification_mask mask;
     const struct ivi_layout_surface_properties *prop;
 
+    count_wm_request(resource, IVI_WM_REQUEST(surface_get));
+
     mask = convert_protocol_enum(param);
 
     layout_surface = lyt->get_surface_from_id(surface_id);
     if (!layout_surface) {
+        count_wm_event(resource);
         ivi_wm_send_surface_error(resource, surface_id,
                                   IVI_WM_SURFACE_ERROR_NO_SURFACE,
                                   "surface_get: the surface with given id does not exist");
@@ -680,8 +1690,11 @@ controller_set_layer_source_rectangle(struct wl_client *client,
     struct ivi_layout_layer *layout_layer;
     const struct ivi_layout_layer_properties *prop;
 
+    count_wm_request(resource, IVI_WM_REQUEST(set_layer_source_rectangle));
+
     layout_layer = lyt->get_layer_from_id(layer_id);
     if (!layout_layer) {
+        count_wm_event(resource);
         ivi_wm_send_layer_error(resource, layer_id,
                                 IVI_WM_LAYER_ERROR_NO_LAYER,
                                 "set_layer_source_rectangle: the layer with given id does not exist");
@@ -718,8 +1731,11 @@ controller_set_layer_destination_rectangle(struct wl_client *client,
     struct ivi_layout_layer *layout_layer;
     const struct ivi_layout_layer_properties *prop;
 
+    count_wm_request(resource, IVI_WM_REQUEST(set_layer_destination_rectangle));
+
     layout_layer = lyt->get_layer_from_id(layer_id);
     if (!layout_layer) {
+        count_wm_event(resource);
         ivi_wm_send_layer_error(resource, layer_id,
                                 IVI_WM_LAYER_ERROR_NO_LAYER,
                                 "set_layer_destination_rectangle: the layer with given id does not exist");
@@ -752,8 +1768,11 @@ controller_set_layer_visibility(struct wl_client *client,
     (void)client;
     struct ivi_layout_layer *layout_layer;
 
+    count_wm_request(resource, IVI_WM_REQUEST(set_layer_visibility));
+
     layout_layer = lyt->get_layer_from_id(layer_id);
     if (!layout_layer) {
+        count_wm_event(resource);
         ivi_wm_send_layer_error(resource, layer_id,
                                 IVI_WM_LAYER_ERROR_NO_LAYER,
                                 "layer_set_visibility: the layer with given id does not exist");
@@ -774,8 +1793,11 @@ controller_set_layer_opacity(struct wl_client *client,
     (void)client;
     struct ivi_layout_layer *layout_layer;
 
+    count_wm_request(resource, IVI_WM_REQUEST(set_layer_opacity));
+
     layout_layer = lyt->get_layer_from_id(layer_id);
     if (!layout_layer) {
+        count_wm_event(resource);
         ivi_wm_send_layer_error(resource, layer_id,
                                 IVI_WM_LAYER_ERROR_NO_LAYER,
                                 "layer_set_opacity: the layer with given id does not exist");
@@ -795,8 +1817,11 @@ controller_layer_clear(struct wl_client *client,
     (void)client;
     struct ivi_layout_layer *layout_layer;
 
+    count_wm_request(resource, IVI_WM_REQUEST(layer_clear));
+
     layout_layer = lyt->get_layer_from_id(layer_id);
     if (!layout_layer) {
+        count_wm_event(resource);
         ivi_wm_send_layer_error(resource, layer_id,
                                 IVI_WM_LAYER_ERROR_NO_LAYER,
                                 "layer_clear: the layer with given id does not exist");
@@ -853,6 +1878,14 @@ ivi_weston_surface_schedule_repaint(struct weston_surface *surface)
 			weston_output_schedule_repaint(output);
 }
 
+/* The native background is not an ivi surface */
+static bool
+is_bkgnd_surface_id(struct ivishell *shell, uint32_t surface_id)
+{
+    return !shell->bkgnd_native &&
+           shell->bkgnd_surface_id == (int32_t)surface_id;
+}
+
 void
 set_bkgnd_surface_prop(struct ivishell *shell)
 {
@@ -921,6 +1954,73 @@ set_bkgnd_surface_prop(struct ivishell *shell)
     }
 }
 
+static int
+bkgnd_get_label(struct weston_surface *surface, char *buf, size_t len)
+{
+    (void)surface;
+
+    return snprintf(buf, len, "ivi-controller background");
+}
+
+/*
+ * Shows bkgnd-color with a 1x1 solid color surface, which is scaled to
+ * cover all outputs by bkgnd_transform like the surface of the ivi client.
+ * The renderer fills it without any buffer memory.
+ */
+static int
+create_native_bkgnd(struct ivishell *shell)
+{
+    struct weston_compositor *compositor = shell->compositor;
+    struct weston_surface *surface;
+    uint32_t color = shell->bkgnd_color;
+
+    shell->bkgnd_buffer = weston_buffer_create_solid_rgba(compositor,
+            ((color >> 16) & 0xff) / 255.0f,
+            ((color >> 8) & 0xff) / 255.0f,
+            (color & 0xff) / 255.0f,
+            ((color >> 24) & 0xff) / 255.0f);
+    if (!shell->bkgnd_buffer)
+        return -1;
+
+    surface = weston_surface_create(compositor);
+    if (!surface) {
+        weston_buffer_destroy_solid(shell->bkgnd_buffer);
+        shell->bkgnd_buffer = NULL;
+        return -1;
+    }
+
+    weston_surface_set_label_func(surface, bkgnd_get_label);
+    weston_surface_attach_solid(surface, shell->bkgnd_buffer, 1, 1);
+
+    wl_list_init(&shell->bkgnd_transform.link);
+    shell->bkgnd_view = weston_view_create(surface);
+    weston_layer_entry_insert(&shell->bkgnd_layer.view_list,
+                              &shell->bkgnd_view->layer_link);
+    weston_surface_map(surface);
+    shell->bkgnd_view->is_mapped = true;
+
+    set_bkgnd_surface_prop(shell);
+    return 0;
+}
+
+static void
+destroy_native_bkgnd(struct ivishell *shell)
+{
+    struct weston_surface *surface;
+
+    if (!shell->bkgnd_buffer)
+        return;
+
+    surface = shell->bkgnd_view->surface;
+    weston_layer_entry_remove(&shell->bkgnd_view->layer_link);
+    weston_view_destroy(shell->bkgnd_view);
+    weston_surface_unref(surface);
+    weston_buffer_destroy_solid(shell->bkgnd_buffer);
+
+    shell->bkgnd_view = NULL;
+    shell->bkgnd_buffer = NULL;
+}
+
 static void
 controller_layer_add_surface(struct wl_client *client,
                  struct wl_resource *resource,
@@ -933,8 +2033,11 @@ controller_layer_add_surface(struct wl_client *client,
     struct ivi_layout_layer *layout_layer;
     struct ivi_layout_surface *layout_surface;
 
+    count_wm_request(resource, IVI_WM_REQUEST(layer_add_surface));
+
     layout_layer = lyt->get_layer_from_id(layer_id);
     if (!layout_layer) {
+        count_wm_event(resource);
         ivi_wm_send_layer_error(resource, layer_id,
                                 IVI_WM_LAYER_ERROR_NO_LAYER,
                                 "layer_add_surface: the layer with given id does not exist");
@@ -943,6 +2046,7 @@ controller_layer_add_surface(struct wl_client *client,
 
     layout_surface = lyt->get_surface_from_id(surface_id);
     if (!layout_surface) {
+        count_wm_event(resource);
         ivi_wm_send_layer_error(resource, surface_id,
                                 IVI_WM_LAYER_ERROR_NO_SURFACE,
                                 "layer_add_surface: the surface with given id does not exist");
@@ -964,8 +2068,11 @@ controller_layer_remove_surface(struct wl_client *client,
     struct ivi_layout_layer *layout_layer;
     struct ivi_layout_surface *layout_surface;
 
+    count_wm_request(resource, IVI_WM_REQUEST(layer_remove_surface));
+
     layout_layer = lyt->get_layer_from_id(layer_id);
     if (!layout_layer) {
+        count_wm_event(resource);
         ivi_wm_send_layer_error(resource, layer_id,
                                 IVI_WM_LAYER_ERROR_NO_LAYER,
                                 "layer_remove_surface: the layer with given id does not exist");
@@ -974,6 +2081,7 @@ controller_layer_remove_surface(struct wl_client *client,
 
     layout_surface = lyt->get_surface_from_id(surface_id);
     if (!layout_surface) {
+        count_wm_event(resource);
         ivi_wm_send_layer_error(resource, surface_id,
                                 IVI_WM_LAYER_ERROR_NO_SURFACE,
                                 "layer_remove_surface: the surface with given id does not exist");
@@ -984,20 +2092,18 @@ controller_layer_remove_surface(struct wl_client *client,
 }
 
 static void
-controller_layer_sync(struct wl_client *client,
-                      struct wl_resource *resource,
-                      uint32_t layer_id,
-                      int32_t sync_state)
+layer_sync(struct wl_resource *resource, uint32_t layer_id,
+           int32_t sync_state, uint32_t mask, uint32_t max_rate)
 {
     struct ivicontroller *ctrl = wl_resource_get_user_data(resource);
     const struct ivi_layout_interface *lyt = ctrl->shell->interface;
     struct ivi_layout_layer *layout_layer;
     struct ivilayer *ivilayer;
-    (void)client;
     struct notification *noti;
 
     layout_layer = lyt->get_layer_from_id(layer_id);
     if (!layout_layer) {
+        count_wm_event(resource);
         ivi_wm_send_layer_error(resource, layer_id,
                                 IVI_WM_LAYER_ERROR_NO_LAYER,
                                 "layer sync: the layer with given id does not exist");
@@ -1008,31 +2114,39 @@ controller_layer_sync(struct wl_client *client,
 
     switch (sync_state) {
     case IVI_WM_SYNC_ADD:
-        /*Check if a notification for the surface is already initialized*/
-        noti= calloc(1, sizeof *noti);
-        if (noti == NULL) {
-            wl_resource_post_no_memory(resource);
-            return;
+        /*Check if a notification for the layer is already initialized*/
+        wl_list_for_each(noti, &ivilayer->notification_list, layout_link) {
+            if (noti->resource == resource)
+                break;
+        }
+
+        if (&noti->layout_link == &ivilayer->notification_list) {
+            noti = calloc(1, sizeof *noti);
+            if (noti == NULL) {
+                wl_resource_post_no_memory(resource);
+                return;
+            }
+
+            wl_list_insert(&ctrl->layer_notifications, &noti->link);
+            wl_list_insert(&ivilayer->notification_list, &noti->layout_link);
+            noti->resource = resource;
+            noti->ivilayer = ivilayer;
         }
 
-        wl_list_insert(&ctrl->layer_notifications, &noti->link);
-        wl_list_insert(&ivilayer->notification_list, &noti->layout_link);
-        noti->resource = resource;
+        noti->mask = mask;
+        noti->min_interval = max_rate ? (1000 + max_rate - 1) / max_rate : 0;
         break;
     case IVI_WM_SYNC_REMOVE:
-        ivilayer = get_layer(&ctrl->shell->list_layer, layout_layer);
-
         wl_list_for_each(noti, &ivilayer->notification_list, layout_link)
         {
             if (noti->resource == resource) {
-                wl_list_remove(&noti->link);
-                wl_list_remove(&noti->layout_link);
-                free(noti);
+                destroy_notification(noti);
                 break;
             }
         }
         break;
     default:
+        count_wm_event(resource);
         ivi_wm_send_layer_error(resource, layer_id,
                                 IVI_WM_LAYER_ERROR_BAD_PARAM,
                                 "layer sync: invalid sync_state param");
@@ -1040,6 +2154,103 @@ controller_layer_sync(struct wl_client *client,
     }
 }
 
+static void
+controller_layer_sync(struct wl_client *client,
+                      struct wl_resource *resource,
+                      uint32_t layer_id,
+                      int32_t sync_state)
+{
+    (void)client;
+
+    count_wm_request(resource, IVI_WM_REQUEST(layer_sync));
+
+    layer_sync(resource, layer_id, sync_state, IVI_NOTIFICATION_ALL, 0);
+}
+
+static void
+controller_surface_sync_filtered(struct wl_client *client,
+                                 struct wl_resource *resource,
+                                 uint32_t surface_id,
+                                 int32_t sync_state,
+                                 int32_t param,
+                                 uint32_t max_rate)
+{
+    (void)client;
+
+    count_wm_request(resource, IVI_WM_REQUEST(surface_sync_filtered));
+
+    surface_sync(resource, surface_id, sync_state,
+                 convert_protocol_enum(param), max_rate);
+}
+
+static void
+controller_layer_sync_filtered(struct wl_client *client,
+                               struct wl_resource *resource,
+                               uint32_t layer_id,
+                               int32_t sync_state,
+                               int32_t param,
+                               uint32_t max_rate)
+{
+    (void)client;
+
+    count_wm_request(resource, IVI_WM_REQUEST(layer_sync_filtered));
+
+    layer_sync(resource, layer_id, sync_state,
+               convert_protocol_enum(param), max_rate);
+}
+
+static void
+controller_surface_sync_all(struct wl_client *client,
+                            struct wl_resource *resource,
+                            int32_t sync_state,
+                            int32_t param)
+{
+    struct ivicontroller *ctrl = wl_resource_get_user_data(resource);
+    (void)client;
+
+    count_wm_request(resource, IVI_WM_REQUEST(surface_sync_all));
+
+    switch (sync_state) {
+    case IVI_WM_SYNC_ADD:
+        ctrl->surface_sync_all_mask = convert_protocol_enum(param);
+        break;
+    case IVI_WM_SYNC_REMOVE:
+        ctrl->surface_sync_all_mask = 0;
+        break;
+    default:
+        count_wm_event(resource);
+        ivi_wm_send_surface_error(resource, 0,
+                                  IVI_WM_SURFACE_ERROR_BAD_PARAM,
+                                  "surface_sync_all: invalid sync_state parameter");
+    }
+}
+
+static void
+controller_layer_sync_all(struct wl_client *client,
+                          struct wl_resource *resource,
+                          int32_t sync_state,
+                          int32_t param)
+{
+    struct ivicontroller *ctrl = wl_resource_get_user_data(resource);
+    (void)client;
+
+    count_wm_request(resource, IVI_WM_REQUEST(layer_sync_all));
+
+    switch (sync_state) {
+    case IVI_WM_SYNC_ADD:
+        ctrl->layer_sync_all_mask = convert_protocol_enum(param);
+        break;
+    case IVI_WM_SYNC_REMOVE:
+        ctrl->layer_sync_all_mask = 0;
+        break;
+    default:
+        count_wm_event(resource);
+        ivi_wm_send_layer_error(resource, 0,
+                                IVI_WM_LAYER_ERROR_BAD_PARAM,
+                                "layer_sync_all: invalid sync_state param");
+    }
+}
+
 static void
 controller_create_layout_layer(struct wl_client *client,
                     struct wl_resource *resource, uint32_t layer_id,
@@ -1049,6 +2260,8 @@ controller_create_layout_layer(struct wl_client *client,
     const struct ivi_layout_interface *lyt = ctrl->shell->interface;
     (void)client;
 
+    count_wm_request(resource, IVI_WM_REQUEST(create_layout_layer));
+
      if(lyt->layer_create_with_dimension(layer_id, width, height) == NULL) {
          wl_resource_post_no_memory(resource);
      }
@@ -1063,8 +2276,11 @@ controller_destroy_layout_layer(struct wl_client *client,
     (void)client;
     struct ivi_layout_layer *layout_layer;
 
+    count_wm_request(resource, IVI_WM_REQUEST(destroy_layout_layer));
+
     layout_layer = lyt->get_layer_from_id(layer_id);
     if (!layout_layer) {
+        count_wm_event(resource);
         ivi_wm_send_layer_error(resource, layer_id,
                                 IVI_WM_LAYER_ERROR_NO_LAYER,
                                 "destroy_layout_layer: the layer with given id does not exist");
@@ -1088,8 +2304,11 @@ controller_layer_get(struct wl_client *client, struct wl_resource *resource,
     int32_t surface_count, i;
     uint32_t id;
 
+    count_wm_request(resource, IVI_WM_REQUEST(layer_get));
+
     layout_layer = lyt->get_layer_from_id(layer_id);
     if (!layout_layer) {
+        count_wm_event(resource);
         ivi_wm_send_layer_error(resource, layer_id,
                                 IVI_WM_LAYER_ERROR_NO_LAYER,
                                 "layer_get: the layer with given id does not exist");
@@ -1104,6 +2323,7 @@ controller_layer_get(struct wl_client *client, struct wl_resource *resource,
         lyt->get_surfaces_on_layer(layout_layer, &surface_count, &surf_list);
         for (i = 0; i < surface_count; i++) {
             id = lyt->get_id_of_surface(surf_list[i]);
+            count_wm_event(ctrl->resource);
             ivi_wm_send_layer_surface_added(ctrl->resource, layer_id, id);
         }
 
@@ -1116,6 +2336,7 @@ controller_screen_destroy(struct wl_client *client,
                           struct wl_resource *resource)
 {
     (void)client;
+    count_wm_screen_request(resource, IVI_WM_SCREEN_REQUEST(destroy));
     wl_resource_destroy(resource);
 }
 
@@ -1127,7 +2348,10 @@ controller_screen_clear(struct wl_client *client,
     const struct ivi_layout_interface *lyt;
     (void)client;
 
+    count_wm_screen_request(resource, IVI_WM_SCREEN_REQUEST(clear));
+
     if (!iviscrn) {
+        count_wm_screen_event(resource);
         ivi_wm_screen_send_error(resource, IVI_WM_SCREEN_ERROR_NO_SCREEN,
                                  "the output is already destroyed");
         return;
@@ -1147,7 +2371,10 @@ controller_screen_add_layer(struct wl_client *client,
     (void)client;
     struct ivi_layout_layer *layout_layer;
 
+    count_wm_screen_request(resource, IVI_WM_SCREEN_REQUEST(add_layer));
+
     if (!iviscrn) {
+        count_wm_screen_event(resource);
         ivi_wm_screen_send_error(resource, IVI_WM_SCREEN_ERROR_NO_SCREEN,
                                  "the output is already destroyed");
         return;
@@ -1156,6 +2383,7 @@ controller_screen_add_layer(struct wl_client *client,
     lyt = iviscrn->shell->interface;
     layout_layer = lyt->get_layer_from_id(layer_id);
     if (!layout_layer) {
+        count_wm_screen_event(resource);
         ivi_wm_screen_send_error(resource, IVI_WM_SCREEN_ERROR_NO_LAYER,
                                  "the layer with given id does not exist");
         weston_log("ivi-controller: an ivi-layer with id: %d does not exist\n", layer_id);
@@ -1175,7 +2403,10 @@ controller_screen_remove_layer(struct wl_client *client,
     (void)client;
     struct ivi_layout_layer *layout_layer;
 
+    count_wm_screen_request(resource, IVI_WM_SCREEN_REQUEST(remove_layer));
+
     if (!iviscrn) {
+        count_wm_screen_event(resource);
         ivi_wm_screen_send_error(resource, IVI_WM_SCREEN_ERROR_NO_SCREEN,
                                  "the output is already destroyed");
         return;
@@ -1184,6 +2415,7 @@ controller_screen_remove_layer(struct wl_client *client,
     lyt = iviscrn->shell->interface;
     layout_layer = lyt->get_layer_from_id(layer_id);
     if (!layout_layer) {
+        count_wm_screen_event(resource);
         ivi_wm_screen_send_error(resource, IVI_WM_SCREEN_ERROR_NO_LAYER,
                                  "the layer with given id does not exist");
         weston_log("ivi-controller: an ivi-layer with id: %d does not exist\n", layer_id);
@@ -1197,9 +2429,14 @@ static void
 controller_screenshooter_done(void *data, enum weston_screenshooter_outcome outcome)
 {
     struct ivi_screenshooter *screenshooter = data;
+    struct ivi_stats *stats = &screenshooter->shell->stats;
+    struct weston_mode *mode = screenshooter->output->current_mode;
 
     switch (outcome) {
         case WESTON_SCREENSHOOTER_SUCCESS:
+            ivi_stats_add(&stats->counters[IVI_STAT_SCREENSHOTS], 1);
+            ivi_stats_add(&stats->counters[IVI_STAT_SCREENSHOT_BYTES],
+                          (uint64_t)mode->width * mode->height * 4);
             ivi_screenshot_send_done(screenshooter->screenshot,
                     timespec_to_msec(&screenshooter->output->frame_time));
             break;
@@ -1214,67 +2451,372 @@ controller_screenshooter_done(void *data, enum weston_screenshooter_outcome outc
         default:
             break;
     }
+
+    ivi_trace_end(&screenshooter->span, "\"outcome\":%d", outcome);
+}
+
+static void
+controller_screenshoot_destroy(struct wl_resource *resource)
+{
+    struct ivi_screenshooter *screenshooter = 
+            wl_resource_get_user_data(resource);
+    free(screenshooter);
+}
+
+static void
+controller_screen_screenshot(struct wl_client *client,
+                             struct wl_resource *resource,
+                             struct wl_resource *buffer_resource,
+                             uint32_t id)
+{
+    struct iviscreen *iviscrn = wl_resource_get_user_data(resource);
+    struct ivi_screenshooter *screenshooter = NULL;
+    struct weston_buffer *buffer = NULL;
+
+    count_wm_screen_request(resource, IVI_WM_SCREEN_REQUEST(screenshot));
+
+    screenshooter = malloc(sizeof(struct ivi_screenshooter));
+    if(screenshooter == NULL) {
+        wl_resource_post_no_memory(resource);
+        return;
+    }
+
+    screenshooter->screenshot = wl_resource_create(client, 
+            &ivi_screenshot_interface, 2, id);
+
+    if (screenshooter->screenshot == NULL) {
+        wl_resource_post_no_memory(resource);
+        goto free;
+    }
+
+    if (!iviscrn) {
+        ivi_screenshot_send_error(screenshooter->screenshot,
+                IVI_SCREENSHOT_ERROR_NO_OUTPUT,
+                "the output is already destroyed");
+        goto error;
+    }
+
+    screenshooter->shell = iviscrn->shell;
+    screenshooter->output = iviscrn->output;
+    buffer = weston_buffer_from_resource
+            (screenshooter->output->compositor, buffer_resource);
+
+    if (buffer == NULL) {
+        ivi_screenshot_send_error(screenshooter->screenshot, 
+                IVI_SCREENSHOT_ERROR_BAD_BUFFER, "bad buffer input");
+        goto error;
+    }
+
+    wl_resource_set_implementation(screenshooter->screenshot, NULL, 
+            screenshooter, controller_screenshoot_destroy);
+    ivi_trace_begin(&screenshooter->span, iviscrn->shell->trace,
+                    "screen_screenshot");
+    weston_screenshooter_shoot(screenshooter->output, buffer, 
+            controller_screenshooter_done, screenshooter);
+    return;
+
+error:
+    wl_resource_destroy(screenshooter->screenshot);
+free:
+    free(screenshooter);
+}
+
+static void
+destroy_screen_readback(struct screen_readback *request)
+{
+    wl_list_remove(&request->frame_listener.link);
+    wl_list_remove(&request->output_destroy_listener.link);
+    wl_list_remove(&request->resource_destroy_listener.link);
+    if (request->output)
+        weston_output_disable_planes_decr(request->output);
+    free(request);
+}
+
+static void
+screen_readback_resource_destroyed(struct wl_listener *listener, void *data)
+{
+    struct screen_readback *request =
+            wl_container_of(listener, request, resource_destroy_listener);
+    (void)data;
+
+    destroy_screen_readback(request);
+}
+
+static void
+screen_readback_output_destroyed(struct wl_listener *listener, void *data)
+{
+    struct screen_readback *request =
+            wl_container_of(listener, request, output_destroy_listener);
+    (void)data;
+
+    request->output = NULL;
+    if (request->buffer) {
+        ivi_screenshot_send_error(request->resource,
+                                  IVI_SCREENSHOT_ERROR_NO_OUTPUT,
+                                  "the output is already destroyed");
+        wl_resource_destroy(request->resource);
+    } else {
+        count_wm_screen_event(request->resource);
+        ivi_wm_screen_send_error(request->resource,
+                                 IVI_WM_SCREEN_ERROR_NO_SCREEN,
+                                 "checksum: the output is already destroyed");
+        destroy_screen_readback(request);
+    }
+}
+
+static void
+screen_readback_send_thumbnail(struct screen_readback *request,
+                               const uint8_t *pixels)
+{
+    struct weston_output *output = request->output;
+    struct wl_shm_buffer *shm_buffer = request->buffer->shm_buffer;
+    int32_t stride = request->width * 4;
+
+    /* a renderer with y flipped readback returns the bottom row first */
+    if (output->compositor->capabilities & WESTON_CAP_CAPTURE_YFLIP) {
+        pixels += (size_t)stride * (request->height - 1);
+        stride = -stride;
+    }
+
+    if (write_capture(request->buffer, pixels, request->width,
+                      request->height, stride) < 0) {
+        ivi_screenshot_send_error(request->resource,
+                                  IVI_SCREENSHOT_ERROR_NO_MEMORY,
+                                  "internal allocate failed");
+        return;
+    }
+
+    ivi_stats_add(&request->shell->stats.counters[IVI_STAT_SCREENSHOTS], 1);
+    ivi_stats_add(&request->shell->stats.counters[IVI_STAT_SCREENSHOT_BYTES],
+                  (uint64_t)wl_shm_buffer_get_stride(shm_buffer) *
+                  wl_shm_buffer_get_height(shm_buffer));
+
+    ivi_screenshot_send_done(request->resource,
+                             timespec_to_msec(&output->frame_time));
+}
+
+static void
+screen_readback_frame_notify(struct wl_listener *listener, void *data)
+{
+    struct screen_readback *request =
+            wl_container_of(listener, request, frame_listener);
+    struct weston_output *output = request->output;
+    struct weston_compositor *compositor = output->compositor;
+    struct wl_resource *screenshot = NULL;
+    const struct pixel_format_info *format;
+    int32_t y = request->y;
+    size_t size;
+    void *pixels;
+    struct ivi_trace_span span;
+    (void)data;
+
+    ivi_trace_begin(&span, request->shell->trace, "screen_readback");
+    if (request->buffer)
+        screenshot = request->resource;
+
+    size = (size_t)request->width * request->height * 4;
+    pixels = malloc(size);
+    if (!pixels) {
+        if (screenshot) {
+            ivi_screenshot_send_error(screenshot,
+                                      IVI_SCREENSHOT_ERROR_NO_MEMORY,
+                                      "internal allocate failed");
+            wl_resource_destroy(screenshot);
+        } else {
+            wl_resource_post_no_memory(request->resource);
+            destroy_screen_readback(request);
+        }
+        return;
+    }
+
+    if (compositor->capabilities & WESTON_CAP_CAPTURE_YFLIP)
+        y = output->current_mode->height - request->y - request->height;
+
+    /* the screen is read in the byte order of surface_dump, so that
+     * captures and checksums do not depend on the renderer */
+    format = pixel_format_get_info_shm(WL_SHM_FORMAT_ABGR8888);
+    if (!format ||
+        compositor->renderer->read_pixels(output, format,
+                                          pixels, request->x, y,
+                                          request->width,
+                                          request->height) < 0) {
+        if (screenshot) {
+            ivi_screenshot_send_error(screenshot,
+                                      IVI_SCREENSHOT_ERROR_NOT_SUPPORTED,
+                                      "reading the output failed");
+        } else {
+            count_wm_screen_event(request->resource);
+            ivi_wm_screen_send_error(request->resource,
+                                     IVI_WM_SCREEN_ERROR_BAD_PARAM,
+                                     "checksum: reading the output failed");
+        }
+    } else if (screenshot) {
+        screen_readback_send_thumbnail(request, pixels);
+    } else {
+        count_wm_screen_event(request->resource);
+        ivi_wm_screen_send_checksum(request->resource,
+                                    content_hash(pixels, size));
+    }
+
+    free(pixels);
+    ivi_trace_end(&span, "\"width\":%d,\"height\":%d,\"screenshot\":%s",
+                  request->width, request->height,
+                  screenshot ? "true" : "false");
+
+    if (screenshot)
+        wl_resource_destroy(screenshot);
+    else
+        destroy_screen_readback(request);
+}
+
+static struct screen_readback *
+create_screen_readback(struct iviscreen *iviscrn, struct wl_resource *resource,
+                       int32_t x, int32_t y, int32_t width, int32_t height)
+{
+    struct weston_output *output = iviscrn->output;
+    struct screen_readback *request;
+
+    request = calloc(1, sizeof *request);
+    if (!request)
+        return NULL;
+
+    request->shell = iviscrn->shell;
+    request->resource = resource;
+    request->output = output;
+    request->x = x;
+    request->y = y;
+    request->width = width;
+    request->height = height;
+
+    request->resource_destroy_listener.notify = screen_readback_resource_destroyed;
+    wl_resource_add_destroy_listener(resource,
+                                     &request->resource_destroy_listener);
+
+    request->output_destroy_listener.notify = screen_readback_output_destroyed;
+    wl_signal_add(&output->destroy_signal, &request->output_destroy_listener);
+
+    /* the output is read back after the next repaint, all views have to be
+     * composited by the renderer for that */
+    request->frame_listener.notify = screen_readback_frame_notify;
+    wl_signal_add(&output->frame_signal, &request->frame_listener);
+    weston_output_disable_planes_incr(output);
+    weston_output_schedule_repaint(output);
+
+    return request;
 }
 
 static void
-controller_screenshoot_destroy(struct wl_resource *resource)
+controller_screen_checksum(struct wl_client *client,
+                           struct wl_resource *resource,
+                           int32_t x, int32_t y,
+                           int32_t width, int32_t height)
 {
-    struct ivi_screenshooter *screenshooter = 
-            wl_resource_get_user_data(resource);
-    free(screenshooter);
+    struct iviscreen *iviscrn = wl_resource_get_user_data(resource);
+    struct weston_mode *mode;
+    (void)client;
+
+    count_wm_screen_request(resource, IVI_WM_SCREEN_REQUEST(checksum));
+
+    if (!iviscrn) {
+        count_wm_screen_event(resource);
+        ivi_wm_screen_send_error(resource, IVI_WM_SCREEN_ERROR_NO_SCREEN,
+                                 "the output is already destroyed");
+        return;
+    }
+
+    mode = iviscrn->output->current_mode;
+    if (width == 0 && height == 0) {
+        width = mode->width - x;
+        height = mode->height - y;
+    }
+
+    if (x < 0 || y < 0 || width <= 0 || height <= 0 ||
+        x + width > mode->width || y + height > mode->height) {
+        count_wm_screen_event(resource);
+        ivi_wm_screen_send_error(resource, IVI_WM_SCREEN_ERROR_BAD_PARAM,
+                                 "checksum: region is outside of the output");
+        return;
+    }
+
+    if (!create_screen_readback(iviscrn, resource, x, y, width, height))
+        wl_resource_post_no_memory(resource);
 }
 
+/* Reads back the given region of the screen into the capture buffer after
+ * the next repaint, the region is scaled to the size of the buffer */
 static void
-controller_screen_screenshot(struct wl_client *client,
-                             struct wl_resource *resource,
-                             struct wl_resource *buffer_resource,
-                             uint32_t id)
+capture_screen(struct wl_client *client, struct wl_resource *resource,
+               struct wl_resource *buffer_resource, uint32_t id,
+               int32_t x, int32_t y, int32_t width, int32_t height)
 {
     struct iviscreen *iviscrn = wl_resource_get_user_data(resource);
-    struct ivi_screenshooter *screenshooter = NULL;
-    struct weston_buffer *buffer = NULL;
+    struct screen_readback *request;
+    struct wl_resource *screenshot;
+    struct weston_buffer *buffer;
+    struct weston_mode *mode;
 
-    screenshooter = malloc(sizeof(struct ivi_screenshooter));
-    if(screenshooter == NULL) {
+    screenshot = wl_resource_create(client, &ivi_screenshot_interface,
+                                    wl_resource_get_version(resource), id);
+    if (screenshot == NULL) {
         wl_resource_post_no_memory(resource);
         return;
     }
 
-    screenshooter->screenshot = wl_resource_create(client, 
-            &ivi_screenshot_interface, 2, id);
-
-    if (screenshooter->screenshot == NULL) {
-        wl_resource_post_no_memory(resource);
-        goto free;
+    if (!iviscrn) {
+        ivi_screenshot_send_error(screenshot, IVI_SCREENSHOT_ERROR_NO_OUTPUT,
+                                  "the output is already destroyed");
+        goto err;
     }
 
-    if (!iviscrn) {
-        ivi_screenshot_send_error(screenshooter->screenshot,
-                IVI_SCREENSHOT_ERROR_NO_OUTPUT,
-                "the output is already destroyed");
-        goto error;
+    mode = iviscrn->output->current_mode;
+    if (width == 0 && height == 0) {
+        width = mode->width - x;
+        height = mode->height - y;
     }
 
-    screenshooter->output = iviscrn->output;
-    buffer = weston_buffer_from_resource
-            (screenshooter->output->compositor, buffer_resource);
+    buffer = get_capture_buffer(iviscrn->shell->compositor, buffer_resource);
+    if (!buffer || x < 0 || y < 0 || width <= 0 || height <= 0 ||
+        x + width > mode->width || y + height > mode->height) {
+        ivi_screenshot_send_error(screenshot, IVI_SCREENSHOT_ERROR_BAD_BUFFER,
+                                  "bad buffer input");
+        goto err;
+    }
 
-    if (buffer == NULL) {
-        ivi_screenshot_send_error(screenshooter->screenshot, 
-                IVI_SCREENSHOT_ERROR_BAD_BUFFER, "bad buffer input");
-        goto error;
+    request = create_screen_readback(iviscrn, screenshot,
+                                     x, y, width, height);
+    if (!request) {
+        ivi_screenshot_send_error(screenshot, IVI_SCREENSHOT_ERROR_NO_MEMORY,
+                                  "internal allocate failed");
+        goto err;
     }
 
-    wl_resource_set_implementation(screenshooter->screenshot, NULL, 
-            screenshooter, controller_screenshoot_destroy);
-    weston_screenshooter_shoot(screenshooter->output, buffer, 
-            controller_screenshooter_done, screenshooter);
+    request->buffer = buffer;
     return;
 
-error:
-    wl_resource_destroy(screenshooter->screenshot);
-free:
-    free(screenshooter);
+err:
+    wl_resource_destroy(screenshot);
+}
+
+static void
+controller_screen_thumbnail(struct wl_client *client,
+                            struct wl_resource *resource,
+                            struct wl_resource *buffer_resource,
+                            uint32_t id)
+{
+    count_wm_screen_request(resource, IVI_WM_SCREEN_REQUEST(thumbnail));
+    capture_screen(client, resource, buffer_resource, id, 0, 0, 0, 0);
+}
+
+static void
+controller_screen_screenshot_region(struct wl_client *client,
+                                    struct wl_resource *resource,
+                                    struct wl_resource *buffer_resource,
+                                    uint32_t id, int32_t x, int32_t y,
+                                    int32_t width, int32_t height)
+{
+    count_wm_screen_request(resource, IVI_WM_SCREEN_REQUEST(screenshot_region));
+    capture_screen(client, resource, buffer_resource, id,
+                   x, y, width, height);
 }
 
 static void
@@ -1289,7 +2831,10 @@ controller_screen_get(struct wl_client *client,
     int32_t layer_count, i;
     uint32_t id;
 
+    count_wm_screen_request(resource, IVI_WM_SCREEN_REQUEST(get));
+
     if (!iviscrn) {
+        count_wm_screen_event(resource);
         ivi_wm_screen_send_error(resource, IVI_WM_SCREEN_ERROR_NO_SCREEN,
                                  "the output is already destroyed");
         return;
@@ -1302,6 +2847,7 @@ controller_screen_get(struct wl_client *client,
 
         for (i = 0; i < layer_count; i++) {
             id = lyt->get_id_of_layer(layer_list[i]);
+            count_wm_screen_event(resource);
             ivi_wm_screen_send_layer_added(resource, id);
 	}
 
@@ -1316,7 +2862,10 @@ struct ivi_wm_screen_interface controller_screen_implementation = {
     controller_screen_add_layer,
     controller_screen_remove_layer,
     controller_screen_screenshot,
-    controller_screen_get
+    controller_screen_get,
+    controller_screen_checksum,
+    controller_screen_thumbnail,
+    controller_screen_screenshot_region
 };
 
 static void
@@ -1326,11 +2875,31 @@ controller_commit_changes(struct wl_client *client,
     int32_t ans = 0;
     (void)client;
     struct ivicontroller *controller = wl_resource_get_user_data(resource);
+    struct ivi_stats *stats = &controller->shell->stats;
+    struct ivi_trace_span span;
+    struct timespec start, end;
+    uint64_t duration;
+
+    count_wm_request(resource, IVI_WM_REQUEST(commit_changes));
 
+    ivi_trace_begin(&span, controller->shell->trace, "commit_changes");
+    clock_gettime(CLOCK_MONOTONIC, &start);
     ans = controller->shell->interface->commit_changes();
     if (ans < 0) {
         weston_log("Failed to commit changes at controller_commit_changes\n");
     }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    ivi_trace_end(&span, "\"result\":%d", ans);
+
+    duration = timespec_to_usec(&end) - timespec_to_usec(&start);
+    ivi_stats_add(&stats->counters[IVI_STAT_COMMITS], 1);
+    ivi_stats_add(&stats->counters[IVI_STAT_COMMIT_TIME_US], duration);
+    ivi_stats_max(&stats->counters[IVI_STAT_COMMIT_TIME_MAX_US], duration);
+
+    ivi_trace_begin(&span, controller->shell->trace, "layout_committed");
+    wl_signal_emit(&controller->shell->layout_committed_signal,
+                   controller->shell);
+    ivi_trace_end(&span, "%s", "");
 }
 
 static void
@@ -1345,13 +2914,16 @@ controller_create_screen(struct wl_client *client,
     struct ivicontroller *ctrl = wl_resource_get_user_data(resource);
     struct iviscreen* iviscrn = NULL;
 
+    count_wm_request(resource, IVI_WM_REQUEST(create_screen));
 
     wl_list_for_each(iviscrn, &ctrl->shell->list_screen, link) {
         if (weston_head->output != iviscrn->output) {
             continue;
         }
 
-        screen_resource = wl_resource_create(client, &ivi_wm_screen_interface, 1, id);
+        screen_resource = wl_resource_create(client, &ivi_wm_screen_interface,
+                                             wl_resource_get_version(resource),
+                                             id);
         if (screen_resource == NULL) {
             wl_resource_post_no_memory(resource);
             return;
@@ -1363,11 +2935,168 @@ controller_create_screen(struct wl_client *client,
 
         wl_list_insert(&iviscrn->resource_list, wl_resource_get_link(screen_resource));
 
+        count_wm_screen_event(screen_resource);
         ivi_wm_screen_send_screen_id(screen_resource, iviscrn->id_screen);
+        count_wm_screen_event(screen_resource);
         ivi_wm_screen_send_connector_name(screen_resource, iviscrn->output->name);
     }
 }
 
+typedef void (*stat_func_t)(void *data, const char *name, uint64_t value);
+
+static const char *const startup_names[IVI_STARTUP_COUNT] = {
+    [IVI_STARTUP_MODULE_INIT] = "module_init",
+    [IVI_STARTUP_CONFIG] = "config",
+    [IVI_STARTUP_SHELL] = "shell",
+    [IVI_STARTUP_SERVER] = "server",
+    [IVI_STARTUP_INPUT_MODULE] = "input_module",
+    [IVI_STARTUP_ID_AGENT_MODULE] = "id_agent_module",
+    [IVI_STARTUP_CLIENT_LAUNCH] = "client_launch",
+    [IVI_STARTUP_FIRST_FRAME] = "first_frame",
+};
+
+static void
+startup_log(struct ivishell *shell, const char *what, uint64_t usec)
+{
+    uint64_t start =
+            ivi_stats_get(&shell->stats.startup[IVI_STARTUP_MODULE_INIT]);
+
+    weston_log("ivi-controller: startup %s at %" PRIu64 " us (+%" PRIu64
+               " us)\n", what, usec, usec - start);
+}
+
+static void
+startup_mark(struct ivishell *shell, enum ivi_startup stage)
+{
+    uint64_t usec = ivi_stats_mark(&shell->stats.startup[stage]);
+
+    startup_log(shell, startup_names[stage], usec);
+}
+
+static void
+for_each_request_stat(atomic_uint_fast64_t *counters,
+                      const struct wl_interface *interface,
+                      stat_func_t func, void *data)
+{
+    char name[128];
+    uint64_t value;
+    int i;
+
+    for (i = 0; i < interface->method_count && i < IVI_STATS_MAX_OPCODES;
+         i++) {
+        value = ivi_stats_get(&counters[i]);
+        if (value == 0)
+            continue;
+
+        snprintf(name, sizeof name, "requests.%s.%s", interface->name,
+                 interface->methods[i].name);
+        func(data, name, value);
+    }
+}
+
+/* Reports the counter block and the counts computed from the lists */
+static void
+for_each_stat(struct ivishell *shell, stat_func_t func, void *data)
+{
+    static const char *const counter_names[IVI_STAT_COUNT] = {
+        [IVI_STAT_EVENTS] = "events",
+        [IVI_STAT_COMMITS] = "commits",
+        [IVI_STAT_COMMIT_TIME_US] = "commit_time_us",
+        [IVI_STAT_COMMIT_TIME_MAX_US] = "commit_time_max_us",
+        [IVI_STAT_SCREENSHOTS] = "screenshots",
+        [IVI_STAT_SCREENSHOT_BYTES] = "screenshot_bytes",
+        [IVI_STAT_CONFIGURE_COMMITS] = "configure_commits",
+        [IVI_STAT_CONFIGURE_SURFACES] = "configure_surfaces",
+    };
+    struct ivi_stats *stats = &shell->stats;
+    struct ivicontroller *controller;
+    struct ivisurface *ivisurf;
+    struct ivilayer *ivilayer;
+    struct iviscreen *iviscrn;
+    uint64_t notifications = 0;
+    uint64_t value;
+    char name[64];
+    pid_t pid;
+    int i;
+
+    for (i = 0; i < IVI_STAT_COUNT; i++) {
+        value = ivi_stats_get(&stats->counters[i]);
+        if (i == IVI_STAT_EVENTS) {
+            wl_list_for_each(controller, &shell->list_controller, link)
+                value += ivi_stats_get(&controller->events);
+        }
+
+        func(data, counter_names[i], value);
+    }
+
+    for (i = 0; i < IVI_STARTUP_COUNT; i++) {
+        value = ivi_stats_get(&stats->startup[i]);
+        if (value == 0)
+            continue;
+
+        snprintf(name, sizeof name, "startup.%s_us", startup_names[i]);
+        func(data, name, value);
+    }
+
+    wl_list_for_each(iviscrn, &shell->list_screen, link) {
+        if (iviscrn->first_frame_us == 0)
+            continue;
+
+        snprintf(name, sizeof name, "startup.first_frame.%s_us",
+                 iviscrn->output->name);
+        func(data, name, iviscrn->first_frame_us);
+    }
+
+    for_each_request_stat(stats->ivi_wm_requests, &ivi_wm_interface,
+                          func, data);
+    for_each_request_stat(stats->ivi_wm_screen_requests,
+                          &ivi_wm_screen_interface, func, data);
+
+    wl_list_for_each(controller, &shell->list_controller, link) {
+        wl_client_get_credentials(controller->client, &pid, NULL, NULL);
+
+        snprintf(name, sizeof name, "controller.%d.events", pid);
+        func(data, name, ivi_stats_get(&controller->events));
+        snprintf(name, sizeof name, "controller.%d.events_merged", pid);
+        func(data, name, controller->events_merged);
+        snprintf(name, sizeof name, "controller.%d.events_dropped", pid);
+        func(data, name, controller->events_dropped);
+    }
+
+    wl_list_for_each(ivisurf, &shell->list_surface, link)
+        notifications += wl_list_length(&ivisurf->notification_list);
+
+    wl_list_for_each(ivilayer, &shell->list_layer, link)
+        notifications += wl_list_length(&ivilayer->notification_list);
+
+    func(data, "notifications", notifications);
+    func(data, "controllers", wl_list_length(&shell->list_controller));
+    func(data, "surfaces", wl_list_length(&shell->list_surface));
+    func(data, "layers", wl_list_length(&shell->list_layer));
+    func(data, "screens", wl_list_length(&shell->list_screen));
+}
+
+static void
+send_stat(void *data, const char *name, uint64_t value)
+{
+    struct wl_resource *resource = data;
+
+    count_wm_event(resource);
+    ivi_wm_send_stat(resource, name, (uint32_t)(value >> 32),
+                     (uint32_t)value);
+}
+
+static void
+controller_get_stats(struct wl_client *client, struct wl_resource *resource)
+{
+    struct ivicontroller *controller = wl_resource_get_user_data(resource);
+    (void)client;
+
+    count_wm_request(resource, IVI_WM_REQUEST(get_stats));
+
+    for_each_stat(controller->shell, send_stat, resource);
+}
+
 static const struct ivi_wm_interface controller_implementation = {
     controller_commit_changes,
     controller_create_screen,
@@ -1389,7 +3118,15 @@ static const struct ivi_wm_interface controller_implementation = {
     controller_layer_add_surface,
     controller_layer_remove_surface,
     controller_create_layout_layer,
-    controller_destroy_layout_layer
+    controller_destroy_layout_layer,
+    controller_surface_sync_filtered,
+    controller_layer_sync_filtered,
+    controller_surface_sync_all,
+    controller_layer_sync_all,
+    controller_surface_checksum,
+    controller_surface_thumbnail,
+    controller_surface_screenshot_region,
+    controller_get_stats
 };
 
 static void
@@ -1402,6 +3139,8 @@ bind_ivi_controller(struct wl_client *client, void *data,
     uint32_t surface_id, layer_id;
     struct ivisurface *ivisurf;
     struct ivilayer *ivilayer;
+    socklen_t len;
+    int i;
 
     /* Version 2 of ivi-wm is not compatible with older versions.
      * Don't allow to binding if client is trying with older versions */
@@ -1437,18 +3176,53 @@ bind_ivi_controller(struct wl_client *client, void *data,
     wl_list_insert(&shell->list_controller, &controller->link);
     wl_list_init(&controller->surface_notifications);
     wl_list_init(&controller->layer_notifications);
+    wl_list_init(&controller->dirty_list);
+    for (i = 0; i < DIRTY_HASH_SIZE; i++)
+        wl_list_init(&controller->dirty_hash[i]);
+
+    len = sizeof controller->sndbuf;
+    if (getsockopt(wl_client_get_fd(client), SOL_SOCKET, SO_SNDBUF,
+                   &controller->sndbuf, &len) < 0)
+        controller->sndbuf = 0;
 
     wl_list_for_each_reverse(ivisurf, &shell->list_surface, link) {
         surface_id = shell->interface->get_id_of_surface(ivisurf->layout_surface);
+        count_wm_event(controller->resource);
         ivi_wm_send_surface_created(controller->resource, surface_id);
     }
 
     wl_list_for_each_reverse(ivilayer, &shell->list_layer, link) {
         layer_id = shell->interface->get_id_of_layer(ivilayer->layout_layer);
+        count_wm_event(controller->resource);
         ivi_wm_send_layer_created(controller->resource, layer_id);
     }
 }
 
+/* Only the first frame of an output is timed, the first one of all
+ * outputs is the time to the first frame of the compositor */
+static void
+screen_first_frame(struct wl_listener *listener, void *data)
+{
+    struct iviscreen *iviscrn =
+            wl_container_of(listener, iviscrn, frame_listener);
+    struct ivishell *shell = iviscrn->shell;
+    char what[128];
+    struct timespec now;
+    (void)data;
+
+    wl_list_remove(&iviscrn->frame_listener.link);
+    wl_list_init(&iviscrn->frame_listener.link);
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    iviscrn->first_frame_us = timespec_to_usec(&now);
+
+    snprintf(what, sizeof what, "first frame of %s", iviscrn->output->name);
+    startup_log(shell, what, iviscrn->first_frame_us);
+
+    if (ivi_stats_get(&shell->stats.startup[IVI_STARTUP_FIRST_FRAME]) == 0)
+        startup_mark(shell, IVI_STARTUP_FIRST_FRAME);
+}
+
 static void
 create_screen(struct ivishell *shell, struct weston_output *output)
 {
@@ -1480,6 +3254,9 @@ create_screen(struct ivishell *shell, struct weston_output *output)
     wl_list_insert(&shell->list_screen, &iviscrn->link);
     wl_list_init(&iviscrn->resource_list);
 
+    iviscrn->frame_listener.notify = screen_first_frame;
+    wl_signal_add(&output->frame_signal, &iviscrn->frame_listener);
+
     return;
 }
 
@@ -1488,6 +3265,8 @@ destroy_screen(struct iviscreen *iviscrn)
 {
     struct wl_resource *resource, *next;
 
+    wl_list_remove(&iviscrn->frame_listener.link);
+
     wl_resource_for_each_safe(resource, next, &iviscrn->resource_list) {
         wl_resource_set_destructor(resource, NULL);
         wl_resource_destroy(resource);
@@ -1510,7 +3289,7 @@ output_destroyed_event(struct wl_listener *listener, void *data)
             destroy_screen(iviscrn);
     }
 
-    if (shell->bkgnd_view && shell->client)
+    if (shell->bkgnd_view && (shell->client || shell->bkgnd_native))
         set_bkgnd_surface_prop(shell);
     else
         weston_compositor_schedule_repaint(shell->compositor);
@@ -1521,7 +3300,7 @@ output_resized_event(struct wl_listener *listener, void *data)
 {
     struct ivishell *shell = wl_container_of(listener, shell, output_resized);
 
-    if (shell->bkgnd_view && shell->client)
+    if (shell->bkgnd_view && (shell->client || shell->bkgnd_native))
         set_bkgnd_surface_prop(shell);
 }
 
@@ -1533,7 +3312,7 @@ output_created_event(struct wl_listener *listener, void *data)
 
     create_screen(shell, created_output);
 
-    if (shell->bkgnd_view && shell->client)
+    if (shell->bkgnd_view && (shell->client || shell->bkgnd_native))
         set_bkgnd_surface_prop(shell);
     else
         weston_compositor_schedule_repaint(shell->compositor);
@@ -1564,8 +3343,10 @@ create_layer(struct ivishell *shell,
     lyt->layer_add_listener(layout_layer, &ivilayer->property_changed);
 
     wl_list_for_each(controller, &shell->list_controller, link) {
-        if (controller->resource)
+        if (controller->resource) {
+            count_wm_event(controller->resource);
             ivi_wm_send_layer_created(controller->resource, id_layer);
+        }
     }
 
     return ivilayer;
@@ -1578,6 +3359,7 @@ surface_committed(struct wl_listener *listener, void *data)
     (void)data;
 
     ivisurf->frame_count++;
+    ivisurf->checksum_valid = false;
 }
 
 static struct ivisurface*
@@ -1600,18 +3382,21 @@ create_surface(struct ivishell *shell,
     ivisurf->layout_surface = layout_surface;
     ivisurf->prop = lyt->get_properties_of_surface(layout_surface);
     wl_list_init(&ivisurf->notification_list);
+    wl_list_init(&ivisurf->pending_configure_link);
 
     ivisurf->committed.notify = surface_committed;
     surface = lyt->surface_get_weston_surface(layout_surface);
     wl_signal_add(&surface->commit_signal, &ivisurf->committed);
 
-    if (shell->bkgnd_surface_id != (int32_t)id_surface) {
+    if (!is_bkgnd_surface_id(shell, id_surface)) {
         wl_list_insert(&shell->list_surface, &ivisurf->link);
 
         wl_list_for_each(controller, &shell->list_controller, link) {
-            if (controller->resource)
+            if (controller->resource) {
+                count_wm_event(controller->resource);
                 ivi_wm_send_surface_created(controller->resource, id_surface);
             }
+        }
 
         ivisurf->property_changed.notify = send_surface_prop;
         lyt->surface_add_listener(layout_surface, &ivisurf->property_changed);
@@ -1661,9 +3446,7 @@ layer_event_remove(struct wl_listener *listener, void *data)
 
     wl_list_for_each_safe(noti, next, &ivilayer->notification_list, layout_link)
     {
-        wl_list_remove(&noti->link);
-        wl_list_remove(&noti->layout_link);
-        free(noti);
+        destroy_notification(noti);
     }
 
     wl_list_remove(&ivilayer->link);
@@ -1673,8 +3456,10 @@ layer_event_remove(struct wl_listener *listener, void *data)
     id_layer = shell->interface->get_id_of_layer(layout_layer);
 
     wl_list_for_each(controller, &shell->list_controller, link) {
-        if (controller->resource)
+        if (controller->resource) {
+            count_wm_event(controller->resource);
             ivi_wm_send_layer_destroyed(controller->resource, id_layer);
+        }
     }
 }
 
@@ -1699,15 +3484,18 @@ surface_event_create(struct wl_listener *listener, void *data)
     struct ivi_layout_surface *layout_surface =
            (struct ivi_layout_surface *) data;
     uint32_t id_surface = 0;
+    struct ivi_trace_span span;
 
     id_surface = lyt->get_id_of_surface(layout_surface);
 
     if ((id_surface == IVI_INVALID_ID) &&
             surface_is_desktop_surface(shell, layout_surface)) {
+        ivi_trace_begin(&span, shell->trace, "id_allocation");
         wl_signal_emit(&shell->id_allocation_request_signal, layout_surface);
 
         /* Trying to get surface_id after allocated id*/
         id_surface = lyt->get_id_of_surface(layout_surface);
+        ivi_trace_end(&span, "\"id\":%u", id_surface);
     }
 
     ivisurf = create_surface(shell, layout_surface, id_surface);
@@ -1716,8 +3504,11 @@ surface_event_create(struct wl_listener *listener, void *data)
         return;
     }
 
-    if (shell->bkgnd_surface_id != (int32_t)id_surface)
+    if (!is_bkgnd_surface_id(shell, id_surface)) {
+        ivi_trace_begin(&span, shell->trace, "ivisurface_created");
         wl_signal_emit(&shell->ivisurface_created_signal, ivisurf);
+        ivi_trace_end(&span, "\"id\":%u", id_surface);
+    }
 }
 
 static void
@@ -1726,11 +3517,10 @@ remove_common_surface(struct ivisurface *ivisurf)
     struct notification *noti, *next;
 
     wl_list_for_each_safe(noti, next, &ivisurf->notification_list, layout_link) {
-        wl_list_remove(&noti->link);
-        wl_list_remove(&noti->layout_link);
-        free(noti);
+        destroy_notification(noti);
     }
 
+    wl_list_remove(&ivisurf->pending_configure_link);
     wl_list_remove(&ivisurf->committed.link);
     free(ivisurf);
 }
@@ -1753,12 +3543,17 @@ remove_ivi_surface(struct ivishell *shell,
         struct ivisurface *ivisurf, uint32_t id_surface)
 {
     struct ivicontroller *controller = NULL;
+    struct ivi_trace_span span;
 
+    ivi_trace_begin(&span, shell->trace, "ivisurface_removed");
     wl_signal_emit(&shell->ivisurface_removed_signal, ivisurf);
+    ivi_trace_end(&span, "\"id\":%u", id_surface);
 
     wl_list_for_each(controller, &shell->list_controller, link) {
-        if (controller->resource)
+        if (controller->resource) {
+            count_wm_event(controller->resource);
             ivi_wm_send_surface_destroyed(controller->resource, id_surface);
+        }
     }
 
     wl_list_remove(&ivisurf->link);
@@ -1779,7 +3574,7 @@ surface_event_remove(struct wl_listener *listener, void *data)
     id_surface = shell->interface->get_id_of_surface(layout_surface);
 
     if (ivisurf == NULL) {
-        if (shell->bkgnd_surface_id == (int32_t)id_surface)
+        if (is_bkgnd_surface_id(shell, id_surface))
             remove_bkgnd_surface(shell, shell->bkgnd_surface);
         else
             weston_log("id_surface is not created yet\n");
@@ -1788,6 +3583,65 @@ surface_event_remove(struct wl_listener *listener, void *data)
         remove_ivi_surface(shell, ivisurf, id_surface);
 }
 
+static void
+send_surface_configure(struct ivisurface *ivisurf)
+{
+    struct notification *noti;
+
+    wl_list_for_each(noti, &ivisurf->notification_list, layout_link) {
+        dispatch_notification(noti, IVI_NOTIFICATION_CONFIGURE);
+    }
+
+    send_surface_sync_all(ivisurf, IVI_NOTIFICATION_CONFIGURE);
+}
+
+static void
+flush_pending_configure(void *data)
+{
+    struct ivishell *shell = data;
+    const struct ivi_layout_interface *lyt = shell->interface;
+    struct ivisurface *ivisurf, *next;
+    struct weston_surface *w_surface;
+    struct ivi_trace_span span;
+    uint32_t count = 0;
+
+    shell->configure_idle = NULL;
+    ivi_trace_begin(&span, shell->trace, "flush_pending_configure");
+
+    wl_list_for_each(ivisurf, &shell->pending_configure_list,
+                     pending_configure_link) {
+        w_surface = lyt->surface_get_weston_surface(ivisurf->layout_surface);
+
+        lyt->surface_set_destination_rectangle(ivisurf->layout_surface,
+                                               ivisurf->prop->dest_x,
+                                               ivisurf->prop->dest_y,
+                                               w_surface->width,
+                                               w_surface->height);
+        lyt->surface_set_source_rectangle(ivisurf->layout_surface,
+                                          0,
+                                          0,
+                                          w_surface->width,
+                                          w_surface->height);
+        count++;
+    }
+
+    /* one layout commit for all desktop surfaces resized in this cycle */
+    lyt->commit_changes();
+    wl_signal_emit(&shell->layout_committed_signal, shell);
+
+    ivi_stats_add(&shell->stats.counters[IVI_STAT_CONFIGURE_COMMITS], 1);
+    ivi_stats_add(&shell->stats.counters[IVI_STAT_CONFIGURE_SURFACES], count);
+
+    wl_list_for_each_safe(ivisurf, next, &shell->pending_configure_list,
+                          pending_configure_link) {
+        wl_list_remove(&ivisurf->pending_configure_link);
+        wl_list_init(&ivisurf->pending_configure_link);
+        send_surface_configure(ivisurf);
+    }
+
+    ivi_trace_end(&span, "\"surfaces\":%u", count);
+}
+
 static void
 surface_event_configure(struct wl_listener *listener, void *data)
 {
@@ -1796,15 +3650,15 @@ surface_event_configure(struct wl_listener *listener, void *data)
     struct ivisurface *ivisurf = NULL;
     struct ivi_layout_surface *layout_surface =
            (struct ivi_layout_surface *) data;
-    struct ivicontroller *ctrl;
-    struct notification *noti;
+    struct wl_event_loop *loop;
     uint32_t surface_id;
     struct weston_surface *w_surface;
+    struct ivi_trace_span span;
 
     w_surface = lyt->surface_get_weston_surface(layout_surface);
     surface_id = lyt->get_id_of_surface(layout_surface);
 
-    if (shell->bkgnd_surface_id == (int32_t)surface_id) {
+    if (is_bkgnd_surface_id(shell, surface_id)) {
 
         if (!shell->bkgnd_view) {
             wl_list_init(&shell->bkgnd_transform.link);
@@ -1832,31 +3686,38 @@ surface_event_configure(struct wl_listener *listener, void *data)
         return;
 
     if (ivisurf->type == IVI_WM_SURFACE_TYPE_DESKTOP) {
-        lyt->surface_set_destination_rectangle(layout_surface,
-                                               ivisurf->prop->dest_x,
-                                               ivisurf->prop->dest_y,
-                                               w_surface->width,
-                                               w_surface->height);
-        lyt->surface_set_source_rectangle(layout_surface,
-                                          0,
-                                          0,
-                                          w_surface->width,
-                                          w_surface->height);
-        lyt->commit_changes();
-    }
-    else {
-        /* Surface has attached an invaild buffer, then it attachs
-         * again with a vaild buffer. This case, allow to rebuild the view list.*/
-        if ((weston_surface_has_content(w_surface)) &&
-                !weston_surface_is_mapped(w_surface))
-            lyt->commit_current();
+        /* The rectangles are updated and committed once for all desktop
+         * surfaces configured before the event loop goes idle */
+        if (wl_list_empty(&ivisurf->pending_configure_link))
+            wl_list_insert(shell->pending_configure_list.prev,
+                           &ivisurf->pending_configure_link);
+
+        if (!shell->configure_idle) {
+            loop = wl_display_get_event_loop(shell->compositor->wl_display);
+            shell->configure_idle = wl_event_loop_add_idle(loop,
+                                        flush_pending_configure, shell);
+        }
+
+        if (shell->configure_idle)
+            return;
+
+        /* fall back to an immediate commit */
+        flush_pending_configure(shell);
+        return;
     }
 
-    wl_list_for_each(noti, &ivisurf->notification_list, layout_link) {
-        ctrl = wl_resource_get_user_data(noti->resource);
-        send_surface_event(ctrl, ivisurf->layout_surface, surface_id, ivisurf->prop,
-                           IVI_NOTIFICATION_CONFIGURE);
+    /* Surface has attached an invaild buffer, then it attachs
+     * again with a vaild buffer. This case, allow to rebuild the view list.*/
+    ivi_trace_begin(&span, shell->trace, "configure");
+    if ((weston_surface_has_content(w_surface)) &&
+            !weston_surface_is_mapped(w_surface)) {
+        lyt->commit_current();
+        wl_signal_emit(&shell->layout_committed_signal, shell);
     }
+
+    send_surface_configure(ivisurf);
+    ivi_trace_end(&span, "\"id\":%u,\"width\":%d,\"height\":%d",
+                  surface_id, w_surface->width, w_surface->height);
 }
 
 static void
@@ -1941,6 +3802,66 @@ destroy_screen_ids(struct ivishell *shell)
 	wl_array_release(&shell->screen_ids);
 }
 
+static bool
+take_debug_scope(struct ivishell *shell, const char *name)
+{
+    size_t length = strlen(name);
+    char *scope = shell->debug_scopes;
+    bool found = false;
+
+    while (scope && (scope = strstr(scope, name))) {
+        if ((scope != shell->debug_scopes && scope[-1] != ' ') ||
+            (scope[length] != ' ' && scope[length] != '\0')) {
+            scope += length;
+            continue;
+        }
+
+        memmove(scope, scope + length, strlen(scope + length) + 1);
+        found = true;
+    }
+
+    if (found && strspn(shell->debug_scopes, " ") ==
+                 strlen(shell->debug_scopes)) {
+        free(shell->debug_scopes);
+        shell->debug_scopes = NULL;
+    }
+
+    return found;
+}
+
+struct weston_log_subscriber *
+ivi_shell_subscribe_debug_scope(struct ivishell *shell, const char *scope,
+                                const char *file_key, const char *default_file,
+                                FILE **file)
+{
+    struct weston_compositor *compositor = shell->compositor;
+    struct weston_config_section *section;
+    struct weston_log_subscriber *subscriber;
+    char *path = NULL;
+
+    *file = NULL;
+    if (!take_debug_scope(shell, scope))
+        return NULL;
+
+    section = weston_config_get_section(wet_get_config(compositor),
+                                        "ivi-shell", NULL, NULL);
+    weston_config_section_get_string(section, file_key, &path, default_file);
+
+    *file = fopen(path, "w");
+    if (!*file) {
+        weston_log("ivi-controller: failed to open %s\n", path);
+        free(path);
+        return NULL;
+    }
+
+    subscriber = weston_log_subscriber_create_log(*file);
+    weston_log_subscribe(compositor->weston_log_ctx, subscriber, scope);
+    weston_log("ivi-controller: writing %s to %s\n", scope, path);
+    free(path);
+
+    return subscriber;
+}
+
 static void
 get_config(struct weston_compositor *compositor, struct ivishell *shell)
 {
@@ -1973,9 +3894,12 @@ get_config(struct weston_compositor *compositor, struct ivishell *shell)
 	                   "debug-scopes",
 	                   &shell->debug_scopes, NULL);
 
-	weston_config_section_get_color(section,
+	/* without bkgnd-surface-id, ivi-controller shows bkgnd-color */
+	if (weston_config_section_get_color(section,
                        "bkgnd-color",
-                       &shell->bkgnd_color, 0xFF000000);
+                       &shell->bkgnd_color, 0xFF000000) == 0 &&
+	    shell->bkgnd_surface_id == -1)
+		shell->bkgnd_native = true;
 
 	weston_config_section_get_bool(section,
 	                   "enable-cursor",
@@ -2043,6 +3967,9 @@ ivi_shell_destroy(struct wl_listener *listener, void *data)
 	wl_list_remove(&shell->layer_removed.link);
 	wl_list_remove(&shell->layer_created.link);
 
+	if (shell->configure_idle)
+		wl_event_source_remove(shell->configure_idle);
+
 	wl_list_for_each_safe(ivisurf, ivisurf_next,
 			      &shell->list_surface, link) {
 		wl_list_remove(&ivisurf->link);
@@ -2060,6 +3987,10 @@ ivi_shell_destroy(struct wl_listener *listener, void *data)
 		destroy_screen(iviscrn);
 	}
 
+	destroy_native_bkgnd(shell);
+	destroy_stats(shell);
+	ivi_trace_destroy(shell);
+	ivi_wm_recorder_destroy(shell);
 	destroy_screen_ids(shell);
 	free(shell);
 }
@@ -2077,6 +4008,7 @@ init_ivi_shell(struct weston_compositor *ec, struct ivishell *shell)
     wl_list_init(&shell->list_layer);
     wl_list_init(&shell->list_screen);
     wl_list_init(&shell->list_controller);
+    wl_list_init(&shell->pending_configure_list);
 
     wl_list_for_each(output, &ec->output_list, link)
         create_screen(shell, output);
@@ -2118,13 +4050,49 @@ init_ivi_shell(struct weston_compositor *ec, struct ivishell *shell)
     wl_signal_init(&shell->id_allocation_request_signal);
     wl_signal_init(&shell->ivisurface_created_signal);
     wl_signal_init(&shell->ivisurface_removed_signal);
+    wl_signal_init(&shell->layout_committed_signal);
+}
+
+static void
+print_stat(void *data, const char *name, uint64_t value)
+{
+    struct weston_log_subscription *subscription = data;
+
+    weston_log_subscription_printf(subscription, "%s %" PRIu64 "\n",
+                                   name, value);
+}
+
+/* Every subscriber of the scope gets the counters at the time it
+ * subscribed */
+static void
+stats_new_subscription(struct weston_log_subscription *subscription,
+                       void *data)
+{
+    for_each_stat(data, print_stat, subscription);
+    weston_log_subscription_complete(subscription);
+}
+
+static void
+create_stats(struct ivishell *shell)
+{
+    struct weston_compositor *compositor = shell->compositor;
+
+    shell->stats_scope = weston_compositor_add_log_scope(compositor,
+            IVI_STATS_SCOPE, "counters of ivi-controller\n",
+            stats_new_subscription, NULL, shell);
+}
+
+static void
+destroy_stats(struct ivishell *shell)
+{
+    weston_log_scope_destroy(shell->stats_scope);
 }
 
 int
 setup_ivi_controller_server(struct weston_compositor *compositor,
                             struct ivishell *shell)
 {
-    if (wl_global_create(compositor->wl_display, &ivi_wm_interface, 2,
+    if (wl_global_create(compositor->wl_display, &ivi_wm_interface, 3,
                          shell, bind_ivi_controller) == NULL) {
         return -1;
     }
@@ -2205,6 +4173,8 @@ launch_client_process(void *data)
                                    &shell->client_destroy_listener);
 
     free(shell->ivi_client_name);
+
+    startup_mark(shell, IVI_STARTUP_CLIENT_LAUNCH);
 }
 
 static int load_id_agent_module(struct ivishell *shell)
@@ -2252,6 +4222,7 @@ wet_module_init(struct weston_compositor *compositor,
         return -1;
 
     memset(shell, 0, sizeof *shell);
+    startup_mark(shell, IVI_STARTUP_MODULE_INIT);
 
     shell->interface = ivi_layout_get_api(compositor);
     if (!shell->interface) {
@@ -2261,9 +4232,11 @@ wet_module_init(struct weston_compositor *compositor,
     }
 
     get_config(compositor, shell);
+    startup_mark(shell, IVI_STARTUP_CONFIG);
 
     /* Add background layer*/
-    if (shell->bkgnd_surface_id && shell->ivi_client_name) {
+    if ((shell->bkgnd_surface_id && shell->ivi_client_name) ||
+        shell->bkgnd_native) {
         weston_layer_init(&shell->bkgnd_layer, compositor);
         weston_layer_set_position(&shell->bkgnd_layer,
                                   WESTON_LAYER_POSITION_BACKGROUND);
@@ -2271,26 +4244,54 @@ wet_module_init(struct weston_compositor *compositor,
 
     init_ivi_shell(compositor, shell);
 
+    if (ivi_wm_recorder_create(shell) < 0)
+        weston_log("ivi-controller: request recorder not available\n");
+
+    if (ivi_trace_create(shell) < 0)
+        weston_log("ivi-controller: trace not available\n");
+
+    create_stats(shell);
+    startup_mark(shell, IVI_STARTUP_SHELL);
+
     if (setup_ivi_controller_server(compositor, shell)) {
+        destroy_stats(shell);
+        ivi_trace_destroy(shell);
+        ivi_wm_recorder_destroy(shell);
         destroy_screen_ids(shell);
         free(shell);
         return -1;
     }
+    startup_mark(shell, IVI_STARTUP_SERVER);
 
     if (load_input_module(shell) < 0) {
+        destroy_stats(shell);
+        ivi_trace_destroy(shell);
+        ivi_wm_recorder_destroy(shell);
         destroy_screen_ids(shell);
         free(shell);
         return -1;
     }
+    startup_mark(shell, IVI_STARTUP_INPUT_MODULE);
+
+    if (shell->bkgnd_native && create_native_bkgnd(shell) < 0) {
+        weston_log("ivi-controller: failed to create the background\n");
+        shell->bkgnd_native = false;
+    }
 
-    if (shell->bkgnd_surface_id && shell->ivi_client_name) {
+    /* the native background leaves only the cursor to the client */
+    if (shell->bkgnd_surface_id && shell->ivi_client_name &&
+        (!shell->bkgnd_native || shell->enable_cursor)) {
         loop = wl_display_get_event_loop(compositor->wl_display);
         wl_event_loop_add_idle(loop, launch_client_process, shell);
+    } else {
+        free(shell->ivi_client_name);
+        shell->ivi_client_name = NULL;
     }
 
     if (load_id_agent_module(shell) < 0) {
         weston_log("ivi-controller: id-agent module not loaded\n");
     }
+    startup_mark(shell, IVI_STARTUP_ID_AGENT_MODULE);
 
     /* add ivi-shell destroy signal after loading input
      * modules and id-agent to ensure ivi-controller module is
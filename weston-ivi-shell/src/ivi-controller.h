@@ -23,8 +23,11 @@
 #ifndef WESTON_IVI_SHELL_SRC_IVI_CONTROLLER_H_
 #define WESTON_IVI_SHELL_SRC_IVI_CONTROLLER_H_
 
+#include <stdio.h>
+
 #include "ivi-wm-server-protocol.h"
 #include <ivi-layout-export.h>
+#include "ivi-stats.h"
 
 /* Convert timespec to milliseconds
  *
@@ -39,6 +42,13 @@ timespec_to_msec(const struct timespec *a)
 	return (int64_t)a->tv_sec * 1000 + a->tv_nsec / 1000000;
 }
 
+/* Convert timespec to microseconds, rounding down */
+static inline int64_t
+timespec_to_usec(const struct timespec *a)
+{
+	return (int64_t)a->tv_sec * 1000000 + a->tv_nsec / 1000;
+}
+
 struct ivisurface {
     struct wl_list link;
     struct ivishell *shell;
@@ -52,6 +62,21 @@ struct ivisurface {
     enum ivi_wm_surface_type type;
     uint32_t frame_count;
     struct wl_list accepted_seat_list;
+    /* bit n is set if the seat with index n of the input controller is
+     * in accepted_seat_list */
+    uint64_t accepted_seats;
+    /* keys the input controller indexes the surface with */
+    struct weston_surface *input_key_surface;
+    uint32_t input_key_id;
+    /* enum ivi_input_touch_coalescing of the surface and the count of
+     * touch motion events merged since it was set */
+    uint32_t touch_coalescing;
+    uint32_t touch_dropped;
+    struct wl_list pending_configure_link;
+
+    /* content checksum of the last commit, computed on demand */
+    bool checksum_valid;
+    uint32_t checksum;
 };
 
 struct ivishell {
@@ -67,6 +92,8 @@ struct ivishell {
     struct wl_signal ivisurface_created_signal;
     struct wl_signal ivisurface_removed_signal;
     struct wl_signal id_allocation_request_signal;
+    /* emitted after the controller committed the ivi layout */
+    struct wl_signal layout_committed_signal;
 
     struct wl_listener surface_created;
     struct wl_listener surface_removed;
@@ -84,11 +111,19 @@ struct ivishell {
 
     struct wl_listener client_destroy_listener;
 
+    /* desktop surfaces resized since the last layout commit */
+    struct wl_list pending_configure_list;
+    struct wl_event_source *configure_idle;
+
     struct wl_array screen_ids;
     uint32_t screen_id_offset;
 
     int32_t bkgnd_surface_id;
     uint32_t bkgnd_color;
+    /* bkgnd-color is shown by ivi-controller itself, as no
+     * bkgnd-surface-id is set */
+    bool bkgnd_native;
+    struct weston_buffer_reference *bkgnd_buffer;
     bool enable_cursor;
     struct ivisurface *bkgnd_surface;
     struct weston_layer bkgnd_layer;
@@ -98,6 +133,23 @@ struct ivishell {
     struct wl_client *client;
     char *ivi_client_name;
     char *debug_scopes;
+
+    struct ivi_wm_recorder *recorder;
+    struct ivi_trace *trace;
+
+    struct ivi_stats stats;
+    struct weston_log_scope *stats_scope;
 };
 
+/*
+ * Subscribes a file to the debug scope if the scope is listed in
+ * debug-scopes of [ivi-shell]. The path is read from file_key, the file is
+ * returned in file. The scope is removed from the debug scopes passed on to
+ * the ivi client, which forwards its streams line by line as text.
+ */
+struct weston_log_subscriber *
+ivi_shell_subscribe_debug_scope(struct ivishell *shell, const char *scope,
+                                const char *file_key, const char *default_file,
+                                FILE **file);
+
 #endif /* WESTON_IVI_SHELL_SRC_IVI_CONTROLLER_H_ */
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and
+ * its documentation for any purpose is hereby granted without fee, provided
+ * that the above copyright notice appear in all copies and that both that
+ * copyright notice and this permission notice appear in supporting
+ * documentation, and that the name of the copyright holders not be used in
+ * advertising or publicity pertaining to distribution of the software
+ * without specific, written prior permission.  The copyright holders make
+ * no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS
+ * SOFTWARE, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS, IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER
+ * RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+ * CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef WESTON_IVI_SHELL_SRC_IVI_STATS_H_
+#define WESTON_IVI_SHELL_SRC_IVI_STATS_H_
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <time.h>
+
+/*
+ * Counters of ivi-controller which are always updated. Every update is a
+ * relaxed atomic operation, so the block can be read at any time without
+ * locking. Counts like the number of surfaces are not kept here, they are
+ * computed when the counters are read.
+ */
+#define IVI_STATS_SCOPE "ivi-stats"
+
+/* more than the requests of ivi_wm and ivi_wm_screen */
+#define IVI_STATS_MAX_OPCODES 64
+
+enum ivi_stat {
+    /* screen events and the events of unbound controllers, the events of
+     * bound controllers are added when the counters are read */
+    IVI_STAT_EVENTS,
+    IVI_STAT_COMMITS,
+    IVI_STAT_COMMIT_TIME_US,
+    IVI_STAT_COMMIT_TIME_MAX_US,
+    IVI_STAT_SCREENSHOTS,
+    IVI_STAT_SCREENSHOT_BYTES,
+    IVI_STAT_CONFIGURE_COMMITS,
+    IVI_STAT_CONFIGURE_SURFACES,
+    IVI_STAT_COUNT
+};
+
+/* Stages of the startup, their end is kept as CLOCK_MONOTONIC microseconds.
+ * The last one is the first frame shown on any output. */
+enum ivi_startup {
+    IVI_STARTUP_MODULE_INIT,
+    IVI_STARTUP_CONFIG,
+    IVI_STARTUP_SHELL,
+    IVI_STARTUP_SERVER,
+    IVI_STARTUP_INPUT_MODULE,
+    IVI_STARTUP_ID_AGENT_MODULE,
+    IVI_STARTUP_CLIENT_LAUNCH,
+    IVI_STARTUP_FIRST_FRAME,
+    IVI_STARTUP_COUNT
+};
+
+struct ivi_stats {
+    atomic_uint_fast64_t counters[IVI_STAT_COUNT];
+    atomic_uint_fast64_t startup[IVI_STARTUP_COUNT];
+    atomic_uint_fast64_t ivi_wm_requests[IVI_STATS_MAX_OPCODES];
+    atomic_uint_fast64_t ivi_wm_screen_requests[IVI_STATS_MAX_OPCODES];
+};
+
+static inline void
+ivi_stats_add(atomic_uint_fast64_t *counter, uint64_t value)
+{
+    atomic_fetch_add_explicit(counter, value, memory_order_relaxed);
+}
+
+/* the counters are only written by the compositor thread */
+static inline void
+ivi_stats_max(atomic_uint_fast64_t *counter, uint64_t value)
+{
+    if (value > atomic_load_explicit(counter, memory_order_relaxed))
+        atomic_store_explicit(counter, value, memory_order_relaxed);
+}
+
+static inline uint64_t
+ivi_stats_mark(atomic_uint_fast64_t *counter)
+{
+    struct timespec now;
+    uint64_t usec;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    usec = (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+    atomic_store_explicit(counter, usec, memory_order_relaxed);
+
+    return usec;
+}
+
+static inline uint64_t
+ivi_stats_get(atomic_uint_fast64_t *counter)
+{
+    return atomic_load_explicit(counter, memory_order_relaxed);
+}
+
+#endif /* WESTON_IVI_SHELL_SRC_IVI_STATS_H_ */
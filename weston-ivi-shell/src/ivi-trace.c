@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and
+ * its documentation for any purpose is hereby granted without fee, provided
+ * that the above copyright notice appear in all copies and that both that
+ * copyright notice and this permission notice appear in supporting
+ * documentation, and that the name of the copyright holders not be used in
+ * advertising or publicity pertaining to distribution of the software
+ * without specific, written prior permission.  The copyright holders make
+ * no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS
+ * SOFTWARE, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS, IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER
+ * RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+ * CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/*
+ * Writes the trace events of ivi-controller, see ivi-trace.h.
+ */
+
+#include <ctype.h>
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <weston.h>
+#include "ivi-controller.h"
+#include "ivi-trace.h"
+
+static bool
+is_traced_interface(const char *name)
+{
+    return strcmp(name, "ivi_wm") == 0 ||
+           strcmp(name, "ivi_wm_screen") == 0 ||
+           strcmp(name, "ivi_input") == 0;
+}
+
+/* Requests are instant events, with the pid of the client and the first
+ * unsigned argument, which is the surface, layer or screen id of most */
+static void
+trace_log(void *user_data, enum wl_protocol_logger_type type,
+          const struct wl_protocol_logger_message *message)
+{
+    struct ivi_trace *trace = user_data;
+    const char *interface;
+    const char *signature;
+    pid_t pid = 0;
+    int i = 0;
+
+    if (type != WL_PROTOCOL_LOGGER_REQUEST ||
+        !weston_log_scope_is_enabled(trace->scope))
+        return;
+
+    interface = wl_resource_get_class(message->resource);
+    if (!is_traced_interface(interface))
+        return;
+
+    wl_client_get_credentials(wl_resource_get_client(message->resource),
+                              &pid, NULL, NULL);
+
+    for (signature = message->message->signature; *signature; signature++) {
+        if (isdigit((unsigned char)*signature) || *signature == '?')
+            continue;
+
+        if (*signature == 'u')
+            break;
+
+        i++;
+    }
+
+    if (*signature == 'u' && i < message->arguments_count)
+        weston_log_scope_printf(trace->scope,
+                "{\"name\":\"%s.%s\",\"cat\":\"request\",\"ph\":\"i\","
+                "\"s\":\"t\",\"ts\":%" PRIu64 ",\"pid\":%d,\"tid\":%d,"
+                "\"args\":{\"client_pid\":%d,\"arg\":%u}},\n",
+                interface, message->message->name, ivi_trace_now_usec(),
+                getpid(), getpid(), pid, message->arguments[i].u);
+    else
+        weston_log_scope_printf(trace->scope,
+                "{\"name\":\"%s.%s\",\"cat\":\"request\",\"ph\":\"i\","
+                "\"s\":\"t\",\"ts\":%" PRIu64 ",\"pid\":%d,\"tid\":%d,"
+                "\"args\":{\"client_pid\":%d}},\n",
+                interface, message->message->name, ivi_trace_now_usec(),
+                getpid(), getpid(), pid);
+}
+
+/* libwayland formats a message for every request of every client while a
+ * protocol logger is installed, so it is only there while the scope has
+ * subscribers */
+static void
+trace_new_subscription(struct weston_log_subscription *subscription,
+                       void *data)
+{
+    struct ivi_trace *trace = data;
+
+    if (trace->subscriptions++ == 0)
+        trace->logger = wl_display_add_protocol_logger(trace->display,
+                                                       trace_log, trace);
+
+    weston_log_subscription_printf(subscription,
+            "[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,"
+            "\"args\":{\"name\":\"weston\"}},\n", getpid());
+}
+
+static void
+trace_destroy_subscription(struct weston_log_subscription *subscription,
+                           void *data)
+{
+    struct ivi_trace *trace = data;
+    (void)subscription;
+
+    if (trace->subscriptions > 0 && --trace->subscriptions == 0 &&
+        trace->logger) {
+        wl_protocol_logger_destroy(trace->logger);
+        trace->logger = NULL;
+    }
+}
+
+void
+ivi_trace_write_span(const struct ivi_trace_span *span,
+                     const char *args_format, ...)
+{
+    uint64_t end_usec = ivi_trace_now_usec();
+    char args[256];
+    va_list ap;
+
+    va_start(ap, args_format);
+    vsnprintf(args, sizeof args, args_format, ap);
+    va_end(ap);
+
+    weston_log_scope_printf(span->scope,
+            "{\"name\":\"%s\",\"cat\":\"ivi-controller\",\"ph\":\"X\","
+            "\"ts\":%" PRIu64 ",\"dur\":%" PRIu64 ",\"pid\":%d,\"tid\":%d,"
+            "\"args\":{%s}},\n",
+            span->name, span->start_usec, end_usec - span->start_usec,
+            getpid(), getpid(), args);
+}
+
+int
+ivi_trace_create(struct ivishell *shell)
+{
+    struct weston_compositor *compositor = shell->compositor;
+    struct ivi_trace *trace;
+
+    trace = calloc(1, sizeof *trace);
+    if (!trace)
+        return -1;
+
+    trace->display = compositor->wl_display;
+    trace->scope = weston_compositor_add_log_scope(compositor,
+            IVI_TRACE_SCOPE,
+            "ivi-controller activity in the Chrome trace event format\n",
+            trace_new_subscription, trace_destroy_subscription, trace);
+    if (!trace->scope) {
+        free(trace);
+        return -1;
+    }
+
+    /* debug-scopes=ivi-trace writes the trace to trace-file */
+    trace->file_subscriber = ivi_shell_subscribe_debug_scope(shell,
+            IVI_TRACE_SCOPE, "trace-file", "/tmp/ivi-trace.json",
+            &trace->file);
+
+    shell->trace = trace;
+    return 0;
+}
+
+void
+ivi_trace_destroy(struct ivishell *shell)
+{
+    struct ivi_trace *trace = shell->trace;
+
+    if (!trace)
+        return;
+
+    if (trace->file_subscriber)
+        weston_log_subscriber_destroy(trace->file_subscriber);
+
+    if (trace->file)
+        fclose(trace->file);
+
+    /* removes the protocol logger with the last subscription */
+    weston_log_scope_destroy(trace->scope);
+    if (trace->logger)
+        wl_protocol_logger_destroy(trace->logger);
+
+    free(trace);
+    shell->trace = NULL;
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and
+ * its documentation for any purpose is hereby granted without fee, provided
+ * that the above copyright notice appear in all copies and that both that
+ * copyright notice and this permission notice appear in supporting
+ * documentation, and that the name of the copyright holders not be used in
+ * advertising or publicity pertaining to distribution of the software
+ * without specific, written prior permission.  The copyright holders make
+ * no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS
+ * SOFTWARE, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS, IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER
+ * RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+ * CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef WESTON_IVI_SHELL_SRC_IVI_TRACE_H_
+#define WESTON_IVI_SHELL_SRC_IVI_TRACE_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#include <libweston/weston-log.h>
+
+/*
+ * Trace events of ivi-controller in the Chrome trace event format, written
+ * to the subscribers of the "ivi-trace" debug scope. The stream is a JSON
+ * array with one event per line, which is not closed, as the trace viewers
+ * accept this. Timestamps are CLOCK_MONOTONIC in microseconds, like those
+ * of the clients tracing with the same clock.
+ *
+ * Every request to ivi_wm, ivi_wm_screen and ivi_input is an instant event,
+ * spans measure the work done for them.
+ */
+#define IVI_TRACE_SCOPE "ivi-trace"
+
+struct ivishell;
+struct wl_display;
+struct wl_protocol_logger;
+
+struct ivi_trace {
+    struct weston_log_scope *scope;
+    struct wl_display *display;
+
+    /* only installed while the scope has subscribers */
+    struct wl_protocol_logger *logger;
+    unsigned int subscriptions;
+
+    /* subscriber of the scope, if it is listed in debug-scopes */
+    struct weston_log_subscriber *file_subscriber;
+    FILE *file;
+};
+
+struct ivi_trace_span {
+    /* NULL if the scope had no subscribers when the span began */
+    struct weston_log_scope *scope;
+    const char *name;
+    uint64_t start_usec;
+};
+
+int
+ivi_trace_create(struct ivishell *shell);
+
+void
+ivi_trace_destroy(struct ivishell *shell);
+
+void
+ivi_trace_write_span(const struct ivi_trace_span *span,
+                     const char *args_format, ...)
+        __attribute__((format(printf, 2, 3)));
+
+static inline uint64_t
+ivi_trace_now_usec(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+/* Costs one check of the scope while nobody subscribed to it */
+static inline void
+ivi_trace_begin(struct ivi_trace_span *span, const struct ivi_trace *trace,
+                const char *name)
+{
+    span->scope = NULL;
+    if (!trace || !weston_log_scope_is_enabled(trace->scope))
+        return;
+
+    span->scope = trace->scope;
+    span->name = name;
+    span->start_usec = ivi_trace_now_usec();
+}
+
+/* Ends the span, the arguments are formatted to the members of a JSON
+ * object, e.g. "\"id\":%u" */
+#define ivi_trace_end(span, ...)                        \
+    do {                                                \
+        if ((span)->scope)                              \
+            ivi_trace_write_span((span), __VA_ARGS__);  \
+    } while (0)
+
+#endif /* WESTON_IVI_SHELL_SRC_IVI_TRACE_H_ */
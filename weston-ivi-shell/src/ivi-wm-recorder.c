@@ -0,0 +1,408 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and
+ * its documentation for any purpose is hereby granted without fee, provided
+ * that the above copyright notice appear in all copies and that both that
+ * copyright notice and this permission notice appear in supporting
+ * documentation, and that the name of the copyright holders not be used in
+ * advertising or publicity pertaining to distribution of the software
+ * without specific, written prior permission.  The copyright holders make
+ * no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS
+ * SOFTWARE, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS, IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER
+ * RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+ * CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/*
+ * Records the ivi_wm and ivi_input requests of all clients through a
+ * protocol logger of the display, see ivi-wm-recorder.h for the format.
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <weston.h>
+#include "ivi-controller.h"
+#include "ivi-wm-recorder.h"
+
+struct recorder_client {
+    struct wl_list link;
+    struct wl_client *client;
+    uint32_t index;
+    struct wl_listener destroy_listener;
+};
+
+struct ivi_wm_recorder {
+    struct ivishell *shell;
+    struct weston_log_scope *scope;
+    struct wl_display *display;
+
+    /* only installed while the scope has subscribers */
+    struct wl_protocol_logger *logger;
+    unsigned int subscriptions;
+
+    /* subscriber of the scope, if it is listed in debug-scopes */
+    struct weston_log_subscriber *file_subscriber;
+    FILE *file;
+
+    struct wl_list client_list;
+    uint32_t next_client;
+
+    struct wl_listener surface_created_listener;
+    struct wl_listener surface_removed_listener;
+    /* records the existing surfaces for a new subscription */
+    struct wl_event_source *snapshot_idle;
+
+    /* the record being written */
+    struct wl_array buffer;
+};
+
+static int
+recorder_interface(const char *name)
+{
+    if (strcmp(name, "ivi_wm") == 0)
+        return IVI_WM_RECORD_IVI_WM;
+    if (strcmp(name, "ivi_wm_screen") == 0)
+        return IVI_WM_RECORD_IVI_WM_SCREEN;
+    if (strcmp(name, "ivi_input") == 0)
+        return IVI_WM_RECORD_IVI_INPUT;
+
+    return -1;
+}
+
+static void
+recorder_client_destroy(struct wl_listener *listener, void *data)
+{
+    struct recorder_client *rec_client =
+            wl_container_of(listener, rec_client, destroy_listener);
+    (void)data;
+
+    wl_list_remove(&rec_client->destroy_listener.link);
+    wl_list_remove(&rec_client->link);
+    free(rec_client);
+}
+
+static uint32_t
+recorder_client_index(struct ivi_wm_recorder *recorder,
+                      struct wl_client *client)
+{
+    struct recorder_client *rec_client;
+
+    wl_list_for_each(rec_client, &recorder->client_list, link) {
+        if (rec_client->client == client)
+            return rec_client->index;
+    }
+
+    rec_client = calloc(1, sizeof *rec_client);
+    if (!rec_client)
+        return recorder->next_client++;
+
+    rec_client->client = client;
+    rec_client->index = recorder->next_client++;
+    rec_client->destroy_listener.notify = recorder_client_destroy;
+    wl_client_add_destroy_listener(client, &rec_client->destroy_listener);
+    wl_list_insert(&recorder->client_list, &rec_client->link);
+
+    return rec_client->index;
+}
+
+static bool
+recorder_add(struct wl_array *buffer, const void *data, size_t size)
+{
+    static const uint8_t padding[4];
+    size_t padded = (size + 3) & ~(size_t)3;
+    uint8_t *dst = wl_array_add(buffer, padded);
+
+    if (!dst)
+        return false;
+
+    memcpy(dst, data, size);
+    memcpy(dst + size, padding, padded - size);
+    return true;
+}
+
+static bool
+recorder_add_uint(struct wl_array *buffer, uint32_t value)
+{
+    return recorder_add(buffer, &value, sizeof value);
+}
+
+static bool
+recorder_add_data(struct wl_array *buffer, const void *data, uint32_t size)
+{
+    if (!data)
+        return recorder_add_uint(buffer, IVI_WM_RECORDER_NULL);
+
+    return recorder_add_uint(buffer, size) && recorder_add(buffer, data, size);
+}
+
+/* Writes the record in the buffer, after the space left for its header */
+static void
+recorder_write(struct ivi_wm_recorder *recorder, uint32_t client,
+               uint32_t object, uint16_t interface, uint16_t opcode)
+{
+    struct wl_array *buffer = &recorder->buffer;
+    struct ivi_wm_record record;
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    record.time_usec = (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+    record.client = client;
+    record.object = object;
+    record.interface = interface;
+    record.opcode = opcode;
+    record.size = buffer->size - sizeof record;
+    memcpy(buffer->data, &record, sizeof record);
+
+    weston_log_scope_write(recorder->scope, buffer->data, buffer->size);
+}
+
+static void
+recorder_log(void *user_data, enum wl_protocol_logger_type type,
+             const struct wl_protocol_logger_message *message)
+{
+    struct ivi_wm_recorder *recorder = user_data;
+    struct wl_array *buffer = &recorder->buffer;
+    const union wl_argument *arg = message->arguments;
+    const char *signature;
+    bool ok = true;
+    int interface;
+
+    if (type != WL_PROTOCOL_LOGGER_REQUEST ||
+        !weston_log_scope_is_enabled(recorder->scope))
+        return;
+
+    interface = recorder_interface(wl_resource_get_class(message->resource));
+    if (interface < 0)
+        return;
+
+    buffer->size = 0;
+    if (!wl_array_add(buffer, sizeof(struct ivi_wm_record)))
+        return;
+
+    for (signature = message->message->signature; *signature && ok;
+         signature++) {
+        if (isdigit((unsigned char)*signature) || *signature == '?')
+            continue;
+
+        switch (*signature) {
+        case 'i':
+        case 'u':
+        case 'f':
+        case 'n':
+            ok = recorder_add_uint(buffer, arg->u);
+            break;
+        case 'h':
+            ok = recorder_add_uint(buffer, (uint32_t)-1);
+            break;
+        case 'o':
+            ok = recorder_add_uint(buffer, arg->o ?
+                    wl_resource_get_id((struct wl_resource *)arg->o) : 0);
+            break;
+        case 's':
+            ok = recorder_add_data(buffer, arg->s,
+                                   arg->s ? strlen(arg->s) + 1 : 0);
+            break;
+        case 'a':
+            ok = recorder_add_data(buffer, arg->a ? arg->a->data : NULL,
+                                   arg->a ? arg->a->size : 0);
+            break;
+        }
+
+        arg++;
+    }
+
+    if (!ok)
+        return;
+
+    recorder_write(recorder,
+                   recorder_client_index(recorder,
+                           wl_resource_get_client(message->resource)),
+                   wl_resource_get_id(message->resource), interface,
+                   message->message_opcode);
+}
+
+static void
+record_surface(struct ivi_wm_recorder *recorder, struct ivisurface *ivisurf,
+               uint16_t opcode)
+{
+    const struct ivi_layout_interface *lyt = recorder->shell->interface;
+    struct wl_array *buffer = &recorder->buffer;
+    struct weston_surface *surface;
+
+    if (!weston_log_scope_is_enabled(recorder->scope))
+        return;
+
+    buffer->size = 0;
+    if (!wl_array_add(buffer, sizeof(struct ivi_wm_record)))
+        return;
+
+    if (opcode == IVI_WM_RECORD_SURFACE_CREATED) {
+        surface = lyt->surface_get_weston_surface(ivisurf->layout_surface);
+        if (!recorder_add_uint(buffer, surface ? surface->width : 0) ||
+            !recorder_add_uint(buffer, surface ? surface->height : 0))
+            return;
+    }
+
+    recorder_write(recorder, IVI_WM_RECORD_NO_CLIENT,
+                   lyt->get_id_of_surface(ivisurf->layout_surface),
+                   IVI_WM_RECORD_SURFACE, opcode);
+}
+
+static void
+recorder_surface_created(struct wl_listener *listener, void *data)
+{
+    struct ivi_wm_recorder *recorder =
+            wl_container_of(listener, recorder, surface_created_listener);
+
+    record_surface(recorder, data, IVI_WM_RECORD_SURFACE_CREATED);
+}
+
+static void
+recorder_surface_removed(struct wl_listener *listener, void *data)
+{
+    struct ivi_wm_recorder *recorder =
+            wl_container_of(listener, recorder, surface_removed_listener);
+
+    record_surface(recorder, data, IVI_WM_RECORD_SURFACE_REMOVED);
+}
+
+/* Older subscriptions get the surfaces again, a replay ignores surfaces
+ * which it created already */
+static void
+recorder_snapshot(void *data)
+{
+    struct ivi_wm_recorder *recorder = data;
+    struct ivisurface *ivisurf;
+
+    recorder->snapshot_idle = NULL;
+
+    wl_list_for_each(ivisurf, &recorder->shell->list_surface, link) {
+        if (ivisurf != recorder->shell->bkgnd_surface)
+            record_surface(recorder, ivisurf, IVI_WM_RECORD_SURFACE_CREATED);
+    }
+}
+
+/* libwayland formats a message for every request of every client while a
+ * protocol logger is installed, so it is only there while the scope has
+ * subscribers */
+static void
+recorder_new_subscription(struct weston_log_subscription *subscription,
+                          void *data)
+{
+    struct ivi_wm_recorder *recorder = data;
+    struct wl_event_loop *loop = wl_display_get_event_loop(recorder->display);
+
+    if (recorder->subscriptions++ == 0)
+        recorder->logger = wl_display_add_protocol_logger(recorder->display,
+                                                          recorder_log,
+                                                          recorder);
+
+    weston_log_subscription_printf(subscription, "%s", IVI_WM_RECORDER_MAGIC);
+
+    if (!recorder->snapshot_idle)
+        recorder->snapshot_idle = wl_event_loop_add_idle(loop,
+                recorder_snapshot, recorder);
+}
+
+static void
+recorder_destroy_subscription(struct weston_log_subscription *subscription,
+                              void *data)
+{
+    struct ivi_wm_recorder *recorder = data;
+    (void)subscription;
+
+    if (recorder->subscriptions > 0 && --recorder->subscriptions == 0 &&
+        recorder->logger) {
+        wl_protocol_logger_destroy(recorder->logger);
+        recorder->logger = NULL;
+    }
+}
+
+int
+ivi_wm_recorder_create(struct ivishell *shell)
+{
+    struct weston_compositor *compositor = shell->compositor;
+    struct ivi_wm_recorder *recorder;
+
+    recorder = calloc(1, sizeof *recorder);
+    if (!recorder)
+        return -1;
+
+    wl_list_init(&recorder->client_list);
+    wl_array_init(&recorder->buffer);
+
+    recorder->shell = shell;
+    recorder->display = compositor->wl_display;
+    recorder->scope = weston_compositor_add_log_scope(compositor,
+            IVI_WM_RECORDER_SCOPE,
+            "binary trace of the ivi_wm and ivi_input requests\n",
+            recorder_new_subscription, recorder_destroy_subscription,
+            recorder);
+    if (!recorder->scope) {
+        free(recorder);
+        return -1;
+    }
+
+    recorder->surface_created_listener.notify = recorder_surface_created;
+    wl_signal_add(&shell->ivisurface_created_signal,
+                  &recorder->surface_created_listener);
+    recorder->surface_removed_listener.notify = recorder_surface_removed;
+    wl_signal_add(&shell->ivisurface_removed_signal,
+                  &recorder->surface_removed_listener);
+
+    /* debug-scopes=ivi-wm-recorder records into recorder-file */
+    recorder->file_subscriber = ivi_shell_subscribe_debug_scope(shell,
+            IVI_WM_RECORDER_SCOPE, "recorder-file",
+            "/tmp/ivi-wm-recorder.trace", &recorder->file);
+
+    shell->recorder = recorder;
+    return 0;
+}
+
+void
+ivi_wm_recorder_destroy(struct ivishell *shell)
+{
+    struct ivi_wm_recorder *recorder = shell->recorder;
+    struct recorder_client *rec_client, *next;
+
+    if (!recorder)
+        return;
+
+    wl_list_remove(&recorder->surface_created_listener.link);
+    wl_list_remove(&recorder->surface_removed_listener.link);
+
+    if (recorder->file_subscriber)
+        weston_log_subscriber_destroy(recorder->file_subscriber);
+
+    if (recorder->file)
+        fclose(recorder->file);
+
+    /* removes the protocol logger with the last subscription */
+    weston_log_scope_destroy(recorder->scope);
+    if (recorder->logger)
+        wl_protocol_logger_destroy(recorder->logger);
+
+    if (recorder->snapshot_idle)
+        wl_event_source_remove(recorder->snapshot_idle);
+
+    wl_list_for_each_safe(rec_client, next, &recorder->client_list, link) {
+        wl_list_remove(&rec_client->destroy_listener.link);
+        wl_list_remove(&rec_client->link);
+        free(rec_client);
+    }
+
+    wl_array_release(&recorder->buffer);
+    free(recorder);
+    shell->recorder = NULL;
+}
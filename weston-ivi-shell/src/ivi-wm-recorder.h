@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and
+ * its documentation for any purpose is hereby granted without fee, provided
+ * that the above copyright notice appear in all copies and that both that
+ * copyright notice and this permission notice appear in supporting
+ * documentation, and that the name of the copyright holders not be used in
+ * advertising or publicity pertaining to distribution of the software
+ * without specific, written prior permission.  The copyright holders make
+ * no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS
+ * SOFTWARE, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS, IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER
+ * RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF
+ * CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef WESTON_IVI_SHELL_SRC_IVI_WM_RECORDER_H_
+#define WESTON_IVI_SHELL_SRC_IVI_WM_RECORDER_H_
+
+#include <stdint.h>
+
+/*
+ * Trace of the ivi_wm, ivi_wm_screen and ivi_input requests of all clients,
+ * written to the subscribers of the "ivi-wm-recorder" debug scope.
+ *
+ * A trace starts with IVI_WM_RECORDER_MAGIC, followed by records in host
+ * byte order. Every record is a struct ivi_wm_record, followed by size bytes
+ * of the request arguments in the order of the signature:
+ *  - i, u, f, o, n and h as 32 bit values, o as the object id or 0 and h as -1
+ *  - s and a as a 32 bit length followed by the data padded to 32 bit, a
+ *    string including its terminating NUL. NULL has the length 0xffffffff.
+ *
+ * The surfaces of the applications are IVI_WM_RECORD_SURFACE records, so
+ * that a replay can create stand-ins for them. Their client is
+ * IVI_WM_RECORD_NO_CLIENT and their object the ivi id of the surface. The
+ * opcode IVI_WM_RECORD_SURFACE_CREATED has the width and height of the
+ * surface as arguments, IVI_WM_RECORD_SURFACE_REMOVED has none. The
+ * surfaces which exist when a subscription starts are recorded as created
+ * right after it.
+ */
+#define IVI_WM_RECORDER_SCOPE "ivi-wm-recorder"
+#define IVI_WM_RECORDER_MAGIC "IVIWMREC0001"
+#define IVI_WM_RECORDER_MAGIC_SIZE 12
+#define IVI_WM_RECORDER_NULL 0xffffffff
+
+enum ivi_wm_record_interface {
+    IVI_WM_RECORD_IVI_WM = 0,
+    IVI_WM_RECORD_IVI_WM_SCREEN = 1,
+    IVI_WM_RECORD_IVI_INPUT = 2,
+    IVI_WM_RECORD_SURFACE = 3,
+};
+
+enum ivi_wm_record_surface_opcode {
+    IVI_WM_RECORD_SURFACE_CREATED = 0,
+    IVI_WM_RECORD_SURFACE_REMOVED = 1,
+};
+
+#define IVI_WM_RECORD_NO_CLIENT 0xffffffff
+
+struct ivi_wm_record {
+    uint64_t time_usec;     /* CLOCK_MONOTONIC */
+    uint32_t client;        /* index of the client in the trace */
+    uint32_t object;        /* object id of the request */
+    uint16_t interface;     /* enum ivi_wm_record_interface */
+    uint16_t opcode;
+    uint32_t size;          /* size of the arguments */
+};
+
+struct ivishell;
+
+int
+ivi_wm_recorder_create(struct ivishell *shell);
+
+void
+ivi_wm_recorder_destroy(struct ivishell *shell);
+
+#endif /* WESTON_IVI_SHELL_SRC_IVI_WM_RECORDER_H_ */